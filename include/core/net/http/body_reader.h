@@ -0,0 +1,122 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_BODY_READER_H_
+#define CORE_NET_HTTP_BODY_READER_H_
+
+#include <core/net/visibility.h>
+
+#include <core/net/http/error.h>
+#include <core/net/http/response.h>
+
+#include <cstddef>
+#include <iosfwd>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+/**
+ * @brief The BodyReader class hands out the body of an executing request to a consumer pulling it in.
+ *
+ * The body is buffered up to a bounded capacity as it arrives from the network. The
+ * transfer pauses while the buffer is full and resumes as the consumer reads, keeping
+ * memory constant however large the body. A reader is meant to be used from a single
+ * thread at a time, which must not be the thread running the client.
+ */
+class CORE_NET_DLL_PUBLIC BodyReader
+{
+public:
+    /**
+     * @brief The Errors struct collects the BodyReader-specific exceptions.
+     */
+    struct Errors
+    {
+        Errors() = delete;
+
+        /**
+         * @brief Closed is thrown when reading from a reader that has been closed.
+         */
+        struct Closed : public core::net::http::Error
+        {
+            /**
+             * @brief Closed creates a new instance with a location hint.
+             * @param loc The location that the call originates from.
+             */
+            Closed(const core::Location& loc);
+        };
+    };
+
+    /** Returned by a non-blocking reader if no data has arrived yet. */
+    static constexpr const std::size_t would_block = static_cast<std::size_t>(-1);
+
+    /** @brief Configuration of a body reader. */
+    struct Configuration
+    {
+        /** Upper bound on the number of bytes buffered. */
+        std::size_t capacity{1024 * 1024};
+        /** Wait for data to arrive when reading, instead of returning would_block. */
+        bool blocking{true};
+    };
+
+    BodyReader(const BodyReader&) = delete;
+    virtual ~BodyReader() = default;
+
+    BodyReader& operator=(const BodyReader&) = delete;
+    bool operator==(const BodyReader&) const = delete;
+
+    /**
+     * @brief Reads up to size bytes of the body.
+     * @throw Errors::Closed if the reader has been closed.
+     * @throw core::net::Error if the transfer failed, once the data received before has been read.
+     * @param data The buffer to read to.
+     * @param size The size of the buffer.
+     * @return The number of bytes read, 0 at the end of the body, or would_block if
+     * the reader is non-blocking and no data has arrived yet.
+     */
+    virtual std::size_t read(char* data, std::size_t size) = 0;
+
+    /**
+     * @brief Adapts the reader to a stream, which always waits for data to arrive.
+     *
+     * A failing transfer sets the badbit of the stream, rethrowing the error
+     * if the exception mask of the stream asks for it.
+     *
+     * @return The stream reading the body.
+     */
+    virtual std::istream& stream() = 0;
+
+    /**
+     * @brief Waits for the transfer to complete, which requires the body to have been read or the reader to be closed.
+     * @throw core::net::Error if the transfer failed.
+     * @return The response, without its body.
+     */
+    virtual Response response() = 0;
+
+    /**
+     * @brief Discards the rest of the body, aborting the transfer if it has not completed yet.
+     */
+    virtual void close() = 0;
+
+protected:
+    BodyReader() = default;
+};
+}
+}
+}
+
+#endif // CORE_NET_HTTP_BODY_READER_H_
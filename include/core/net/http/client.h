@@ -25,8 +25,13 @@
 #include <core/net/http/request.h>
 
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <iosfwd>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace core
 {
@@ -56,6 +61,393 @@ public:
             HttpMethodNotSupported(Method method, const core::Location&);
             Method method;
         };
+
+        /** @brief CircuitOpen is thrown (or handed to the error handler) if a request
+         * is issued against a host whose circuit breaker is currently open.
+         */
+        struct CircuitOpen : public http::Error
+        {
+            CircuitOpen(const std::string& host, const core::Location&);
+            std::string host;
+        };
+    };
+
+    /** @brief Summarizes the types describing the per-host circuit breaker. */
+    struct CircuitBreaker
+    {
+        CircuitBreaker() = delete;
+
+        /** @brief The states a per-host circuit can be in. */
+        enum class State
+        {
+            closed, ///< Requests flow normally, outcomes are tracked.
+            open, ///< Requests fail immediately without touching the network.
+            half_open ///< A limited number of probe requests is admitted.
+        };
+
+        /** @brief Invoked whenever the circuit of a host changes its state. */
+        typedef std::function<void(const std::string& host, State from, State to)> StateChangeHandler;
+
+        /** @brief Options for creating circuit breakers. */
+        struct Configuration
+        {
+            /** Circuit breaking is opt-in. */
+            bool enabled{false};
+            /** The circuit opens after this many failures in a row. */
+            std::uint32_t consecutive_failures{5};
+            /** The circuit opens if the ratio of failures in the window exceeds this value. */
+            double error_rate{0.5};
+            /** Minimum number of requests in the window before error_rate is considered. */
+            std::uint32_t minimum_requests{20};
+            /** Length of the sliding window that the error rate is measured over. */
+            std::chrono::milliseconds window{std::chrono::seconds{10}};
+            /** Time an open circuit waits before admitting probe requests. */
+            std::chrono::milliseconds open_interval{std::chrono::seconds{5}};
+            /** Number of concurrent probes admitted in half-open state. The same
+             * number of successful probes closes the circuit again. */
+            std::uint32_t half_open_probes{1};
+            /** Invoked for state changes, on the thread reporting the triggering outcome. */
+            StateChangeHandler on_state_change;
+        };
+    };
+
+    /** @brief Summarizes the types describing the adaptive per-host concurrency limit. */
+    struct ConcurrencyLimit
+    {
+        ConcurrencyLimit() = delete;
+
+        /**
+         * @brief Options for the adaptive concurrency limit.
+         *
+         * The limit grows additively while requests against a host saturate it and
+         * latencies stay close to the observed baseline. It shrinks multiplicatively
+         * when latency rises above the tolerated level or requests fail.
+         */
+        struct Configuration
+        {
+            /** Concurrency limiting is opt-in. */
+            bool enabled{false};
+            /** Number of requests in flight admitted initially. */
+            std::uint32_t initial_limit{8};
+            /** The limit never drops below this value. */
+            std::uint32_t min_limit{1};
+            /** The limit never grows beyond this value. */
+            std::uint32_t max_limit{256};
+            /** Factor applied to the limit whenever latency rises or a request fails. */
+            double backoff_ratio{0.9};
+            /** Latencies up to this multiple of the baseline latency are considered flat. */
+            double latency_tolerance{2.0};
+            /** Number of samples after which the baseline latency is re-measured. */
+            std::uint32_t baseline_window{100};
+        };
+    };
+
+    /** @brief Summarizes the types describing client-side load balancing across endpoint groups. */
+    struct LoadBalancing
+    {
+        LoadBalancing() = delete;
+
+        /** @brief The ways an endpoint of a group is selected for an individual request. */
+        enum class Policy
+        {
+            round_robin, ///< Cycle through the endpoints in order.
+            least_outstanding, ///< Pick the endpoint with the fewest requests in flight.
+            power_of_two_choices, ///< Pick the less loaded of two random endpoints.
+            ewma_latency, ///< Pick the faster of two random endpoints, weighting the moving average latency by load.
+            consistent_hash ///< Map the request's affinity key onto the endpoints, requests without a key use power_of_two_choices.
+        };
+
+        /**
+         * @brief Options for passively ejecting misbehaving endpoints from a group.
+         *
+         * An ejected endpoint does not receive requests until its ejection time has
+         * passed. The ejection time grows with the number of times an endpoint has
+         * been ejected before.
+         */
+        struct OutlierEjection
+        {
+            /** Outlier ejection is opt-in. */
+            bool enabled{false};
+            /** An endpoint is ejected after this many failures in a row. */
+            std::uint32_t consecutive_failures{5};
+            /** Time an endpoint stays ejected the first time around. */
+            std::chrono::milliseconds base_ejection_time{std::chrono::seconds{30}};
+            /** Upper bound for the time an endpoint stays ejected. */
+            std::chrono::milliseconds max_ejection_time{std::chrono::minutes{5}};
+            /** At most this fraction of the endpoints of a group is ejected at any time, but at least one. */
+            double max_ejection_ratio{0.5};
+        };
+
+        /** @brief A set of interchangeable base URIs serving the same logical service. */
+        struct EndpointGroup
+        {
+            /** The base URIs of the replicas, e.g. "http://10.0.0.1:8080". */
+            std::vector<std::string> endpoints;
+            /** How an endpoint is selected for an individual request. */
+            Policy policy{Policy::round_robin};
+            /** Time constant of the exponentially weighted moving average of endpoint latencies. */
+            std::chrono::milliseconds ewma_decay{std::chrono::seconds{10}};
+            /**
+             * With consistent_hash, an endpoint takes at most this multiple of the average number
+             * of outstanding requests per endpoint. Keys spill over to the next endpoint beyond that.
+             */
+            double load_factor{1.25};
+            /** Passive outlier ejection based on failed requests. */
+            OutlierEjection outlier_ejection;
+        };
+    };
+
+    /** @brief Summarizes the types describing the coalescing of identical requests in flight. */
+    struct Coalescing
+    {
+        Coalescing() = delete;
+
+        /**
+         * @brief Computes the key identifying identical GET and HEAD requests.
+         *
+         * Requests with equal keys share a single transfer while one of them is in flight.
+         * Returning an empty key opts the request out of coalescing.
+         */
+        typedef std::function<std::string(Method method, const Request::Configuration& configuration)> KeyFunction;
+
+        /**
+         * @brief Options for coalescing identical requests.
+         *
+         * A request joining a transfer in flight does not see progress updates. Its data
+         * handler is invoked once with the complete body when the shared transfer finishes.
+         */
+        struct Configuration
+        {
+            /** Coalescing is opt-in. */
+            bool enabled{false};
+            /** Header fields that tell apart otherwise identical requests with the default key. */
+            std::vector<std::string> key_headers{"Accept", "Accept-Encoding", "Accept-Language", "Authorization", "Cookie"};
+            /**
+             * Replaces the default key, which covers method, uri, ssl options and key_headers.
+             * Requests with an http authentication handler are never coalesced by the default key.
+             * Requests carrying Range or If-Range are never coalesced, and requests decoding
+             * their bodies never share a transfer with requests that do not.
+             */
+            KeyFunction key;
+        };
+    };
+
+    /** @brief Summarizes the types describing the client-side response cache. */
+    struct Cache
+    {
+        Cache() = delete;
+
+        /**
+         * @brief Options for caching responses to GET requests.
+         *
+         * The cache acts as a private cache in the sense of RFC 7234. It honors
+         * Cache-Control, Expires and Vary, and revalidates stale responses with
+         * If-None-Match and If-Modified-Since. Fresh responses are served without
+         * issuing a request. Decoded responses are cached apart from responses
+         * that are not decoded, see Request::Configuration::decoding.
+         */
+        struct Configuration
+        {
+            /** Caching is opt-in. */
+            bool enabled{false};
+            /** Upper bound for the accumulated size of all cached responses in bytes. */
+            std::uint64_t max_size{64 * 1024 * 1024};
+            /** Responses larger than this are not cached. */
+            std::uint64_t max_entry_size{8 * 1024 * 1024};
+            /** Upper bound for freshness lifetimes derived heuristically from Last-Modified. */
+            std::chrono::seconds max_heuristic_freshness{std::chrono::hours{24}};
+            /**
+             * If not empty, responses are kept in files below this directory
+             * and survive the client. Clients in the same or in different
+             * processes can share a directory. Otherwise, responses are kept
+             * in memory.
+             */
+            std::string directory;
+            /**
+             * Fraction of the freshness lifetime of a cached response, from 0 to 1.
+             * Once less than this fraction of its lifetime remains, a response
+             * requested at least refresh_ahead_min_hits times is served from
+             * the cache and revalidated in the background, such that callers
+             * do not run into its expiry. 0 disables refreshing ahead.
+             *
+             * Independent of this, responses carrying a stale-while-revalidate
+             * directive are served stale within the permitted window and
+             * revalidated in the background (RFC 5861).
+             *
+             * Background revalidations are carried out by the reactor, i.e.,
+             * require run() to be executing.
+             */
+            double refresh_ahead{0.};
+            /** Number of hits that qualify a response for being refreshed ahead. */
+            std::uint32_t refresh_ahead_min_hits{2};
+        };
+    };
+
+    /** @brief Summarizes the types describing transparent decoding of compressed responses. */
+    struct Decoding
+    {
+        Decoding() = delete;
+
+        /**
+         * @brief Options for advertising content encodings and decoding responses.
+         *
+         * Requests carry an Accept-Encoding header field and compressed responses are
+         * decoded before being handed out, both to StreamingRequest::DataHandler instances
+         * and in Response::body. The Content-Encoding header field of the response
+         * is left untouched. Requests can opt in or out individually,
+         * see Request::Configuration::decoding.
+         */
+        struct Configuration
+        {
+            /** Decoding is opt-in. */
+            bool enabled{false};
+            /**
+             * Comma-separated list of encodings to advertise, e.g. "gzip, br". If empty,
+             * all encodings supported by the runtime are advertised, out of
+             * gzip, deflate, br and zstd.
+             */
+            std::string encodings;
+        };
+    };
+
+    /** @brief The Configuration struct encapsulates all options for creating clients. */
+    struct Configuration
+    {
+        /** Per-host circuit breaking. */
+        CircuitBreaker::Configuration circuit_breaker;
+        /** Per-host adaptive concurrency limit. */
+        ConcurrencyLimit::Configuration concurrency_limit;
+        /**
+         * Endpoint groups keyed by the host part of the URIs addressing them, e.g. "http://search".
+         * The host of a request URI matching a group is replaced by one of the group's endpoints.
+         */
+        std::map<std::string, LoadBalancing::EndpointGroup> endpoint_groups;
+        /** Coalescing of identical GET and HEAD requests in flight. */
+        Coalescing::Configuration coalescing;
+        /** Caching of responses to GET requests. */
+        Cache::Configuration cache;
+        /** Transparent decoding of compressed responses. */
+        Decoding::Configuration decoding;
+    };
+
+    /** @brief Summarizes counters and gauges describing the runtime behavior of a client. */
+    struct Metrics
+    {
+        /** @brief Figures collected for an individual host. */
+        struct Host
+        {
+            struct
+            {
+                /** Current state of the host's circuit. */
+                CircuitBreaker::State state{CircuitBreaker::State::closed};
+                /** Number of failed requests observed. */
+                std::uint64_t failures{0};
+                /** Number of requests rejected without being executed. */
+                std::uint64_t rejected{0};
+            } circuit_breaker;
+
+            struct
+            {
+                /** The current limit of requests in flight. */
+                std::uint32_t limit{0};
+                /** Number of requests currently in flight. */
+                std::uint32_t in_flight{0};
+                /** Number of requests currently waiting for a free slot. */
+                std::uint32_t queued{0};
+            } concurrency;
+        };
+
+        /** @brief Figures collected for an individual endpoint of a group. */
+        struct Endpoint
+        {
+            /** Number of requests currently in flight. */
+            std::uint32_t outstanding{0};
+            /** Number of completed requests. */
+            std::uint64_t requests{0};
+            /** Number of failed requests. */
+            std::uint64_t failures{0};
+            /** Moving average of the latency of requests, failed ones count with a penalty. */
+            std::chrono::duration<double> ewma_latency{0};
+            /** True if the endpoint is currently ejected. */
+            bool ejected{false};
+            /** Number of times the endpoint has been ejected. */
+            std::uint32_t ejections{0};
+        };
+
+        /** @brief Figures collected for an endpoint group. */
+        struct EndpointGroup
+        {
+            /** Per-endpoint figures, keyed by the endpoint's base URI. */
+            std::map<std::string, Endpoint> endpoints;
+        };
+
+        /** @brief Figures collected for an individual mirror of segmented downloads. */
+        struct Mirror
+        {
+            /** Number of body bytes received from the mirror. */
+            std::uint64_t bytes{0};
+            /** Accumulated duration of the transfers from the mirror. */
+            std::chrono::duration<double> busy{0};
+            /** Bytes per second received by an individual transfer from the mirror, on average. */
+            double throughput{0.};
+            /** Number of transfers issued to the mirror. */
+            std::uint64_t transfers{0};
+            /** Number of transfers that failed. */
+            std::uint64_t failures{0};
+            /** Number of downloads the mirror has been dropped from. */
+            std::uint32_t drops{0};
+        };
+
+        /** Per-host figures, keyed by scheme, host and port (e.g. "http://127.0.0.1:5000"). */
+        std::map<std::string, Host> hosts;
+        /** Per-group figures, keyed by the name of the group. */
+        std::map<std::string, EndpointGroup> endpoint_groups;
+        /** Per-mirror figures of segmented downloads, keyed by the URI fetched from the mirror. */
+        std::map<std::string, Mirror> mirrors;
+
+        struct
+        {
+            /** Number of requests that were served by the transfer of an identical request. */
+            std::uint64_t deduplicated{0};
+        } coalescing;
+
+        struct
+        {
+            /** Number of requests served from the cache without contacting the server. */
+            std::uint64_t hits{0};
+            /** Number of requests that found no usable response in the cache. */
+            std::uint64_t misses{0};
+            /** Number of conditional requests issued to revalidate stale responses. */
+            std::uint64_t revalidations{0};
+            /** Number of revalidations confirming that the cached response is still valid. */
+            std::uint64_t not_modified{0};
+            /** Number of revalidations carried out in the background. */
+            std::uint64_t refreshes{0};
+            /** Number of failed accesses to the cache storage. Requests are served regardless. */
+            std::uint64_t failures{0};
+            /** Number of responses currently cached. */
+            std::uint64_t entries{0};
+            /** Accumulated size of the responses currently cached in bytes. */
+            std::uint64_t size{0};
+        } cache;
+
+        struct
+        {
+            /** Number of response body bytes received from the network, before decoding. */
+            std::uint64_t wire_bytes{0};
+            /** Number of response body bytes handed out, after decoding. */
+            std::uint64_t decoded_bytes{0};
+        } received;
+
+        struct
+        {
+            /** Number of request bodies announced with Expect: 100-continue. */
+            std::uint64_t announced{0};
+            /** Number of announced bodies the server rejected before they were sent in full. */
+            std::uint64_t rejected{0};
+            /** Number of body bytes left unsent thanks to those rejections. */
+            std::uint64_t saved_bytes{0};
+        } expect_continue;
     };
 
     /** @brief Summarizes timing information about completed requests. */
@@ -93,6 +485,33 @@ public:
         Statistics total{};
     };
 
+    /** @brief Reading a request body from a file. */
+    struct FileSource
+    {
+        FileSource() = delete;
+
+        /** @brief Configuration of the file a body is read from. */
+        struct Configuration
+        {
+            /** The file to read the body from. */
+            std::string path;
+            /** If valid, the body is read from this descriptor instead of from path. The descriptor is not closed. */
+            int fd{-1};
+            /** Offset of the body in the file. */
+            std::uint64_t offset{0};
+            /** Size of the body, or -1 for the rest of the file following offset. */
+            std::int64_t size{-1};
+            /**
+             * Map the file into memory and copy the body from the mapping, instead of reading
+             * it with pread. Files that cannot be mapped are read. The file must not shrink
+             * while it is mapped.
+             */
+            bool map{true};
+            /** Size of the chunks the body is handed to the network in, limited to 2 MiB. */
+            std::size_t buffer_size{512 * 1024};
+        };
+    };
+
     Client(const Client&) = delete;
     virtual ~Client() = default;
 
@@ -155,6 +574,29 @@ public:
      */
     virtual std::shared_ptr<Request> post(const Request::Configuration& configuration, const std::string& payload, const std::string& type) = 0;
 
+    /**
+     * @brief post issues a POST request for the given URI, taking over the payload instead of copying it.
+     * @throw Errors::HttpMethodNotSupported if the underlying implementation does not support the provided HTTP method.
+     * @param configuration The configuration to issue a post request for.
+     * @param payload The data to be transmitted as part of the POST request, which may contain NUL bytes.
+     * @param type The content-type of the data.
+     * @return An executable instance of class Request.
+     */
+    std::shared_ptr<Request> post(const Request::Configuration& configuration, std::string&& payload, const std::string& type);
+
+    /**
+     * @brief post issues a POST request for the given URI, sharing an immutable payload instead of copying it.
+     *
+     * The request keeps the payload alive until it goes away, any number of requests may share it.
+     *
+     * @throw Errors::HttpMethodNotSupported if the underlying implementation does not support the provided HTTP method.
+     * @param configuration The configuration to issue a post request for.
+     * @param payload The data to be transmitted as part of the POST request, which may contain NUL bytes.
+     * @param type The content-type of the data.
+     * @return An executable instance of class Request.
+     */
+    std::shared_ptr<Request> post(const Request::Configuration& configuration, const std::shared_ptr<const std::string>& payload, const std::string& type);
+
     /**
      * @brief post_form is a convenience method for issuing a POST request for the given URI, with url-encoded payload.
      * @throw Errors::HttpMethodNotSupported if the underlying implementation does not support the provided HTTP method.
@@ -174,6 +616,34 @@ public:
      */
     std::shared_ptr<Request> post(const Request::Configuration& configuration, std::istream& payload, std::size_t size);
 
+    /**
+     * @brief put issues a PUT request for the given URI, sending the contents of a file.
+     *
+     * The body is handed to the network straight from the file, hinting the kernel at
+     * sequential access, instead of passing through a stream buffer.
+     *
+     * @throw std::system_error if the file cannot be opened.
+     * @throw core::net::http::Error on execution if reading the file fails.
+     * @param configuration The configuration to issue a put request for.
+     * @param source The configuration of the file to read the body from.
+     * @return An executable instance of class Request.
+     */
+    std::shared_ptr<Request> put(const Request::Configuration& configuration, const FileSource::Configuration& source);
+
+    /**
+     * @brief post issues a POST request for the given URI, sending the contents of a file.
+     *
+     * As put, with the Content-Type header set to type unless configuration carries one.
+     *
+     * @throw std::system_error if the file cannot be opened.
+     * @throw core::net::http::Error on execution if reading the file fails.
+     * @param configuration The configuration to issue a post request for.
+     * @param source The configuration of the file to read the body from.
+     * @param type The content type of the body.
+     * @return An executable instance of class Request.
+     */
+    std::shared_ptr<Request> post(const Request::Configuration& configuration, const FileSource::Configuration& source, const std::string& type);
+
     /** 
      * @brief del is a convenience method for issueing a DELETE request for the given URI.
      * @throw Errors::HttpMethodNotSupported if the underlying implementation does not support the provided HTTP method.
@@ -182,12 +652,18 @@ public:
      */
     std::shared_ptr<Request> del(const Request::Configuration& configuration);
 
+    /** @brief Queries a snapshot of the counters and gauges maintained by this client. */
+    Metrics metrics();
+
 protected:
     Client() = default;
 };
 
 /** @brief Dispatches to the default implementation and returns a client instance. */
 CORE_NET_DLL_PUBLIC std::shared_ptr<Client> make_client();
+
+/** @brief Dispatches to the default implementation and returns a client instance set up according to configuration. */
+CORE_NET_DLL_PUBLIC std::shared_ptr<Client> make_client(const Client::Configuration& configuration);
 }
 }
 }
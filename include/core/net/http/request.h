@@ -25,6 +25,8 @@
 #include <core/net/http/header.h>
 
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace core
@@ -51,6 +53,37 @@ public:
         done ///< Execution of the request has finished.
     };
 
+    /**
+     * @brief The Decoding enum describes whether compressed responses to a request are decoded.
+     */
+    enum class Decoding
+    {
+        inherit, ///< Follow the client-wide setting, see Client::Configuration::decoding.
+        enabled, ///< Advertise the client's encodings and decode responses.
+        disabled ///< Neither advertise encodings nor decode responses.
+    };
+
+    /**
+     * @brief The Compression enum describes the algorithms available for compressing request bodies.
+     */
+    enum class Compression
+    {
+        none, ///< The body is sent as is.
+        gzip, ///< The body is compressed with gzip.
+        zstd ///< The body is compressed with zstd, if supported by the build.
+    };
+
+    /**
+     * @brief The ExpectContinue enum describes when request bodies are announced with
+     * Expect: 100-continue, letting the server reject them before they are sent.
+     */
+    enum class ExpectContinue
+    {
+        never, ///< Bodies are sent right away.
+        always, ///< Every body waits for the server to accept it.
+        above_threshold ///< Bodies reaching the threshold, and bodies of unknown size, wait for the server.
+    };
+
     /**
      * @brief The Errors struct collects the Request-specific exceptions and error modes.
      */
@@ -213,6 +246,51 @@ public:
             /** Invoked for querying user credentials to authenticate proxy accesses. */
             AuthenicationHandler for_proxy;
         } authentication_handler;
+
+        /**
+         * Requests carrying the same non-empty affinity key are routed to the same
+         * endpoint of an endpoint group using the consistent_hash policy.
+         */
+        std::string affinity_key;
+
+        /** Overrides the client-wide decoding of compressed responses. */
+        Decoding decoding{Decoding::inherit};
+
+        /**
+         * Redirects followed before giving up, none by default. Bodies of requests
+         * are sent again for 307 and 308 redirects if they can be rewound.
+         */
+        long max_redirects{0};
+
+        /**
+         * Compression of request bodies. Compressed bodies are announced by a
+         * Content-Encoding header field. Streamed bodies are compressed as they
+         * are read and sent with chunked transfer encoding, as their compressed
+         * size is not known upfront.
+         */
+        struct
+        {
+            /** Bodies are sent as is by default. */
+            Compression algorithm{Compression::none};
+            /** Bodies smaller than this are sent as is. */
+            std::size_t min_size{1024};
+        } compression;
+
+        /**
+         * Announcing request bodies with Expect: 100-continue. Large bodies rejected by
+         * the server, e.g. with 401 or 413, are not sent at all, while small bodies avoid
+         * the round trip of waiting for the server. An Expect header field given by the
+         * caller takes precedence.
+         */
+        struct
+        {
+            /** Bodies of at least threshold bytes are announced by default. */
+            ExpectContinue policy{ExpectContinue::above_threshold};
+            /** Size of the smallest body announced by ExpectContinue::above_threshold, before compression. */
+            std::uint64_t threshold{1024 * 1024};
+            /** Time to wait for the server to accept a body before sending it anyway. */
+            std::chrono::milliseconds timeout{1000};
+        } expect_continue;
     };
 
     Request(const Request&) = delete;
@@ -22,6 +22,13 @@
 #include <core/net/http/client.h>
 
 #include <core/net/http/streaming_request.h>
+#include <core/net/http/upload_writer.h>
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace core
 {
@@ -32,6 +39,245 @@ namespace http
 class StreamingClient : public Client
 {
 public:
+    /** @brief Writing response bodies straight to a file. */
+    struct FileSink
+    {
+        FileSink() = delete;
+
+        /** @brief When data written to the file is flushed to stable storage. */
+        enum class Sync
+        {
+            /** Leave it to the kernel. */
+            never,
+            /** Once, after the complete body has been written. */
+            on_completion,
+            /** Every sync_interval bytes and after the complete body has been written. */
+            periodically
+        };
+
+        /** @brief Configuration of the file a body is written to. */
+        struct Configuration
+        {
+            /**
+             * The file to write the body to. The body is written to a temporary
+             * file next to it first, replacing path atomically once complete.
+             */
+            std::string path;
+            /** If valid, the body is written to this descriptor at its current offset instead of to path. */
+            int fd{-1};
+            /** Reserve space for the body upfront if the server announces its size. */
+            bool preallocate{true};
+            /** Chunks received from the network are coalesced into writes of this size. */
+            std::size_t buffer_size{1024 * 1024};
+            /** When to flush written data to stable storage. */
+            Sync sync{Sync::on_completion};
+            /** Number of bytes between syncs, for Sync::periodically. */
+            std::uint64_t sync_interval{64 * 1024 * 1024};
+            /**
+             * Keep the partial body of an interrupted download in path + ".part", next to
+             * a state file path + ".part.state" recording the URI, the validator and the
+             * number of bytes written. A later download of the same URI to path resumes
+             * with a range request, starting over if the resource has changed meanwhile
+             * or the partial response carries no validator to tell. Only applies to
+             * targets given by path.
+             */
+            bool resumable{false};
+        };
+    };
+
+    /** @brief Constants for request bodies produced by a read callback. */
+    struct Upload
+    {
+        Upload() = delete;
+
+        /** Size of a body whose length is not known upfront, sent with Transfer-Encoding: chunked. */
+        static constexpr const std::size_t unknown_size = static_cast<std::size_t>(-1);
+
+        /**
+         * Returned by a read callback that has no data available yet, pausing the upload
+         * until StreamingRequest::resume() is called. Only applies to requests executed
+         * asynchronously.
+         */
+        static constexpr const std::size_t pause = 0x10000001;
+
+        /**
+         * Rewinds a body to the given offset from its start, returning false if that is not
+         * possible. Invoked when the body has to be sent again, following a 307 or 308 redirect
+         * or an authentication challenge.
+         */
+        typedef std::function<bool(std::uint64_t offset)> Seeker;
+
+        /** @brief One of the buffers a body is gathered from. */
+        struct Buffer
+        {
+            /**
+             * @brief Refers to size bytes at data, which the caller keeps alive and
+             * unchanged until the request has completed.
+             */
+            Buffer(const char* data, std::size_t size)
+                : data(data),
+                  size(size)
+            {
+            }
+
+            /** @brief Refers to the contents of a string shared with the request, which keeps it alive. */
+            Buffer(const std::shared_ptr<const std::string>& shared)
+                : data(shared->data()),
+                  size(shared->size()),
+                  owner(shared)
+            {
+            }
+
+            /** Start of the data. */
+            const char* data;
+            /** Number of bytes at data. */
+            std::size_t size;
+            /** Keeps data alive, empty if the caller does so. */
+            std::shared_ptr<const void> owner;
+        };
+
+        /** @brief The buffers a body is gathered from, in order. */
+        typedef std::vector<Buffer> Buffers;
+
+        /** @brief A request paired with the writer feeding its body. */
+        struct Writable
+        {
+            /** The request, executed like any other. */
+            std::shared_ptr<StreamingRequest> request;
+            /** The writer to hand the body to, from any thread. */
+            std::shared_ptr<UploadWriter> writer;
+        };
+    };
+
+    /** @brief Encoding forms as multipart/form-data, part by part while the body is sent. */
+    struct Multipart
+    {
+        Multipart() = delete;
+
+        /** @brief A part of a form, its contents either in memory or in a file. */
+        struct Part
+        {
+            /**
+             * @brief field creates a part carrying a value in memory.
+             * @param name The name of the form field.
+             * @param value The value of the form field, copied into the part.
+             */
+            static Part field(const std::string& name, const std::string& value)
+            {
+                Part result;
+                result.name = name;
+                result.contents.emplace_back(std::make_shared<const std::string>(value));
+
+                return result;
+            }
+
+            /**
+             * @brief file creates a part whose contents are read from a file while the body is sent.
+             * @param name The name of the form field.
+             * @param source The file to read the contents from.
+             * @param filename The file name announced for the part.
+             * @param type The content type of the part.
+             */
+            static Part file(const std::string& name,
+                             const FileSource::Configuration& source,
+                             const std::string& filename,
+                             const std::string& type = "application/octet-stream")
+            {
+                Part result;
+                result.name = name;
+                result.filename = filename;
+                result.type = type;
+                result.source = source;
+
+                return result;
+            }
+
+            /** The name of the form field. */
+            std::string name;
+            /** The file name announced for the part, none if empty. */
+            std::string filename;
+            /** The content type announced for the part, none if empty. */
+            std::string type;
+            /** The contents of the part, unless source names a file. */
+            Upload::Buffers contents;
+            /** The file to read the contents from, if it is given by path or descriptor. */
+            FileSource::Configuration source;
+        };
+
+        /** @brief The parts of a form, in order. */
+        typedef std::vector<Part> Parts;
+    };
+
+    /** @brief Downloading a resource in byte ranges fetched concurrently. */
+    struct Segmentation
+    {
+        Segmentation() = delete;
+
+        /** @brief Configuration of segmented downloads. */
+        struct Configuration
+        {
+            /** Number of segments fetched concurrently to begin with. */
+            std::size_t segments{4};
+            /** Upper bound on the number of segments fetched concurrently. */
+            std::size_t max_segments{8};
+            /** Segments are not split below this size. */
+            std::uint64_t min_segment_size{1024 * 1024};
+            /** Number of times a failing segment is retried, resuming where it left off. */
+            unsigned int max_retries{3};
+            /** Adjust the number of concurrent segments to the aggregate throughput achieved. */
+            bool adaptive{true};
+        };
+    };
+
+    /** @brief Fetching only the blocks of a resource missing from a local file, following zsync. */
+    struct Delta
+    {
+        Delta() = delete;
+
+        /** @brief Configuration of delta downloads. */
+        struct Configuration
+        {
+            /** The zsync control file describing the blocks of the resource. */
+            std::string manifest;
+            /** A local file likely to share blocks with the resource, e.g. a previous version of it. */
+            std::string seed;
+            /** Missing ranges less than this many bytes apart are requested as one, including the bytes in between. */
+            std::uint64_t max_gap{4 * 1024};
+            /** Upper bound on the number of ranges requested at once. */
+            std::size_t max_ranges{32};
+            /** Upper bound on the number of bytes requested at once, which are held in memory until written. */
+            std::uint64_t max_request_size{4 * 1024 * 1024};
+        };
+
+        /**
+        * @brief write_manifest writes a zsync control file describing the blocks of a resource.
+        * @throw std::invalid_argument if block_size is not a power of two of at least 64.
+        * @param in The contents of the resource.
+        * @param out The stream to write the control file to.
+        * @param url The URL the resource is published at.
+        * @param block_size The size of the blocks described.
+        */
+        CORE_NET_DLL_PUBLIC static void write_manifest(std::istream& in, std::ostream& out, const std::string& url, std::size_t block_size = 2048);
+    };
+
+    /** @brief Bounding the data buffered for a consumer falling behind the network. */
+    struct Buffering
+    {
+        Buffering() = delete;
+
+        /** @brief Configuration of the buffer between the network and the data handler. */
+        struct Configuration
+        {
+            /**
+             * Upper bound on the number of bytes buffered. The transfer pauses while the
+             * buffer is full and resumes once half of it has been drained. A single chunk
+             * handed out by the network may exceed it.
+             */
+            std::size_t capacity{1024 * 1024};
+            /** Upper bound on the size of the chunks handed to the data handler. */
+            std::size_t chunk_size{64 * 1024};
+        };
+    };
 
     virtual ~StreamingClient() = default;
 
@@ -71,6 +317,29 @@ public:
     */
     virtual std::shared_ptr<StreamingRequest> streaming_post(const Request::Configuration& configuration, const std::string& payload, const std::string& type) = 0;
 
+    /**
+    * @brief streaming_post issues a POST request for the given URI, taking over the payload instead of copying it.
+    * @param configuration The configuration to issue a post request for.
+    * @param payload The data to be transmitted as part of the POST request, which may contain NUL bytes.
+    * @param type The content-type of the data.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_post(const Request::Configuration& configuration, std::string&& payload, const std::string& type);
+
+    /**
+    * @brief streaming_post issues a POST request for the given URI, sharing an immutable payload instead of copying it.
+    *
+    * The request keeps the payload alive until it goes away, any number of requests may share it.
+    *
+    * @param configuration The configuration to issue a post request for.
+    * @param payload The data to be transmitted as part of the POST request, which may contain NUL bytes.
+    * @param type The content-type of the data.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_post(const Request::Configuration& configuration,
+                                                                         const std::shared_ptr<const std::string>& payload,
+                                                                         const std::string& type);
+
     /**
     * @brief streaming_post_form is a convenience method for issuing a POST request for the given URI, with url-encoded payload.
     * @throw Errors::HttpMethodNotSupported if the underlying implementation does not support the provided HTTP method.
@@ -96,7 +365,8 @@ public:
     * @param configuration The configuration to issue a get request for.
     * @param readdata_callback The callback function to read data in order to send it to the peer.
     *        The data area pointed at by the pointer \a dest should be filled up with at most \a buf_size number of bytes.
-    * @param size Size of the payload data in bytes.
+    *        Returning 0 ends the body, returning Upload::pause pauses the upload.
+    * @param size Size of the payload data in bytes, or Upload::unknown_size to send the body chunked until the callback ends it.
     * @return An executable instance of class Request.
     */
     virtual std::shared_ptr<StreamingRequest> streaming_post(const Request::Configuration& configuration, std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback, std::size_t size) = 0;
@@ -107,7 +377,8 @@ public:
     * @param configuration The configuration to issue a get request for.
     * @param readdata_callback The callback function to read data in order to send it to the peer.
     *        The data area pointed at by the pointer \a dest should be filled up with at most \a buf_size number of bytes.
-    * @param size Size of the payload data in bytes.
+    *        Returning 0 ends the body, returning Upload::pause pauses the upload.
+    * @param size Size of the payload data in bytes, or Upload::unknown_size to send the body chunked until the callback ends it.
     * @return An executable instance of class Request.
     */
     virtual std::shared_ptr<StreamingRequest> streaming_put(const Request::Configuration& configuration, std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback, std::size_t size) = 0;
@@ -119,10 +390,277 @@ public:
     * @return An executable instance of class Request.
     */
     virtual std::shared_ptr<StreamingRequest> streaming_del(const Request::Configuration& configuration) = 0;
+
+    /**
+    * @brief streaming_get_to_file issues a GET request for the given URI, writing a successful response body to a file.
+    *
+    * The body is neither handed to the data handler nor accumulated in the response.
+    * Response bodies of unsuccessful requests are handled as usual, leaving the file untouched.
+    * Requests writing to a file bypass response caching and coalescing.
+    *
+    * @throw std::system_error if the file cannot be created.
+    * @throw core::net::http::Error on execution if writing to the file fails.
+    * @param configuration The configuration to issue a get request for.
+    * @param sink The configuration of the file to write the response body to.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_get_to_file(const Request::Configuration& configuration, const FileSink::Configuration& sink);
+
+    /**
+    * @brief segmented_get_to_file downloads the given URI to a file, fetching byte ranges of it concurrently.
+    *
+    * The resource is probed with a HEAD request first. If the server accepts byte ranges and
+    * announces the size of the resource, the body is split into segments fetched over separate
+    * connections and written straight to their offsets in the file. Segments failing midway
+    * are retried from where they left off. Segments finishing early split the largest
+    * outstanding one, and with adaptive segmentation, the number of concurrent segments
+    * follows the aggregate throughput. Other resources are downloaded in a single transfer
+    * as by streaming_get_to_file.
+    *
+    * Asynchronous execution requires the client to be run, synchronous execution
+    * drives the transfers from the calling thread.
+    *
+    * @throw std::system_error if the file cannot be created.
+    * @throw core::net::http::Error on execution if a segment fails for good or writing to the file fails.
+    * @param configuration The configuration to issue the requests for.
+    * @param sink The configuration of the file to write the response body to.
+    * @param segmentation The configuration of the segments.
+    * @return An executable instance of class Request, the response of which carries the header of the probe.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> segmented_get_to_file(const Request::Configuration& configuration,
+                                                                                const FileSink::Configuration& sink,
+                                                                                const Segmentation::Configuration& segmentation);
+
+    /**
+    * @brief mirrored_get_to_file downloads a resource replicated on several mirrors to a file,
+    * fetching byte ranges of it from all of them concurrently.
+    *
+    * Works like segmented_get_to_file, probing the first mirror that responds. Segments are
+    * spread across the mirrors, preferring the ones with fewer transfers in flight and higher
+    * throughput. Mirrors finishing their segments early take over half of the largest outstanding
+    * segment, which leaves less of the work to slow mirrors. A mirror failing a transfer without
+    * delivering any data is dropped from the download as long as others are left, and its
+    * segment is retried on them. Figures about the individual mirrors are reported in
+    * Client::Metrics::mirrors.
+    *
+    * All mirrors are expected to serve identical bytes. Ranges requested from the probed mirror are
+    * validated with If-Range. Every partial response has to report the length announced by the probe
+    * in its Content-Range, and the validator of the probe if it carries one. Mirrors that disagree
+    * are dropped like failing ones.
+    *
+    * @throw std::system_error if the file cannot be created.
+    * @throw core::net::http::Error on execution if a segment fails for good or writing to the file fails.
+    * @param configuration The configuration to issue the requests for, apart from the URI.
+    * @param mirrors The URIs of the resource on the individual mirrors, configuration.uri if empty.
+    * @param sink The configuration of the file to write the response body to.
+    * @param segmentation The configuration of the segments.
+    * @return An executable instance of class Request, the response of which carries the header of the probe.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> mirrored_get_to_file(const Request::Configuration& configuration,
+                                                                               const std::vector<std::string>& mirrors,
+                                                                               const FileSink::Configuration& sink,
+                                                                               const Segmentation::Configuration& segmentation);
+
+    /**
+    * @brief delta_get_to_file downloads a resource to a file, fetching only the blocks missing from a local seed file.
+    *
+    * On execution, the seed is scanned for the blocks listed in the zsync control file of the resource
+    * on the calling thread, with a rolling checksum. Blocks found are copied from the seed, the missing
+    * ones are fetched with multi-range requests, or with single-range requests from servers that answer
+    * those with the first range only. A server ignoring ranges altogether sends the complete resource.
+    * The assembled file is verified against the block checksums and the SHA-1 of the control file
+    * before it replaces the target. Descriptor targets need to be open for reading, too.
+    *
+    * @throw std::system_error if the control file cannot be read or the file cannot be created.
+    * @throw std::runtime_error if the control file is malformed.
+    * @throw core::net::http::Error on execution if a request fails or the assembled file does not verify.
+    * @param configuration The configuration to issue the requests for. The URL given by the control file is used if its uri is empty.
+    * @param sink The configuration of the file to write the resource to.
+    * @param delta The configuration of the delta download.
+    * @return An executable instance of class Request, reporting Status::ok once the file is complete.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> delta_get_to_file(const Request::Configuration& configuration,
+                                                                            const FileSink::Configuration& sink,
+                                                                            const Delta::Configuration& delta);
+
+    /**
+    * @brief resumable_put uploads a file with PUT, resuming an interrupted upload of it.
+    *
+    * Progress is recorded in a state file. If the state file refers to the same file, unchanged,
+    * the server is asked for the bytes it has committed by an empty PUT whose Content-Range
+    * header gives the size of the file only. A 308 (Resume Incomplete) response with a Range header
+    * "bytes=0-n" continues the upload at offset n + 1 with a matching Content-Range. A successful
+    * response means that the upload is complete, provided the server has answered with 308 before.
+    * Otherwise, and for servers unaware of the protocol, the complete file is sent again.
+    * The state file is removed once the upload has succeeded.
+    *
+    * @throw std::system_error if the file cannot be opened.
+    * @param configuration The configuration to issue the requests for.
+    * @param path The file to upload.
+    * @param state The file recording the progress of the upload.
+    * @return An executable instance of class Request, reporting the response to the final request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> resumable_put(const Request::Configuration& configuration,
+                                                                        const std::string& path,
+                                                                        const std::string& state);
+
+    /**
+    * @brief streaming_put_file issues a PUT request for the given URI, sending the contents of a file.
+    *
+    * The body is handed to the network straight from the file, hinting the kernel at
+    * sequential access, instead of passing through a stream buffer.
+    *
+    * @throw std::system_error if the file cannot be opened.
+    * @throw core::net::http::Error on execution if reading the file fails.
+    * @param configuration The configuration to issue a put request for.
+    * @param source The configuration of the file to read the body from.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_put_file(const Request::Configuration& configuration, const FileSource::Configuration& source);
+
+    /**
+    * @brief streaming_post_file issues a POST request for the given URI, sending the contents of a file.
+    *
+    * As streaming_put_file, with the Content-Type header set to type unless configuration carries one.
+    *
+    * @throw std::system_error if the file cannot be opened.
+    * @throw core::net::http::Error on execution if reading the file fails.
+    * @param configuration The configuration to issue a post request for.
+    * @param source The configuration of the file to read the body from.
+    * @param type The content type of the body.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_post_file(const Request::Configuration& configuration,
+                                                                              const FileSource::Configuration& source,
+                                                                              const std::string& type);
+
+    /**
+    * @brief streaming_put_writer issues a PUT request for the given URI, whose body is pushed through a writer.
+    *
+    * Producers write the body to the writer while the request executes, the request waits for
+    * data to arrive, pausing if executed asynchronously, and sends it as it comes in. The body
+    * ends once the writer is closed, writes fail once the request has completed.
+    *
+    * @param configuration The configuration to issue a put request for.
+    * @param writer The configuration of the writer, bounding the data queued.
+    * @return The executable request, and the writer feeding it.
+    */
+    CORE_NET_DLL_PUBLIC Upload::Writable streaming_put_writer(const Request::Configuration& configuration, const UploadWriter::Configuration& writer);
+
+    /**
+    * @brief streaming_post_writer issues a POST request for the given URI, whose body is pushed through a writer.
+    *
+    * As streaming_put_writer, with the Content-Type header set to type unless configuration carries one.
+    *
+    * @param configuration The configuration to issue a post request for.
+    * @param writer The configuration of the writer, bounding the data queued.
+    * @param type The content type of the body.
+    * @return The executable request, and the writer feeding it.
+    */
+    CORE_NET_DLL_PUBLIC Upload::Writable streaming_post_writer(const Request::Configuration& configuration,
+                                                               const UploadWriter::Configuration& writer,
+                                                               const std::string& type);
+
+    /**
+    * @brief streaming_put_buffers issues a PUT request for the given URI, whose body is gathered from a sequence of buffers.
+    *
+    * The buffers are sent in order, without being concatenated first. The Content-Length
+    * header is set to their total size, unless the body is compressed.
+    *
+    * @param configuration The configuration to issue a put request for.
+    * @param buffers The buffers making up the body.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_put_buffers(const Request::Configuration& configuration, const Upload::Buffers& buffers);
+
+    /**
+    * @brief streaming_post_buffers issues a POST request for the given URI, whose body is gathered from a sequence of buffers.
+    *
+    * As streaming_put_buffers, with the Content-Type header set to type unless configuration carries one.
+    *
+    * @param configuration The configuration to issue a post request for.
+    * @param buffers The buffers making up the body.
+    * @param type The content type of the body.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_post_buffers(const Request::Configuration& configuration,
+                                                                                 const Upload::Buffers& buffers,
+                                                                                 const std::string& type);
+
+    /**
+    * @brief streaming_put issues a PUT request for the given URI, whose body is read by a callback and can be rewound.
+    *
+    * As streaming_put with a read callback. Bodies that can be rewound by seeker are sent again
+    * for redirects and authentication challenges instead of failing the request. Compressed
+    * bodies are never rewound.
+    *
+    * @param configuration The configuration to issue a put request for.
+    * @param readdata_callback The callback function to read data in order to send it to the peer.
+    * @param seeker Rewinds the body read by readdata_callback.
+    * @param size Size of the payload data in bytes, or Upload::unknown_size to send the body chunked until the callback ends it.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_put(const Request::Configuration& configuration,
+                                                                        std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback,
+                                                                        const Upload::Seeker& seeker,
+                                                                        std::size_t size);
+
+    /**
+    * @brief streaming_post issues a POST request for the given URI, whose body is read by a callback and can be rewound.
+    *
+    * As streaming_put with a seeker, for the POST method.
+    *
+    * @param configuration The configuration to issue a post request for.
+    * @param readdata_callback The callback function to read data in order to send it to the peer.
+    * @param seeker Rewinds the body read by readdata_callback.
+    * @param size Size of the payload data in bytes, or Upload::unknown_size to send the body chunked until the callback ends it.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_post(const Request::Configuration& configuration,
+                                                                         std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback,
+                                                                         const Upload::Seeker& seeker,
+                                                                         std::size_t size);
+
+    /**
+    * @brief streaming_post_multipart issues a POST request for the given URI, sending a form encoded as multipart/form-data.
+    *
+    * The body is encoded while it is sent, reading the contents of file parts as they are needed,
+    * so large forms are sent in constant memory. The Content-Length header is set to the size of the
+    * encoded body, unless the body is compressed. The Content-Type header announces the boundary
+    * delimiting the parts.
+    *
+    * @throw std::system_error if a file cannot be opened.
+    * @throw core::net::http::Error on execution if reading a file fails.
+    * @param configuration The configuration to issue a post request for.
+    * @param parts The parts of the form.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_post_multipart(const Request::Configuration& configuration,
+                                                                                   const Multipart::Parts& parts);
+
+    /**
+    * @brief streaming_get_buffered issues a GET request for the given URI, whose body is handed out at the pace of its consumer.
+    *
+    * Executed asynchronously, chunks of the body are queued in a bounded buffer and the data handler
+    * is invoked on a thread of its own, draining it. The transfer pauses while the buffer is full and
+    * resumes as the data handler catches up, neither blocking the reactor nor buffering without limit.
+    * The response handlers are invoked on that thread, too, once the data handler has seen all of the
+    * body. The body is not accumulated in the response. Executed synchronously, the data handler is
+    * invoked on the calling thread and paces the transfer by itself.
+    *
+    * @param configuration The configuration to issue a get request for.
+    * @param buffering The configuration of the buffer.
+    * @return An executable instance of class Request.
+    */
+    CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingRequest> streaming_get_buffered(const Request::Configuration& configuration,
+                                                                                 const Buffering::Configuration& buffering);
 };
 
 /** @brief Dispatches to the default implementation and returns a streaming client instance. */
 CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingClient> make_streaming_client();
+
+/** @brief Dispatches to the default implementation and returns a streaming client instance set up according to configuration. */
+CORE_NET_DLL_PUBLIC std::shared_ptr<StreamingClient> make_streaming_client(const Client::Configuration& configuration);
 }
 }
 }
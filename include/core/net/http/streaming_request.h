@@ -19,6 +19,7 @@
 #ifndef CORE_NET_HTTP_STREAMING_REQUEST_H_
 #define CORE_NET_HTTP_STREAMING_REQUEST_H_
 
+#include <core/net/http/body_reader.h>
 #include <core/net/http/request.h>
 
 namespace core
@@ -54,6 +55,21 @@ public:
      */
     virtual void async_execute(const Handler& handler, const DataHandler& dh) = 0;
 
+    /**
+     * @brief Asynchronously executes the request, handing out the body to a reader pulling it in.
+     *
+     * The client has to be running on another thread. Instead of pushing chunks to a data handler,
+     * the body is buffered for the reader, pausing the transfer while the reader falls behind.
+     *
+     * @throw Errors::AlreadyActive if the request is executing already.
+     * @throw core::net::http::Error if the request writes its body to a file, as the requests created by
+     * StreamingClient::streaming_get_to_file, StreamingClient::segmented_get_to_file,
+     * StreamingClient::mirrored_get_to_file and StreamingClient::delta_get_to_file do.
+     * @param configuration The configuration of the reader.
+     * @return The reader to pull the body from.
+     */
+    std::shared_ptr<BodyReader> open(const BodyReader::Configuration& configuration = BodyReader::Configuration{});
+
     /** 
      * @brief Pause the request with options for aborting the request.
      * The request will be aborted if transfer speed falls below \a limit in [bytes/second] for \a time seconds.
@@ -0,0 +1,116 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_UPLOAD_WRITER_H_
+#define CORE_NET_HTTP_UPLOAD_WRITER_H_
+
+#include <core/net/visibility.h>
+
+#include <core/net/http/error.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+/**
+ * @brief The UploadWriter class feeds the body of a streaming upload from producer threads.
+ *
+ * Data written is queued up to a bounded capacity and handed to the network as the
+ * transfer asks for it. A transfer running out of data waits for the next write,
+ * a writer running out of capacity waits for the transfer, or fails right away.
+ * Writers may be used from any thread.
+ */
+class CORE_NET_DLL_PUBLIC UploadWriter
+{
+public:
+    /**
+     * @brief The Errors struct collects the UploadWriter-specific exceptions.
+     */
+    struct Errors
+    {
+        Errors() = delete;
+
+        /**
+         * @brief Full is thrown by a non-blocking writer if data does not fit into the queue.
+         */
+        struct Full : public core::net::http::Error
+        {
+            /**
+             * @brief Full creates a new instance with a location hint.
+             * @param loc The location that the call originates from.
+             */
+            Full(const core::Location& loc);
+        };
+
+        /**
+         * @brief Closed is thrown when writing to a writer that has been closed, or whose request has completed.
+         */
+        struct Closed : public core::net::http::Error
+        {
+            /**
+             * @brief Closed creates a new instance with a location hint.
+             * @param loc The location that the call originates from.
+             */
+            Closed(const core::Location& loc);
+        };
+    };
+
+    /** @brief Configuration of an upload writer. */
+    struct Configuration
+    {
+        /** Upper bound on the number of bytes queued. */
+        std::size_t capacity{1024 * 1024};
+        /** Wait for the transfer to make room if the queue is full, instead of throwing Errors::Full. */
+        bool blocking{true};
+        /** Size of the body if known upfront, -1 to send it with Transfer-Encoding: chunked. */
+        std::int64_t size{-1};
+    };
+
+    UploadWriter(const UploadWriter&) = delete;
+    virtual ~UploadWriter() = default;
+
+    UploadWriter& operator=(const UploadWriter&) = delete;
+    bool operator==(const UploadWriter&) const = delete;
+
+    /**
+     * @brief Queues size bytes of the body.
+     *
+     * A blocking writer queues data exceeding the capacity in pieces, as the transfer makes room.
+     *
+     * @throw Errors::Full if the writer is non-blocking and data does not fit into the queue.
+     * @throw Errors::Closed if the writer has been closed or its request has completed.
+     * @param data The bytes to queue.
+     * @param size The number of bytes to queue.
+     */
+    virtual void write(const char* data, std::size_t size) = 0;
+
+    /**
+     * @brief Ends the body once the queued data has been sent.
+     */
+    virtual void close() = 0;
+
+protected:
+    UploadWriter() = default;
+};
+}
+}
+}
+
+#endif // CORE_NET_HTTP_UPLOAD_WRITER_H_
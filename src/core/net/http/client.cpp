@@ -18,6 +18,7 @@
  */
 
 #include "impl/curl/client.h"
+#include "impl/zsync.h"
 
 #include <core/net/uri.h>
 #include <core/net/http/client.h>
@@ -37,6 +38,14 @@ http::Client::Errors::HttpMethodNotSupported::HttpMethodNotSupported(
 
 }
 
+http::Client::Errors::CircuitOpen::CircuitOpen(
+        const std::string& host,
+        const core::Location& loc)
+    : http::Error("Circuit open for host " + host, loc),
+      host(host)
+{
+}
+
 std::shared_ptr<http::Request> http::Client::post_form(
         const http::Request::Configuration& configuration,
         const std::map<std::string, std::string>& values)
@@ -91,7 +100,33 @@ std::string http::Client::uri_to_string(const core::net::Uri& uri) const
 }
 
 //TODO: Keep abi compatibility in vivid/xenial. 
-//Should be virtual function for the following two methods and move them to impl/curl/client.cpp.
+//Should be virtual function for the following methods and move them to impl/curl/client.cpp.
+std::shared_ptr<http::Request> http::Client::post(
+        const http::Request::Configuration& configuration,
+        std::string&& payload,
+        const std::string& type)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->post(configuration, std::move(payload), type);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::Request> http::Client::post(
+        const http::Request::Configuration& configuration,
+        const std::shared_ptr<const std::string>& payload,
+        const std::string& type)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->post(configuration, payload, type);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
 std::shared_ptr<http::Request> http::Client::post(
         const http::Request::Configuration& configuration, std::istream& payload, 
         std::size_t size)
@@ -104,6 +139,31 @@ std::shared_ptr<http::Request> http::Client::post(
     throw std::runtime_error("bad cast for curl client");
 }
 
+std::shared_ptr<http::Request> http::Client::put(
+        const http::Request::Configuration& configuration,
+        const http::Client::FileSource::Configuration& source)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->put(configuration, source);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::Request> http::Client::post(
+        const http::Request::Configuration& configuration,
+        const http::Client::FileSource::Configuration& source,
+        const std::string& type)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->post(configuration, source, type);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
 std::shared_ptr<http::Request> http::Client::del(
         const http::Request::Configuration& configuration)
 {
@@ -114,3 +174,236 @@ std::shared_ptr<http::Request> http::Client::del(
     }
     throw std::runtime_error("bad cast for curl client");
 }
+
+http::Client::Metrics http::Client::metrics()
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->metrics();
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_get_to_file(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::FileSink::Configuration& sink)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_get_to_file(configuration, sink);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::segmented_get_to_file(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::FileSink::Configuration& sink,
+        const http::StreamingClient::Segmentation::Configuration& segmentation)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->segmented_get_to_file(configuration, sink, segmentation);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::resumable_put(
+        const http::Request::Configuration& configuration,
+        const std::string& path,
+        const std::string& state)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->resumable_put(configuration, path, state);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::mirrored_get_to_file(
+        const http::Request::Configuration& configuration,
+        const std::vector<std::string>& mirrors,
+        const http::StreamingClient::FileSink::Configuration& sink,
+        const http::StreamingClient::Segmentation::Configuration& segmentation)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->mirrored_get_to_file(configuration, mirrors, sink, segmentation);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::delta_get_to_file(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::FileSink::Configuration& sink,
+        const http::StreamingClient::Delta::Configuration& delta)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->delta_get_to_file(configuration, sink, delta);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_put_file(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::FileSource::Configuration& source)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_put_file(configuration, source);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_post_file(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::FileSource::Configuration& source,
+        const std::string& type)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_post_file(configuration, source, type);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+http::StreamingClient::Upload::Writable http::StreamingClient::streaming_put_writer(
+        const http::Request::Configuration& configuration,
+        const http::UploadWriter::Configuration& writer)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_put_writer(configuration, writer);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+http::StreamingClient::Upload::Writable http::StreamingClient::streaming_post_writer(
+        const http::Request::Configuration& configuration,
+        const http::UploadWriter::Configuration& writer,
+        const std::string& type)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_post_writer(configuration, writer, type);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_post(
+        const http::Request::Configuration& configuration,
+        std::string&& payload,
+        const std::string& type)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_post(configuration, std::move(payload), type);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_post(
+        const http::Request::Configuration& configuration,
+        const std::shared_ptr<const std::string>& payload,
+        const std::string& type)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_post(configuration, payload, type);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_put_buffers(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::Upload::Buffers& buffers)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_put_buffers(configuration, buffers);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_post_buffers(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::Upload::Buffers& buffers,
+        const std::string& type)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_post_buffers(configuration, buffers, type);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_put(
+        const http::Request::Configuration& configuration,
+        std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback,
+        const http::StreamingClient::Upload::Seeker& seeker,
+        std::size_t size)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_put(configuration, readdata_callback, seeker, size);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_post(
+        const http::Request::Configuration& configuration,
+        std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback,
+        const http::StreamingClient::Upload::Seeker& seeker,
+        std::size_t size)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_post(configuration, readdata_callback, seeker, size);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_post_multipart(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::Multipart::Parts& parts)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_post_multipart(configuration, parts);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+std::shared_ptr<http::StreamingRequest> http::StreamingClient::streaming_get_buffered(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::Buffering::Configuration& buffering)
+{
+    auto *curl_client = dynamic_cast<http::impl::curl::Client*>(this);
+    if (curl_client)
+    {
+        return curl_client->streaming_get_buffered(configuration, buffering);
+    }
+    throw std::runtime_error("bad cast for curl client");
+}
+
+void http::StreamingClient::Delta::write_manifest(std::istream& in, std::ostream& out, const std::string& url, std::size_t block_size)
+{
+    http::impl::ZsyncManifest::write(in, out, url, block_size);
+}
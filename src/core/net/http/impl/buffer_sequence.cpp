@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "buffer_sequence.h"
+
+#include <algorithm>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+impl::BufferSequence::BufferSequence(const http::StreamingClient::Upload::Buffers& buffers)
+    : buffers(buffers)
+{
+    for (const auto& buffer : buffers)
+        total += buffer.size;
+}
+
+std::size_t impl::BufferSequence::size() const
+{
+    return total;
+}
+
+std::size_t impl::BufferSequence::read(char* dest, std::size_t size)
+{
+    std::size_t result{0};
+
+    while (result < size && index < buffers.size())
+    {
+        const auto& buffer = buffers[index];
+        auto n = std::min(size - result, buffer.size - offset);
+
+        std::copy(buffer.data + offset, buffer.data + offset + n, dest + result);
+        result += n;
+        offset += n;
+
+        // Empty buffers are skipped right away.
+        if (offset == buffer.size)
+        {
+            index++;
+            offset = 0;
+        }
+    }
+
+    return result;
+}
+
+bool impl::BufferSequence::seek(std::size_t offset)
+{
+    if (offset > total)
+        return false;
+
+    index = 0;
+
+    // Skips the buffers before offset, including empty ones.
+    while (index < buffers.size() && offset >= buffers[index].size)
+    {
+        offset -= buffers[index].size;
+        index++;
+    }
+
+    this->offset = offset;
+
+    return true;
+}
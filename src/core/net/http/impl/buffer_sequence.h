@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_BUFFER_SEQUENCE_H_
+#define CORE_NET_HTTP_IMPL_BUFFER_SEQUENCE_H_
+
+#include <core/net/http/streaming_client.h>
+
+#include <cstddef>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Hands out a request body gathered from a sequence of buffers, in order,
+// without concatenating them.
+class BufferSequence
+{
+public:
+    BufferSequence(const http::StreamingClient::Upload::Buffers& buffers);
+
+    // Total size of the buffers.
+    std::size_t size() const;
+
+    // Copies up to size bytes following the ones read before to dest, returning
+    // the number of bytes copied, 0 once all of the buffers have been read.
+    std::size_t read(char* dest, std::size_t size);
+
+    // Continues reading at offset, returns false if offset lies beyond the end of the buffers.
+    bool seek(std::size_t offset);
+
+private:
+    http::StreamingClient::Upload::Buffers buffers;
+    std::size_t total{0};
+    // The buffer to read from next, and the bytes of it read already.
+    std::size_t index{0};
+    std::size_t offset{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_BUFFER_SEQUENCE_H_
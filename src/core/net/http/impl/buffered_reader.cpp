@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "buffered_reader.h"
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+namespace
+{
+// Size of the chunks the stream reads at once.
+constexpr const std::size_t stream_chunk_size{16 * 1024};
+}
+
+impl::BufferedReader::StreamBuffer::StreamBuffer(impl::BufferedReader& reader)
+    : reader(reader),
+      chunk(stream_chunk_size)
+{
+}
+
+impl::BufferedReader::StreamBuffer::int_type impl::BufferedReader::StreamBuffer::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    // Errors propagate to the stream, setting its badbit.
+    auto n = reader.read(chunk.data(), chunk.size(), impl::ReceiveBuffer::Waiting::block);
+    if (n == 0)
+        return traits_type::eof();
+
+    setg(chunk.data(), chunk.data(), chunk.data() + n);
+
+    return traits_type::to_int_type(*gptr());
+}
+
+impl::BufferedReader::BufferedReader(const std::shared_ptr<impl::ReceiveBuffer>& buffer, const Configuration& configuration)
+    : buffer(buffer),
+      configuration(configuration),
+      stream_buffer(*this),
+      in(&stream_buffer)
+{
+}
+
+impl::BufferedReader::~BufferedReader()
+{
+    buffer->close();
+}
+
+std::size_t impl::BufferedReader::read(char* data, std::size_t size)
+{
+    return read(data, size, configuration.blocking ? impl::ReceiveBuffer::Waiting::block : impl::ReceiveBuffer::Waiting::poll);
+}
+
+std::istream& impl::BufferedReader::stream()
+{
+    return in;
+}
+
+http::Response impl::BufferedReader::response()
+{
+    return buffer->response();
+}
+
+void impl::BufferedReader::close()
+{
+    closed = true;
+    buffer->close();
+}
+
+std::size_t impl::BufferedReader::read(char* data, std::size_t size, impl::ReceiveBuffer::Waiting waiting)
+{
+    if (closed)
+        throw Errors::Closed{CORE_FROM_HERE()};
+
+    auto result = buffer->read(data, size, waiting);
+
+    // The end of the body, successful or not.
+    if (result == 0 && size > 0)
+        buffer->response();
+
+    return result;
+}
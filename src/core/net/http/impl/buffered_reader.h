@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_BUFFERED_READER_H_
+#define CORE_NET_HTTP_IMPL_BUFFERED_READER_H_
+
+#include <core/net/http/body_reader.h>
+
+#include "receive_buffer.h"
+
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Reads the body that a transfer hands to a receive buffer. Closing the reader,
+// or destroying it, closes the buffer and thus aborts a transfer still running.
+class BufferedReader : public http::BodyReader
+{
+public:
+    BufferedReader(const std::shared_ptr<ReceiveBuffer>& buffer, const Configuration& configuration);
+    ~BufferedReader();
+
+    // From core::net::http::BodyReader
+    std::size_t read(char* data, std::size_t size) override;
+    std::istream& stream() override;
+    http::Response response() override;
+    void close() override;
+
+private:
+    // Reads from the buffer whenever the stream runs out of data.
+    class StreamBuffer : public std::streambuf
+    {
+    public:
+        StreamBuffer(BufferedReader& reader);
+
+    protected:
+        int_type underflow() override;
+
+    private:
+        BufferedReader& reader;
+        std::vector<char> chunk;
+    };
+
+    // Reads up to size bytes to data, rethrowing the error of a failed transfer at the end of the body.
+    std::size_t read(char* data, std::size_t size, ReceiveBuffer::Waiting waiting);
+
+    std::shared_ptr<ReceiveBuffer> buffer;
+    Configuration configuration;
+    bool closed{false};
+
+    StreamBuffer stream_buffer;
+    std::istream in;
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_BUFFERED_READER_H_
@@ -0,0 +1,186 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "byte_ranges.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+namespace
+{
+std::string field(const http::Header& header, const std::string& key)
+{
+    std::string result;
+    auto canonical_key = http::Header::canonicalize_key(key);
+
+    header.enumerate([&result, &canonical_key](const std::string& k, const std::set<std::string>& values)
+    {
+        if (k == canonical_key && not values.empty())
+            result = *values.begin();
+    });
+
+    return result;
+}
+
+std::string lower(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+    return s;
+}
+
+// Returns the boundary parameter of a multipart/byteranges media type, empty for other types.
+std::string boundary_of(const std::string& content_type)
+{
+    static constexpr const char* type{"multipart/byteranges"};
+    static constexpr const char* parameter{"boundary="};
+
+    auto lowered = lower(content_type);
+    if (lowered.compare(0, std::strlen(type), type) != 0)
+        return std::string{};
+
+    auto pos = lowered.find(parameter);
+    if (pos == std::string::npos)
+        return std::string{};
+
+    auto result = content_type.substr(pos + std::strlen(parameter));
+    result = result.substr(0, result.find(';'));
+
+    if (result.size() >= 2 && result.front() == '"' && result.back() == '"')
+        result = result.substr(1, result.size() - 2);
+
+    return result;
+}
+
+// Splits a multipart/byteranges body, see RFC 7233, appendix A. Parts end
+// where their Content-Range says, the delimiter might occur in binary data.
+std::vector<impl::BodyPart> multipart_parts(const std::string& body, const std::string& boundary)
+{
+    std::vector<impl::BodyPart> result;
+
+    auto delimiter = "--" + boundary;
+    auto pos = body.find(delimiter);
+
+    while (pos != std::string::npos)
+    {
+        pos += delimiter.size();
+
+        // The closing delimiter.
+        if (body.compare(pos, 2, "--") == 0)
+            break;
+
+        auto end_of_headers = body.find("\r\n\r\n", pos);
+        if (end_of_headers == std::string::npos)
+            break;
+
+        std::uint64_t first{0}, last{0};
+        bool valid{false};
+
+        auto headers = body.substr(pos, end_of_headers - pos);
+        std::size_t line_start{0};
+
+        while (line_start < headers.size())
+        {
+            auto line_end = headers.find("\r\n", line_start);
+            if (line_end == std::string::npos)
+                line_end = headers.size();
+
+            auto line = headers.substr(line_start, line_end - line_start);
+            auto colon = line.find(':');
+
+            if (colon != std::string::npos && lower(line.substr(0, colon)) == "content-range")
+            {
+                auto value = line.substr(colon + 1);
+                value.erase(0, value.find_first_not_of(" \t"));
+                valid = impl::parse_content_range(value, first, last);
+            }
+
+            line_start = line_end + 2;
+        }
+
+        auto offset = end_of_headers + 4;
+        auto size = last - first + 1;
+
+        if (not valid || offset + size > body.size())
+            break;
+
+        result.push_back(impl::BodyPart{first, offset, static_cast<std::size_t>(size)});
+        pos = body.find(delimiter, offset + size);
+    }
+
+    return result;
+}
+}
+
+bool impl::parse_content_range(const std::string& value, std::uint64_t& first, std::uint64_t& last)
+{
+    std::int64_t complete_length{-1};
+    return parse_content_range(value, first, last, complete_length);
+}
+
+bool impl::parse_content_range(const std::string& value, std::uint64_t& first, std::uint64_t& last, std::int64_t& complete_length)
+{
+    static constexpr const char* unit{"bytes "};
+    if (value.compare(0, std::strlen(unit), unit) != 0)
+        return false;
+
+    char* end{nullptr};
+    first = std::strtoull(value.c_str() + std::strlen(unit), &end, 10);
+    if (*end != '-')
+        return false;
+
+    auto begin = end + 1;
+    last = std::strtoull(begin, &end, 10);
+
+    if (end == begin || *end != '/' || first > last)
+        return false;
+
+    begin = end + 1;
+    if (std::strcmp(begin, "*") == 0)
+    {
+        complete_length = -1;
+        return true;
+    }
+
+    complete_length = std::strtoll(begin, &end, 10);
+
+    return end != begin && *end == '\0' && complete_length > 0 && static_cast<std::uint64_t>(complete_length) > last;
+}
+
+std::vector<impl::BodyPart> impl::body_parts(const http::Response& response)
+{
+    if (response.status == http::Status::ok)
+        return {impl::BodyPart{0, 0, response.body.size()}};
+
+    if (response.status != http::Status::partial_content)
+        return {};
+
+    auto boundary = boundary_of(field(response.header, "Content-Type"));
+    if (not boundary.empty())
+        return multipart_parts(response.body, boundary);
+
+    std::uint64_t first{0}, last{0};
+    if (not parse_content_range(field(response.header, "Content-Range"), first, last))
+        return {};
+
+    auto size = std::min<std::uint64_t>(last - first + 1, response.body.size());
+    return {impl::BodyPart{first, 0, static_cast<std::size_t>(size)}};
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_BYTE_RANGES_H_
+#define CORE_NET_HTTP_IMPL_BYTE_RANGES_H_
+
+#include <core/net/http/response.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// A part of a response body, carrying size bytes of the representation
+// from first on, starting at offset of the body.
+struct BodyPart
+{
+    std::uint64_t first;
+    std::size_t offset;
+    std::size_t size;
+};
+
+// Parses a Content-Range header field value, e.g. "bytes 500-999/1000",
+// see RFC 7233, section 4.2. Returns false if value is not a satisfied byte range.
+bool parse_content_range(const std::string& value, std::uint64_t& first, std::uint64_t& last);
+
+// As above, additionally returning the complete length, negative if given as "*".
+bool parse_content_range(const std::string& value, std::uint64_t& first, std::uint64_t& last, std::int64_t& complete_length);
+
+// Returns the parts of the representation carried by response. That is the
+// complete body for Status::ok, and the ranges given by Content-Range or by a
+// multipart/byteranges body for Status::partial_content. Empty for other responses.
+std::vector<BodyPart> body_parts(const core::net::http::Response& response);
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_BYTE_RANGES_H_
@@ -0,0 +1,568 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <set>
+#include <sstream>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+namespace
+{
+typedef impl::Cache::Clock Clock;
+
+std::string trim(const std::string& s)
+{
+    static constexpr const char* whitespace{" \t"};
+
+    auto begin = s.find_first_not_of(whitespace);
+    if (begin == std::string::npos)
+        return std::string{};
+
+    return s.substr(begin, s.find_last_not_of(whitespace) - begin + 1);
+}
+
+std::string to_lower(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(), [](char c) { return std::tolower(c); });
+    return s;
+}
+
+// Splits a comma-separated header field value into its trimmed, non-empty elements.
+std::vector<std::string> split(const std::string& value)
+{
+    std::vector<std::string> result;
+    std::stringstream ss{value};
+
+    for (std::string element; std::getline(ss, element, ',');)
+    {
+        element = trim(element);
+        if (not element.empty())
+            result.push_back(element);
+    }
+
+    return result;
+}
+
+// Returns all values of field key in header, combined into a comma-separated list.
+std::string field(const http::Header& header, const std::string& key)
+{
+    std::string result;
+    auto canonical_key = http::Header::canonicalize_key(key);
+
+    header.enumerate([&result, &canonical_key](const std::string& k, const std::set<std::string>& values)
+    {
+        if (k != canonical_key)
+            return;
+
+        for (const auto& value : values)
+            result += (result.empty() ? "" : ", ") + value;
+    });
+
+    return result;
+}
+
+// The directives of a Cache-Control header field, keyed by lower-case name.
+class Directives
+{
+public:
+    Directives(const http::Header& header)
+    {
+        for (const auto& element : split(field(header, "Cache-Control")))
+        {
+            auto equals = element.find('=');
+            auto name = to_lower(trim(element.substr(0, equals)));
+            std::string value;
+
+            if (equals != std::string::npos)
+            {
+                value = trim(element.substr(equals + 1));
+                if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+                    value = value.substr(1, value.size() - 2);
+            }
+
+            directives[name] = value;
+        }
+    }
+
+    bool has(const std::string& name) const
+    {
+        return directives.count(name) > 0;
+    }
+
+    // Returns true and adjusts seconds if the directive is present with a valid delta-seconds argument.
+    bool seconds(const std::string& name, Clock::duration& result) const
+    {
+        auto it = directives.find(name);
+        if (it == directives.end() || it->second.empty())
+            return false;
+
+        char* end{nullptr};
+        auto value = std::strtoll(it->second.c_str(), &end, 10);
+        if (*end != '\0' || value < 0)
+            return false;
+
+        result = std::chrono::seconds{value};
+        return true;
+    }
+
+private:
+    std::map<std::string, std::string> directives;
+};
+
+// Parses the three date formats permitted by RFC 7231, section 7.1.1.1.
+bool parse_http_date(const std::string& s, Clock::time_point& result)
+{
+    static const char* formats[] =
+    {
+        "%a, %d %b %Y %H:%M:%S GMT",
+        "%A, %d-%b-%y %H:%M:%S GMT",
+        "%a %b %d %H:%M:%S %Y"
+    };
+
+    for (auto format : formats)
+    {
+        std::tm tm{};
+        auto end = ::strptime(s.c_str(), format, &tm);
+        if (end && *end == '\0')
+        {
+            result = Clock::from_time_t(::timegm(&tm));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool parse_http_date(const http::Header& header, const std::string& key, Clock::time_point& result)
+{
+    auto value = field(header, key);
+    return not value.empty() && parse_http_date(value, result);
+}
+
+// Status codes that are cacheable without explicit freshness information, see RFC 7231, section 6.1.
+bool is_heuristically_cacheable(http::Status status)
+{
+    switch (static_cast<int>(status))
+    {
+    case 200: case 203: case 204: case 300: case 301: case 308:
+    case 404: case 405: case 410: case 414: case 501:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool has_validator(const http::Response& response)
+{
+    return not field(response.header, "ETag").empty() || not field(response.header, "Last-Modified").empty();
+}
+
+bool vary_matches(const impl::CacheEntry& entry, const http::Header& header)
+{
+    for (const auto& pair : entry.vary)
+        if (field(header, pair.first) != pair.second)
+            return false;
+
+    return true;
+}
+}
+
+impl::Cache::Cache(const Configuration& configuration, std::unique_ptr<CacheStore> store)
+    : configuration(configuration),
+      cache_store(std::move(store))
+{
+}
+
+impl::Cache::Lookup impl::Cache::lookup(http::Method method,
+                                        const std::string& uri,
+                                        http::Request::Decoding decoding,
+                                        const http::Header& header)
+{
+    Lookup result;
+    result.request_time = Clock::now();
+    result.key = key_for(uri, decoding);
+
+    if (method != http::Method::get)
+        return result;
+
+    Directives request{header};
+    if (request.has("no-store"))
+        return result;
+
+    auto entry = load(result.key);
+    if (entry && not vary_matches(*entry, header))
+        entry.reset();
+
+    bool only_if_cached = request.has("only-if-cached");
+
+    if (not entry)
+    {
+        ++misses;
+        result.result = only_if_cached ? Lookup::Result::unsatisfiable : Lookup::Result::miss;
+        return result;
+    }
+
+    Directives response{entry->response.header};
+
+    auto lifetime = freshness_lifetime(*entry);
+    auto age = current_age(*entry, result.request_time);
+
+    // Pragma: no-cache is only honored in the absence of Cache-Control.
+    bool no_cache = request.has("no-cache") ||
+            (field(header, "Cache-Control").empty() && to_lower(field(header, "Pragma")).find("no-cache") != std::string::npos);
+
+    bool fresh{false}, refresh{false};
+
+    if (not no_cache)
+    {
+        Clock::duration max_age{}, min_fresh{}, max_stale{}, stale_while_revalidate{};
+        auto entry_lifetime = lifetime;
+
+        if (request.seconds("max-age", max_age))
+            lifetime = std::min(lifetime, max_age);
+        request.seconds("min-fresh", min_fresh);
+
+        fresh = age + min_fresh < lifetime;
+
+        // Revalidate entries that are about to expire ahead of time, if they are in demand.
+        if (fresh && configuration.refresh_ahead > 0.)
+            refresh = entry_lifetime - age < entry_lifetime * configuration.refresh_ahead && is_hot(result.key);
+
+        // The client is willing to accept stale responses, unless the server forbids that.
+        if (not fresh && request.has("max-stale") && not response.has("must-revalidate") && not response.has("no-cache"))
+            fresh = not request.seconds("max-stale", max_stale) || age - lifetime <= max_stale;
+
+        // The server permits serving stale responses while revalidating them, see RFC 5861.
+        if (not fresh && not response.has("must-revalidate") && not response.has("no-cache") &&
+            response.seconds("stale-while-revalidate", stale_while_revalidate) &&
+            age - entry_lifetime <= stale_while_revalidate)
+            fresh = refresh = true;
+    }
+
+    result.entry = entry;
+
+    auto etag = field(entry->response.header, "ETag");
+    auto last_modified = field(entry->response.header, "Last-Modified");
+
+    if (not etag.empty())
+        result.conditional.add("If-None-Match", etag);
+    if (not last_modified.empty())
+        result.conditional.add("If-Modified-Since", last_modified);
+
+    if (fresh)
+    {
+        ++hits;
+        result.result = Lookup::Result::fresh;
+        result.refresh = refresh;
+        return result;
+    }
+
+    if (only_if_cached || (etag.empty() && last_modified.empty()))
+    {
+        ++misses;
+        result.entry.reset();
+        result.conditional = http::Header{};
+        result.result = only_if_cached ? Lookup::Result::unsatisfiable : Lookup::Result::miss;
+        return result;
+    }
+
+    ++revalidations;
+    result.result = Lookup::Result::stale;
+
+    return result;
+}
+
+http::Response impl::Cache::serve(const Lookup& lookup) const
+{
+    auto response = lookup.entry->response;
+
+    auto age = std::chrono::duration_cast<std::chrono::seconds>(current_age(*lookup.entry, Clock::now()));
+    response.header.set("Age", std::to_string(std::max<long long>(age.count(), 0)));
+
+    return response;
+}
+
+http::Response impl::Cache::update(http::Method method,
+                                   const std::string& uri,
+                                   const http::Header& header,
+                                   const Lookup& lookup,
+                                   const http::Response& response,
+                                   bool& served_from_cache)
+{
+    served_from_cache = false;
+
+    auto status = static_cast<int>(response.status);
+    auto response_time = Clock::now();
+
+    // Successful unsafe requests invalidate the cached responses for the uri.
+    if (method == http::Method::post || method == http::Method::put || method == http::Method::del)
+    {
+        if (status >= 200 && status < 400)
+        {
+            drop(key_for(uri, http::Request::Decoding::enabled));
+            drop(key_for(uri, http::Request::Decoding::disabled));
+        }
+
+        return response;
+    }
+
+    switch (lookup.result)
+    {
+    case Lookup::Result::bypass:
+    case Lookup::Result::fresh:
+    case Lookup::Result::unsatisfiable:
+        return response;
+    case Lookup::Result::stale:
+        if (response.status == http::Status::not_modified)
+        {
+            ++not_modified;
+
+            // Refresh the stored header fields with the ones sent along with the 304, see RFC 7234, section 4.3.4.
+            auto refreshed = std::make_shared<CacheEntry>(*lookup.entry);
+            response.header.enumerate([&refreshed](const std::string& key, const std::set<std::string>& values)
+            {
+                if (key == "Content-Length")
+                    return;
+
+                refreshed->response.header.remove(key);
+                for (const auto& value : values)
+                    refreshed->response.header.add(key, value);
+            });
+
+            refreshed->request_time = lookup.request_time;
+            refreshed->response_time = response_time;
+
+            if (Directives{refreshed->response.header}.has("no-store"))
+                drop(lookup.key);
+            else
+                save(lookup.key, refreshed);
+
+            served_from_cache = true;
+
+            Lookup revalidated{lookup};
+            revalidated.entry = refreshed;
+
+            return serve(revalidated);
+        }
+        break;
+    case Lookup::Result::miss:
+        break;
+    }
+
+    store(lookup.key, header, response, lookup.request_time, response_time);
+
+    return response;
+}
+
+bool impl::Cache::begin_refresh(const std::string& key)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (not refreshing.insert(key).second)
+        return false;
+
+    ++refreshes;
+    return true;
+}
+
+void impl::Cache::end_refresh(const std::string& key)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    refreshing.erase(key);
+    // The refreshed entry has to earn its hits again.
+    hot.erase(key);
+}
+
+void impl::Cache::fill(http::Client::Metrics& metrics)
+{
+    metrics.cache.hits = hits.load();
+    metrics.cache.misses = misses.load();
+    metrics.cache.revalidations = revalidations.load();
+    metrics.cache.not_modified = not_modified.load();
+    metrics.cache.refreshes = refreshes.load();
+    metrics.cache.failures = failures.load();
+
+    try
+    {
+        cache_store->fill(metrics);
+    } catch(const std::exception&)
+    {
+        ++failures;
+    }
+}
+
+std::shared_ptr<const impl::CacheEntry> impl::Cache::load(const std::string& key)
+{
+    try
+    {
+        return cache_store->lookup(key);
+    } catch(const std::exception&)
+    {
+        ++failures;
+        return std::shared_ptr<const CacheEntry>{};
+    }
+}
+
+void impl::Cache::save(const std::string& key, const std::shared_ptr<const CacheEntry>& entry)
+{
+    try
+    {
+        cache_store->store(key, entry);
+    } catch(const std::exception&)
+    {
+        ++failures;
+    }
+}
+
+void impl::Cache::drop(const std::string& key)
+{
+    try
+    {
+        cache_store->erase(key);
+    } catch(const std::exception&)
+    {
+        ++failures;
+    }
+}
+
+bool impl::Cache::is_hot(const std::string& key)
+{
+    // Bounds the bookkeeping, hot entries quickly make it back in.
+    static constexpr const std::size_t max_tracked{4096};
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (hot.size() >= max_tracked && hot.count(key) == 0)
+        hot.clear();
+
+    return ++hot[key] >= configuration.refresh_ahead_min_hits;
+}
+
+std::string impl::Cache::key_for(const std::string& uri, http::Request::Decoding decoding)
+{
+    // Uris do not contain spaces, the suffix cannot clash with another uri.
+    return decoding == http::Request::Decoding::enabled ? uri + " decoded" : uri;
+}
+
+impl::Cache::Clock::duration impl::Cache::freshness_lifetime(const CacheEntry& entry) const
+{
+    const auto& header = entry.response.header;
+    Directives directives{header};
+
+    if (directives.has("no-cache"))
+        return Clock::duration::zero();
+
+    // A private cache ignores s-maxage.
+    Clock::duration max_age{};
+    if (directives.seconds("max-age", max_age))
+        return max_age;
+
+    Clock::time_point date{entry.response_time};
+    parse_http_date(header, "Date", date);
+
+    auto expires_value = field(header, "Expires");
+    if (not expires_value.empty())
+    {
+        Clock::time_point expires;
+        // Invalid dates, e.g. "0", represent a time in the past.
+        if (not parse_http_date(expires_value, expires))
+            return Clock::duration::zero();
+
+        return std::max(expires - date, Clock::duration::zero());
+    }
+
+    Clock::time_point last_modified;
+    if (is_heuristically_cacheable(entry.response.status) && parse_http_date(header, "Last-Modified", last_modified))
+        return std::min<Clock::duration>(std::max(date - last_modified, Clock::duration::zero()) / 10,
+                                         configuration.max_heuristic_freshness);
+
+    return Clock::duration::zero();
+}
+
+impl::Cache::Clock::duration impl::Cache::current_age(const CacheEntry& entry, Clock::time_point now)
+{
+    // See RFC 7234, section 4.2.3.
+    Clock::time_point date{entry.response_time};
+    parse_http_date(entry.response.header, "Date", date);
+
+    auto apparent_age = std::max(entry.response_time - date, Clock::duration::zero());
+
+    Clock::duration age_value{};
+    auto age = field(entry.response.header, "Age");
+    if (not age.empty())
+        age_value = std::chrono::seconds{std::strtoll(age.c_str(), nullptr, 10)};
+
+    auto response_delay = entry.response_time - entry.request_time;
+    auto corrected_initial_age = std::max(apparent_age, age_value + response_delay);
+    auto resident_time = now - entry.response_time;
+
+    return corrected_initial_age + resident_time;
+}
+
+void impl::Cache::store(const std::string& key,
+                        const http::Header& header,
+                        const http::Response& response,
+                        Clock::time_point request_time,
+                        Clock::time_point response_time)
+{
+    Directives request{header}, directives{response.header};
+
+    auto vary = split(field(response.header, "Vary"));
+
+    bool storable = response.status != http::Status::partial_content &&
+            not request.has("no-store") &&
+            not directives.has("no-store") &&
+            std::find(vary.begin(), vary.end(), "*") == vary.end() &&
+            response.body.size() <= configuration.max_entry_size &&
+            (is_heuristically_cacheable(response.status) ||
+             directives.has("max-age") ||
+             not field(response.header, "Expires").empty());
+
+    if (not storable)
+    {
+        drop(key);
+        return;
+    }
+
+    auto entry = std::make_shared<CacheEntry>();
+    entry->response = response;
+    entry->request_time = request_time;
+    entry->response_time = response_time;
+
+    for (const auto& name : vary)
+    {
+        auto key = http::Header::canonicalize_key(name);
+        entry->vary.push_back(std::make_pair(key, field(header, key)));
+    }
+
+    // Neither fresh nor revalidatable, keeping the response would not help anybody.
+    if (freshness_lifetime(*entry) <= Clock::duration::zero() && not has_validator(response))
+    {
+        drop(key);
+        return;
+    }
+
+    save(key, entry);
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_CACHE_H_
+#define CORE_NET_HTTP_IMPL_CACHE_H_
+
+#include <core/net/http/client.h>
+#include <core/net/http/method.h>
+#include <core/net/http/response.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// A response as kept in the cache, together with the bookkeeping
+// needed for computing its age.
+struct CacheEntry
+{
+    typedef std::chrono::system_clock Clock;
+
+    http::Response response;
+    // When the request resulting in response was issued.
+    Clock::time_point request_time;
+    // When response was received.
+    Clock::time_point response_time;
+    // The request header fields named by the Vary field of response, with their values.
+    std::vector<std::pair<std::string, std::string>> vary;
+};
+
+// Keeps cache entries, keyed by uri and decoding. Implementations have to be thread-safe,
+// and may throw std::system_error if the underlying storage fails.
+class CacheStore
+{
+public:
+    virtual ~CacheStore() = default;
+
+    // Returns the entry stored for key or an empty pointer.
+    virtual std::shared_ptr<const CacheEntry> lookup(const std::string& key) = 0;
+
+    // Stores entry for key, replacing any previous entry.
+    virtual void store(const std::string& key, const std::shared_ptr<const CacheEntry>& entry) = 0;
+
+    // Removes the entry for key, if any.
+    virtual void erase(const std::string& key) = 0;
+
+    // Fills in the number of entries and the accumulated size.
+    virtual void fill(http::Client::Metrics& metrics) = 0;
+};
+
+// Implements the caching rules of RFC 7234 for a private cache on top of a store.
+// All methods are thread-safe. Failures of the store are counted, never thrown, caching
+// is best-effort and must not fail requests whose transfer succeeded.
+class Cache
+{
+public:
+    typedef http::Client::Cache::Configuration Configuration;
+    typedef CacheEntry::Clock Clock;
+
+    // Describes how a request is served with respect to the cache.
+    struct Lookup
+    {
+        enum class Result
+        {
+            // The cache is neither consulted nor updated for the request.
+            bypass,
+            // No usable response is cached, the request is issued as is.
+            miss,
+            // The cached response is served without contacting the server.
+            fresh,
+            // The cached response is stale and is revalidated with the conditional header fields.
+            stale,
+            // The request asked for cached responses only and none is usable.
+            unsatisfiable
+        };
+
+        Result result{Result::bypass};
+        // The key of the entry serving the request, telling apart decoded and encoded bodies.
+        std::string key;
+        // The cached entry for fresh and stale results.
+        std::shared_ptr<const CacheEntry> entry;
+        // Header fields to add to the request for revalidating a stale entry.
+        http::Header conditional;
+        // When the lookup happened, i.e., when the request was issued.
+        Clock::time_point request_time;
+        // Set for fresh results if the entry should be revalidated in the background.
+        bool refresh{false};
+    };
+
+    Cache(const Configuration& configuration, std::unique_ptr<CacheStore> store);
+
+    // Looks up the cached response for a request. Responses decoded and
+    // left encoded are kept apart, decoding has to be resolved against the client default.
+    Lookup lookup(http::Method method,
+                  const std::string& uri,
+                  http::Request::Decoding decoding,
+                  const http::Header& header);
+
+    // Returns the cached response of a fresh lookup, as handed out to the caller.
+    http::Response serve(const Lookup& lookup) const;
+
+    // Updates the cache with the response received for a request and returns
+    // the response to be handed out. For a revalidated entry, that is the cached
+    // response, in which case served_from_cache is set to true.
+    http::Response update(http::Method method,
+                          const std::string& uri,
+                          const http::Header& header,
+                          const Lookup& lookup,
+                          const http::Response& response,
+                          bool& served_from_cache);
+
+    // Marks a background revalidation of the entry for key as started, returns
+    // false if one is in progress already. Every successful call has to be
+    // followed by a call to end_refresh.
+    bool begin_refresh(const std::string& key);
+
+    // Marks the background revalidation of the entry for key as finished.
+    void end_refresh(const std::string& key);
+
+    // Fills in the cache figures.
+    void fill(http::Client::Metrics& metrics);
+
+private:
+    // Returns the key of the entry for uri with the given decoding.
+    static std::string key_for(const std::string& uri, http::Request::Decoding decoding);
+    // Returns the freshness lifetime of entry.
+    Clock::duration freshness_lifetime(const CacheEntry& entry) const;
+    // Returns the current age of entry.
+    static Clock::duration current_age(const CacheEntry& entry, Clock::time_point now);
+    // Stores response if permitted, replacing any previous entry for key.
+    void store(const std::string& key, const http::Header& header, const http::Response& response,
+               Clock::time_point request_time, Clock::time_point response_time);
+
+    // Access the store, counting its failures. A failed lookup finds nothing.
+    std::shared_ptr<const CacheEntry> load(const std::string& key);
+    void save(const std::string& key, const std::shared_ptr<const CacheEntry>& entry);
+    void drop(const std::string& key);
+
+    // Returns true if the entry for key is requested often enough to be refreshed ahead.
+    bool is_hot(const std::string& key);
+
+    Configuration configuration;
+    std::unique_ptr<CacheStore> cache_store;
+
+    std::mutex guard;
+    // Hits per key since the entry was last refreshed.
+    std::unordered_map<std::string, std::uint32_t> hot;
+    // Keys with a background revalidation in progress.
+    std::set<std::string> refreshing;
+
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> revalidations{0};
+    std::atomic<std::uint64_t> not_modified{0};
+    std::atomic<std::uint64_t> refreshes{0};
+    std::atomic<std::uint64_t> failures{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_CACHE_H_
@@ -0,0 +1,212 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "circuit_breaker.h"
+
+#include <algorithm>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+constexpr const std::size_t impl::CircuitBreaker::bucket_count;
+
+impl::CircuitBreaker::CircuitBreaker(const std::string& host, const Configuration& configuration)
+    : host(host),
+      configuration(configuration)
+{
+}
+
+bool impl::CircuitBreaker::try_admit(Generation& admitted_in)
+{
+    auto now = Clock::now();
+    State from{State::closed};
+    bool state_changed{false};
+    bool result{false};
+
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        if (state == State::open && now - opened_at >= configuration.open_interval)
+        {
+            from = transition_to(State::half_open, now);
+            state_changed = true;
+        }
+
+        switch (state)
+        {
+        case State::closed:
+            result = true;
+            break;
+        case State::open:
+            result = false;
+            break;
+        case State::half_open:
+            result = probes_in_flight < std::max<std::uint32_t>(configuration.half_open_probes, 1);
+            if (result)
+                ++probes_in_flight;
+            break;
+        }
+
+        if (result)
+            admitted_in = generation;
+        else
+            ++rejected;
+    }
+
+    if (state_changed)
+        notify(from, State::half_open);
+
+    return result;
+}
+
+void impl::CircuitBreaker::report(Generation admitted_in, bool failed)
+{
+    auto now = Clock::now();
+    State from{State::closed}, to{State::closed};
+    bool state_changed{false};
+
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        if (failed)
+            ++failures;
+
+        // The circuit changed its state since the request was admitted,
+        // the outcome does not tell us anything about the current state.
+        if (admitted_in != generation)
+            return;
+
+        switch (state)
+        {
+        case State::closed:
+        {
+            auto& bucket = bucket_for(now);
+            if (failed)
+            {
+                ++bucket.failures;
+                ++consecutive_failures;
+            } else
+            {
+                ++bucket.successes;
+                consecutive_failures = 0;
+            }
+
+            std::uint32_t total{0}, failed_in_window{0};
+            for (const auto& b : buckets)
+            {
+                if (now - b.start >= configuration.window)
+                    continue;
+                total += b.successes + b.failures;
+                failed_in_window += b.failures;
+            }
+
+            bool trip = consecutive_failures >= configuration.consecutive_failures;
+            trip = trip || (total >= configuration.minimum_requests &&
+                            total > 0 &&
+                            failed_in_window >= configuration.error_rate * total);
+
+            if (trip)
+            {
+                to = State::open;
+                from = transition_to(to, now);
+                state_changed = true;
+            }
+            break;
+        }
+        case State::half_open:
+            if (probes_in_flight > 0)
+                --probes_in_flight;
+
+            if (failed)
+            {
+                to = State::open;
+                from = transition_to(to, now);
+                state_changed = true;
+            } else if (++probe_successes >= std::max<std::uint32_t>(configuration.half_open_probes, 1))
+            {
+                to = State::closed;
+                from = transition_to(to, now);
+                state_changed = true;
+            }
+            break;
+        case State::open:
+            break;
+        }
+    }
+
+    if (state_changed)
+        notify(from, to);
+}
+
+void impl::CircuitBreaker::fill(http::Client::Metrics::Host& metrics)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    metrics.circuit_breaker.state = state;
+    metrics.circuit_breaker.failures = failures;
+    metrics.circuit_breaker.rejected = rejected;
+}
+
+impl::CircuitBreaker::State impl::CircuitBreaker::transition_to(State to, Clock::time_point now)
+{
+    auto from = state;
+
+    state = to;
+    ++generation;
+
+    consecutive_failures = 0;
+    probes_in_flight = 0;
+    probe_successes = 0;
+    buckets.fill(Bucket{});
+
+    if (to == State::open)
+        opened_at = now;
+
+    return from;
+}
+
+impl::CircuitBreaker::Bucket& impl::CircuitBreaker::bucket_for(Clock::time_point now)
+{
+    auto width = std::chrono::duration_cast<Clock::duration>(configuration.window) / bucket_count;
+    if (width.count() <= 0)
+        width = Clock::duration{1};
+
+    auto slot = now.time_since_epoch() / width;
+    auto& bucket = buckets[slot % bucket_count];
+    auto start = Clock::time_point{slot * width};
+
+    if (bucket.start != start)
+    {
+        bucket = Bucket{};
+        bucket.start = start;
+    }
+
+    return bucket;
+}
+
+void impl::CircuitBreaker::notify(State from, State to)
+{
+    if (!configuration.on_state_change)
+        return;
+
+    try
+    {
+        configuration.on_state_change(host, from, to);
+    } catch(...)
+    {
+        // Just ignoring errors here.
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_CIRCUIT_BREAKER_H_
+#define CORE_NET_HTTP_IMPL_CIRCUIT_BREAKER_H_
+
+#include <core/net/http/client.h>
+
+#include <array>
+#include <chrono>
+#include <mutex>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Tracks the outcome of requests against a single host and decides
+// whether further requests are admitted. All methods are thread-safe.
+class CircuitBreaker
+{
+public:
+    typedef http::Client::CircuitBreaker::State State;
+    typedef http::Client::CircuitBreaker::Configuration Configuration;
+    typedef std::chrono::steady_clock Clock;
+
+    // Every state change starts a new generation. Outcomes reported
+    // for requests admitted in an earlier generation are ignored.
+    typedef std::uint64_t Generation;
+
+    CircuitBreaker(const std::string& host, const Configuration& configuration);
+
+    // Returns false if the request should fail immediately. Otherwise,
+    // generation is adjusted and has to be handed back to report.
+    bool try_admit(Generation& generation);
+
+    // Reports the outcome of a request admitted in generation.
+    void report(Generation generation, bool failed);
+
+    // Fills in the circuit breaker figures of the given host metrics.
+    void fill(http::Client::Metrics::Host& metrics);
+
+private:
+    // Number of buckets the sliding window is divided into.
+    static constexpr const std::size_t bucket_count{10};
+
+    struct Bucket
+    {
+        Clock::time_point start{};
+        std::uint32_t successes{0};
+        std::uint32_t failures{0};
+    };
+
+    // Moves to state 'to', returning the previous state. Requires guard to be held.
+    State transition_to(State to, Clock::time_point now);
+    // Returns the bucket covering now, recycling stale ones. Requires guard to be held.
+    Bucket& bucket_for(Clock::time_point now);
+    // Notifies the state change handler. Must be called without holding guard.
+    void notify(State from, State to);
+
+    std::string host;
+    Configuration configuration;
+
+    std::mutex guard;
+    State state{State::closed};
+    Generation generation{0};
+    Clock::time_point opened_at{};
+    std::array<Bucket, bucket_count> buckets{};
+    std::uint32_t consecutive_failures{0};
+    std::uint32_t probes_in_flight{0};
+    std::uint32_t probe_successes{0};
+    std::uint64_t failures{0};
+    std::uint64_t rejected{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_CIRCUIT_BREAKER_H_
@@ -0,0 +1,161 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "coalescer.h"
+
+#include <set>
+#include <sstream>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+http::Response impl::Coalescer::Flight::wait()
+{
+    std::unique_lock<std::mutex> ul(guard);
+    done_changed.wait(ul, [this]() { return done; });
+
+    if (error)
+        std::rethrow_exception(error);
+
+    return response;
+}
+
+void impl::Coalescer::Flight::on_complete(const std::function<void(const http::Response&, const std::exception_ptr&)>& f)
+{
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        if (not done)
+        {
+            continuations.push_back(f);
+            return;
+        }
+    }
+
+    // Response and error are not touched anymore once done is set.
+    f(response, error);
+}
+
+impl::Coalescer::Coalescer(const Configuration& configuration)
+    : configuration(configuration)
+{
+}
+
+std::string impl::Coalescer::key_for(http::Method method, const http::Request::Configuration& configuration) const
+{
+    if (method != http::Method::get && method != http::Method::head)
+        return std::string{};
+
+    // Partial responses only answer the request asking for the range.
+    if (configuration.header.has("Range") || configuration.header.has("If-Range"))
+        return std::string{};
+
+    // Decoded and encoded bodies of the same resource differ, as do their lengths.
+    std::string decoding{configuration.decoding == http::Request::Decoding::enabled ? " decoded" : " encoded"};
+
+    if (this->configuration.key)
+    {
+        auto key = this->configuration.key(method, configuration);
+        return key.empty() ? key : key + decoding;
+    }
+
+    // Credentials are not known before the request executes, there is no
+    // telling whether two requests would authenticate as the same user.
+    if (configuration.authentication_handler.for_http)
+        return std::string{};
+
+    std::stringstream ss;
+    ss << (method == http::Method::get ? "GET" : "HEAD") << ' ' << configuration.uri
+       << ' ' << configuration.ssl.verify_peer << configuration.ssl.verify_host << decoding;
+
+    std::set<std::string> key_headers;
+    for (const auto& key : this->configuration.key_headers)
+        key_headers.insert(http::Header::canonicalize_key(key));
+
+    configuration.header.enumerate([&ss, &key_headers](const std::string& key, const std::set<std::string>& values)
+    {
+        if (key_headers.count(key) == 0)
+            return;
+
+        ss << '\n' << key << ':';
+        for (const auto& value : values)
+            ss << ' ' << value;
+    });
+
+    return ss.str();
+}
+
+std::shared_ptr<impl::Coalescer::Flight> impl::Coalescer::join(const std::string& key, bool& leader)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = flights.find(key);
+    if (it != flights.end())
+    {
+        leader = false;
+        ++deduplicated;
+        return it->second;
+    }
+
+    leader = true;
+    auto flight = std::make_shared<Flight>();
+    flights.insert(std::make_pair(key, flight));
+
+    return flight;
+}
+
+void impl::Coalescer::complete(const std::string& key,
+                               const std::shared_ptr<Flight>& flight,
+                               const http::Response& response,
+                               const std::exception_ptr& error)
+{
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        // Requests arriving from now on start a new flight.
+        auto it = flights.find(key);
+        if (it != flights.end() && it->second == flight)
+            flights.erase(it);
+    }
+
+    decltype(flight->continuations) continuations;
+
+    {
+        std::lock_guard<std::mutex> lg(flight->guard);
+        flight->response = response;
+        flight->error = error;
+        flight->done = true;
+        continuations.swap(flight->continuations);
+    }
+
+    flight->done_changed.notify_all();
+
+    for (const auto& continuation : continuations)
+    {
+        try
+        {
+            continuation(flight->response, flight->error);
+        } catch(...)
+        {
+            // Just ignoring errors here.
+        }
+    }
+}
+
+void impl::Coalescer::fill(http::Client::Metrics& metrics)
+{
+    std::lock_guard<std::mutex> lg(guard);
+    metrics.coalescing.deduplicated = deduplicated;
+}
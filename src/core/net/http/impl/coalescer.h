@@ -0,0 +1,101 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_COALESCER_H_
+#define CORE_NET_HTTP_IMPL_COALESCER_H_
+
+#include <core/net/http/client.h>
+#include <core/net/http/response.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Lets identical requests in flight share a single transfer. The first request
+// for a key becomes the leader and executes, all others joining while it is in
+// flight wait for its outcome. All methods are thread-safe.
+class Coalescer
+{
+public:
+    typedef http::Client::Coalescing::Configuration Configuration;
+
+    // The shared transfer for a single key.
+    class Flight
+    {
+    public:
+        // Blocks until the leader finished, returning a copy of the response
+        // or rethrowing the error the leader failed with.
+        http::Response wait();
+
+        // Invokes f with the outcome once the leader finished, right away if it already has.
+        // Exactly one of response and error is valid when f is invoked.
+        void on_complete(const std::function<void(const http::Response& response, const std::exception_ptr& error)>& f);
+
+    private:
+        friend class Coalescer;
+
+        std::mutex guard;
+        std::condition_variable done_changed;
+        bool done{false};
+        http::Response response;
+        std::exception_ptr error;
+        std::vector<std::function<void(const http::Response&, const std::exception_ptr&)>> continuations;
+    };
+
+    Coalescer(const Configuration& configuration);
+
+    // Returns the coalescing key for a request, empty if the request must not be coalesced.
+    // The decoding of configuration is expected to be resolved against the client default.
+    std::string key_for(http::Method method, const http::Request::Configuration& configuration) const;
+
+    // Joins the flight for key, starting a new one if none is in flight.
+    // leader is set to true if the caller started the flight and has to complete it.
+    std::shared_ptr<Flight> join(const std::string& key, bool& leader);
+
+    // Completes the flight for key on behalf of its leader, handing out response
+    // or error to all requests that joined it.
+    void complete(const std::string& key,
+                  const std::shared_ptr<Flight>& flight,
+                  const http::Response& response,
+                  const std::exception_ptr& error = std::exception_ptr{});
+
+    // Fills in the coalescing figures.
+    void fill(http::Client::Metrics& metrics);
+
+private:
+    Configuration configuration;
+
+    std::mutex guard;
+    std::map<std::string, std::shared_ptr<Flight>> flights;
+    std::uint64_t deduplicated{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_COALESCER_H_
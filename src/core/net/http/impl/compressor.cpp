@@ -0,0 +1,202 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "compressor.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include <zlib.h>
+
+#if defined(CORE_NET_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+namespace
+{
+// Input is pulled in from the source in chunks of this size.
+constexpr const std::size_t input_chunk_size{64 * 1024};
+
+class GzipCompressor : public impl::Compressor
+{
+public:
+    GzipCompressor() : input(input_chunk_size)
+    {
+        std::memset(&stream, 0, sizeof(stream));
+
+        // 16 added to the window bits selects the gzip format.
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            throw std::runtime_error("Could not initialize gzip compression");
+    }
+
+    ~GzipCompressor()
+    {
+        deflateEnd(&stream);
+    }
+
+    std::string encoding() const override
+    {
+        return "gzip";
+    }
+
+    std::size_t read(char* dest, std::size_t size, const Source& source) override
+    {
+        stream.next_out = reinterpret_cast<Bytef*>(dest);
+        stream.avail_out = size;
+
+        while (stream.avail_out > 0 && not finished)
+        {
+            if (stream.avail_in == 0 && not input_done)
+            {
+                auto count = source(input.data(), input.size());
+
+                // Hand out what is there already, the condition is raised again on the next call.
+                if (count > input.size())
+                    return stream.avail_out < size ? size - stream.avail_out : count;
+
+                input_done = count == 0;
+                stream.next_in = reinterpret_cast<Bytef*>(input.data());
+                stream.avail_in = count;
+            }
+
+            auto result = deflate(&stream, input_done ? Z_FINISH : Z_NO_FLUSH);
+
+            if (result == Z_STREAM_END)
+                finished = true;
+            else if (result != Z_OK && result != Z_BUF_ERROR)
+                throw std::runtime_error("Could not gzip-compress request body");
+        }
+
+        return size - stream.avail_out;
+    }
+
+private:
+    z_stream stream;
+    std::vector<char> input;
+    bool input_done{false};
+    bool finished{false};
+};
+
+#if defined(CORE_NET_HAVE_ZSTD)
+class ZstdCompressor : public impl::Compressor
+{
+public:
+    ZstdCompressor() : context(ZSTD_createCCtx()), input(input_chunk_size)
+    {
+        if (not context)
+            throw std::runtime_error("Could not initialize zstd compression");
+
+        in.src = input.data();
+        in.size = 0;
+        in.pos = 0;
+    }
+
+    ~ZstdCompressor()
+    {
+        ZSTD_freeCCtx(context);
+    }
+
+    std::string encoding() const override
+    {
+        return "zstd";
+    }
+
+    std::size_t read(char* dest, std::size_t size, const Source& source) override
+    {
+        ZSTD_outBuffer out{dest, size, 0};
+
+        while (out.pos < out.size && not finished)
+        {
+            if (in.pos == in.size && not input_done)
+            {
+                auto count = source(input.data(), input.size());
+
+                // Hand out what is there already, the condition is raised again on the next call.
+                if (count > input.size())
+                    return out.pos > 0 ? out.pos : count;
+
+                input_done = count == 0;
+                in.size = count;
+                in.pos = 0;
+            }
+
+            auto remaining = ZSTD_compressStream2(context, &out, &in, input_done ? ZSTD_e_end : ZSTD_e_continue);
+
+            if (ZSTD_isError(remaining))
+                throw std::runtime_error(std::string{"Could not zstd-compress request body: "} + ZSTD_getErrorName(remaining));
+
+            finished = input_done && remaining == 0;
+        }
+
+        return out.pos;
+    }
+
+private:
+    ZSTD_CCtx* context;
+    std::vector<char> input;
+    ZSTD_inBuffer in;
+    bool input_done{false};
+    bool finished{false};
+};
+#endif
+}
+
+std::shared_ptr<impl::Compressor> impl::Compressor::for_body(const http::Request::Configuration& configuration, std::size_t size)
+{
+    if (size < configuration.compression.min_size)
+        return std::shared_ptr<Compressor>{};
+
+    switch (configuration.compression.algorithm)
+    {
+    case http::Request::Compression::none:
+        break;
+    case http::Request::Compression::gzip:
+        return std::make_shared<GzipCompressor>();
+    case http::Request::Compression::zstd:
+#if defined(CORE_NET_HAVE_ZSTD)
+        return std::make_shared<ZstdCompressor>();
+#else
+        throw std::runtime_error("zstd compression is not supported by this build of net-cpp");
+#endif
+    }
+
+    return std::shared_ptr<Compressor>{};
+}
+
+std::string impl::Compressor::compress(const std::string& body)
+{
+    std::size_t offset{0};
+    auto source = [&body, &offset](char* buffer, std::size_t size)
+    {
+        auto count = std::min(size, body.size() - offset);
+        std::memcpy(buffer, body.data() + offset, count);
+        offset += count;
+        return count;
+    };
+
+    std::string result;
+    std::vector<char> chunk(input_chunk_size);
+
+    for (auto count = read(chunk.data(), chunk.size(), source); count > 0; count = read(chunk.data(), chunk.size(), source))
+        result.append(chunk.data(), count);
+
+    return result;
+}
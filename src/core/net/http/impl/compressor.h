@@ -0,0 +1,65 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_COMPRESSOR_H_
+#define CORE_NET_HTTP_IMPL_COMPRESSOR_H_
+
+#include <core/net/http/request.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Compresses a request body on the fly, as it is pulled in by the transfer.
+class Compressor
+{
+public:
+    // Fills buffer with up to size bytes of the uncompressed body, returning the
+    // number of bytes filled in or 0 at the end of the body. Returning a value
+    // larger than size signals a condition, e.g., pausing or aborting the transfer,
+    // that is passed on to the caller of read.
+    typedef std::function<std::size_t(char* buffer, std::size_t size)> Source;
+
+    // Returns a compressor for a body of size bytes according to configuration,
+    // or an empty pointer if the body is to be sent as is.
+    // Throws std::runtime_error if the requested algorithm is not supported.
+    static std::shared_ptr<Compressor> for_body(const http::Request::Configuration& configuration, std::size_t size);
+
+    virtual ~Compressor() = default;
+
+    // Returns the value of the Content-Encoding header field for the compressed body.
+    virtual std::string encoding() const = 0;
+
+    // Fills dest with up to size bytes of the compressed body, pulling in the
+    // uncompressed body from source as needed. Returns 0 at the end of the body.
+    virtual std::size_t read(char* dest, std::size_t size, const Source& source) = 0;
+
+    // Compresses body in one go.
+    std::string compress(const std::string& body);
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_COMPRESSOR_H_
@@ -0,0 +1,126 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "concurrency_limiter.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+impl::ConcurrencyLimiter::ConcurrencyLimiter(const Configuration& configuration)
+    : configuration(configuration),
+      limit(std::max(configuration.min_limit, std::min(configuration.initial_limit, configuration.max_limit)))
+{
+}
+
+void impl::ConcurrencyLimiter::acquire()
+{
+    std::unique_lock<std::mutex> ul(guard);
+
+    ++blocked;
+    // Queued asynchronous requests have been waiting longer, they go first.
+    slot_released.wait(ul, [this]() { return queue.empty() && in_flight < effective_limit(); });
+    --blocked;
+
+    ++in_flight;
+}
+
+bool impl::ConcurrencyLimiter::acquire_or_enqueue(const std::function<void()>& on_acquired)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (queue.empty() && in_flight < effective_limit())
+    {
+        ++in_flight;
+        return true;
+    }
+
+    queue.push_back(on_acquired);
+    return false;
+}
+
+void impl::ConcurrencyLimiter::release(const Seconds& latency, bool failed)
+{
+    std::vector<std::function<void()>> ready;
+
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        update(latency, failed);
+
+        if (in_flight > 0)
+            --in_flight;
+
+        while (not queue.empty() && in_flight < effective_limit())
+        {
+            ++in_flight;
+            ready.push_back(queue.front());
+            queue.pop_front();
+        }
+
+        if (blocked > 0)
+            slot_released.notify_all();
+    }
+
+    for (const auto& on_acquired : ready)
+        on_acquired();
+}
+
+void impl::ConcurrencyLimiter::fill(http::Client::Metrics::Host& metrics)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    metrics.concurrency.limit = effective_limit();
+    metrics.concurrency.in_flight = in_flight;
+    metrics.concurrency.queued = queue.size() + blocked;
+}
+
+std::uint32_t impl::ConcurrencyLimiter::effective_limit() const
+{
+    return std::max<std::uint32_t>(1, static_cast<std::uint32_t>(limit));
+}
+
+void impl::ConcurrencyLimiter::update(const Seconds& latency, bool failed)
+{
+    if (failed)
+    {
+        limit = std::max<double>(configuration.min_limit, limit * configuration.backoff_ratio);
+        return;
+    }
+
+    // Track the baseline as the minimum latency over the previous and the
+    // current window, so that it can recover from a permanently slower upstream.
+    window_min = std::min(window_min, latency);
+    baseline = std::min(baseline, latency);
+
+    if (++samples_in_window >= std::max<std::uint32_t>(configuration.baseline_window, 1))
+    {
+        baseline = window_min;
+        window_min = Seconds::max();
+        samples_in_window = 0;
+    }
+
+    if (latency > baseline * configuration.latency_tolerance)
+    {
+        limit = std::max<double>(configuration.min_limit, limit * configuration.backoff_ratio);
+    } else if (2 * in_flight >= effective_limit())
+    {
+        // Only grow while the limit is actually being made use of.
+        limit = std::min<double>(configuration.max_limit, limit + 1);
+    }
+}
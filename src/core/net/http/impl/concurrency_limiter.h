@@ -0,0 +1,84 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_CONCURRENCY_LIMITER_H_
+#define CORE_NET_HTTP_IMPL_CONCURRENCY_LIMITER_H_
+
+#include <core/net/http/client.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Limits the number of requests in flight against a single host, adjusting
+// the limit with an AIMD scheme driven by observed latencies and errors.
+// All methods are thread-safe.
+class ConcurrencyLimiter
+{
+public:
+    typedef http::Client::ConcurrencyLimit::Configuration Configuration;
+    typedef std::chrono::duration<double> Seconds;
+
+    ConcurrencyLimiter(const Configuration& configuration);
+
+    // Blocks the calling thread until a slot is available and takes it.
+    void acquire();
+
+    // Takes a slot and returns true if one is available. Otherwise, queues
+    // on_acquired, which is invoked once a slot has been handed over to it.
+    bool acquire_or_enqueue(const std::function<void()>& on_acquired);
+
+    // Gives back a slot, feeding the latency sample and outcome of the
+    // completed request into the limit. Queued requests taking over freed up
+    // slots are started from the calling thread.
+    void release(const Seconds& latency, bool failed);
+
+    // Fills in the concurrency figures of the given host metrics.
+    void fill(http::Client::Metrics::Host& metrics);
+
+private:
+    // Returns the limit as a whole number of slots. Requires guard to be held.
+    std::uint32_t effective_limit() const;
+    // Adjusts limit according to a single sample. Requires guard to be held.
+    void update(const Seconds& latency, bool failed);
+
+    Configuration configuration;
+
+    std::mutex guard;
+    std::condition_variable slot_released;
+    double limit;
+    std::uint32_t in_flight{0};
+    std::uint32_t blocked{0};
+    std::deque<std::function<void()>> queue;
+
+    Seconds baseline{Seconds::max()};
+    Seconds window_min{Seconds::max()};
+    std::uint32_t samples_in_window{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_CONCURRENCY_LIMITER_H_
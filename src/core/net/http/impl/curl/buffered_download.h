@@ -0,0 +1,187 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_CURL_BUFFERED_DOWNLOAD_H_
+#define CORE_NET_HTTP_IMPL_CURL_BUFFERED_DOWNLOAD_H_
+
+#include <core/net/http/streaming_client.h>
+#include <core/net/http/streaming_request.h>
+
+#include "request.h"
+
+#include <thread>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+namespace curl
+{
+// A download whose body is handed to the data handler at the pace of the handler.
+// Executed asynchronously, the reactor queues the body in a bounded buffer that a
+// thread of its own drains into the data handler, pausing the transfer while the
+// buffer is full. Executed synchronously, the data handler paces the transfer anyway.
+class BufferedDownload : public core::net::http::StreamingRequest
+{
+public:
+    BufferedDownload(const std::shared_ptr<curl::Request>& request,
+                     const http::StreamingClient::Buffering::Configuration& configuration)
+        : request(request),
+          configuration(configuration)
+    {
+        this->configuration.chunk_size = std::max<std::size_t>(configuration.chunk_size, 1);
+    }
+
+    State state()
+    {
+        return request->state();
+    }
+
+    void set_timeout(const std::chrono::milliseconds& timeout)
+    {
+        request->set_timeout(timeout);
+    }
+
+    Response execute(const ProgressHandler& ph)
+    {
+        return execute(ph, [](const std::string&){});
+    }
+
+    Response execute(const ProgressHandler& ph, const DataHandler& dh)
+    {
+        return request->execute(ph, dh);
+    }
+
+    void async_execute(const Handler& handler)
+    {
+        async_execute(handler, [](const std::string&){});
+    }
+
+    void async_execute(const Handler& handler, const DataHandler& dh)
+    {
+        http::BodyReader::Configuration reading;
+        reading.capacity = configuration.capacity;
+
+        auto reader = request->open(reading, Handler().on_progress(handler.on_progress()));
+        auto chunk_size = configuration.chunk_size;
+
+        // Owns all it needs, the request may go away before the consumer is done.
+        std::thread{[reader, handler, dh, chunk_size]()
+        {
+            deliver(reader, handler, dh, chunk_size);
+        }}.detach();
+    }
+
+    // Hands the body to the returned reader, which paces the transfer on its own.
+    std::shared_ptr<http::BodyReader> open(const http::BodyReader::Configuration& configuration)
+    {
+        return request->open(configuration);
+    }
+
+    std::string url_escape(const std::string& s)
+    {
+        return request->url_escape(s);
+    }
+
+    std::string url_unescape(const std::string& s)
+    {
+        return request->url_unescape(s);
+    }
+
+    void pause()
+    {
+        request->pause();
+    }
+
+    void resume()
+    {
+        request->resume();
+    }
+
+    void abort_request_if(std::uint64_t limit, const std::chrono::seconds& time)
+    {
+        request->abort_request_if(limit, time);
+    }
+
+private:
+    // Hands the body to dh as it arrives, reporting the outcome once all of it has been handed out.
+    static void deliver(const std::shared_ptr<http::BodyReader>& reader,
+                        const Handler& handler,
+                        const DataHandler& dh,
+                        std::size_t chunk_size)
+    {
+        std::vector<char> chunk(chunk_size);
+        Response response;
+
+        try
+        {
+            std::size_t n{0};
+            while ((n = reader->read(chunk.data(), chunk.size())) > 0)
+            {
+                try
+                {
+                    dh(std::string{chunk.data(), n});
+                } catch(const std::exception& e)
+                {
+                    // Aborts the transfer, the failing data handler is what gets reported.
+                    reader->close();
+                    wait_for(reader);
+
+                    if (handler.on_error())
+                        handler.on_error()(core::net::http::Error(e.what(), CORE_FROM_HERE()));
+
+                    return;
+                }
+            }
+
+            response = reader->response();
+        } catch(const core::net::Error& e)
+        {
+            if (handler.on_error())
+                handler.on_error()(e);
+
+            return;
+        }
+
+        if (handler.on_response())
+            handler.on_response()(response);
+    }
+
+    // Waits for the transfer to end, whatever its outcome.
+    static void wait_for(const std::shared_ptr<http::BodyReader>& reader)
+    {
+        try
+        {
+            reader->response();
+        } catch(...)
+        {
+        }
+    }
+
+    std::shared_ptr<curl::Request> request;
+    http::StreamingClient::Buffering::Configuration configuration;
+};
+}
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_CURL_BUFFERED_DOWNLOAD_H_
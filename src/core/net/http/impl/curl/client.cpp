@@ -17,9 +17,23 @@
  *              Gary Wang  <gary.wang@canonical.com>
  */
 
+#include "buffered_download.h"
 #include "client.h"
 #include "curl.h"
+#include "delta_download.h"
 #include "request.h"
+#include "resumable_upload.h"
+#include "segmented_download.h"
+#include "writable_upload.h"
+
+#include "../buffer_sequence.h"
+#include "../compressor.h"
+#include "../disk_cache_store.h"
+#include "../file_sink.h"
+#include "../file_source.h"
+#include "../form_body.h"
+#include "../memory_cache_store.h"
+#include "../upload_queue.h"
 
 #include <core/net/http/content_type.h>
 #include <core/net/http/method.h>
@@ -29,6 +43,10 @@
 #include <boost/archive/iterators/transform_width.hpp>
 #include <boost/archive/iterators/ostream_iterator.hpp>
 
+#include <cerrno>
+#include <fstream>
+#include <system_error>
+
 namespace net = core::net;
 namespace http = core::net::http;
 namespace bai = boost::archive::iterators;
@@ -36,10 +54,156 @@ namespace bai = boost::archive::iterators;
 namespace
 {
 const std::string BASE64_PADDING[] = { "", "==", "=" };
+
+// Announces the encoding of a compressed request body.
+void announce(::curl::easy::Handle& handle, const std::shared_ptr<http::impl::Compressor>& compressor)
+{
+    http::Header header;
+    header.add("Content-Encoding", compressor->encoding());
+    handle.header(header);
+}
+
+// Announces a request body of size bytes, -1 if unknown, with Expect: 100-continue
+// or sends it right away, following configuration. An Expect header field given by
+// the caller is left alone.
+void expect_continue(::curl::easy::Handle& handle, const http::Request::Configuration& configuration, std::int64_t size)
+{
+    if (configuration.header.has("Expect"))
+        return;
+
+    handle.set_option(::curl::Option::expect_100_timeout_ms,
+                      static_cast<long>(configuration.expect_continue.timeout.count()));
+
+    // An empty value keeps curl from adding the field itself.
+    http::Header header;
+    header.add("Expect", http::impl::curl::expects_continue(configuration, size) ? "100-continue" : "");
+    handle.header(header);
+}
+
+// Returns the size of a request body as known to Expect: 100-continue, -1 if unknown.
+std::int64_t body_length(std::size_t size)
+{
+    return size == http::StreamingClient::Upload::unknown_size ? -1 : static_cast<std::int64_t>(size);
+}
+
+// Read callbacks hand the value through to curl.
+static_assert(http::StreamingClient::Upload::pause == static_cast<std::size_t>(::curl::Code::no_readfunc_pause),
+              "Upload::pause does not match curl");
+
+// Installs reader for the request body of size bytes, compressing the body
+// on the fly if requested by configuration. Returns true if the body is compressed.
+// Uncompressed bodies are rewound by seeker, if given, to be sent again.
+bool read_body(::curl::easy::Handle& handle,
+               const http::Request::Configuration& configuration,
+               const ::curl::easy::Handle::OnReadData& reader,
+               std::size_t size,
+               const ::curl::easy::Handle::OnSeekData& seeker = ::curl::easy::Handle::OnSeekData{})
+{
+    auto compressor = http::impl::Compressor::for_body(configuration, size);
+
+    if (not compressor)
+    {
+        handle.on_read_data(reader, size);
+        if (seeker)
+            handle.on_seek_data(seeker);
+        expect_continue(handle, configuration, body_length(size));
+        return false;
+    }
+
+    announce(handle, compressor);
+
+    handle.on_read_data([compressor, reader](void* dest, std::size_t size, std::size_t nmemb)
+    {
+        // Exceptions must not cross the frames of libcurl, failing to compress fails the transfer.
+        try
+        {
+            return compressor->read(static_cast<char*>(dest), size * nmemb, [reader](char* buffer, std::size_t size)
+            {
+                return reader(buffer, 1, size);
+            });
+        } catch(const std::exception&)
+        {
+            return static_cast<std::size_t>(::curl::Code::no_readfunc_abort);
+        }
+    }, size);
+
+    // The compressed size is not known upfront, the body is sent chunked.
+    handle.set_option(::curl::Option::in_file_size, -1L);
+    // Compressing hardly ever grows a body, the uncompressed size decides.
+    expect_continue(handle, configuration, body_length(size));
+
+    return true;
+}
+
+// Rewinds payload relative to the position it is read from first, unless the stream cannot seek.
+::curl::easy::Handle::OnSeekData seek_stream(std::istream& payload)
+{
+    auto start = payload.tellg();
+    if (start == std::istream::pos_type(-1))
+        return ::curl::easy::Handle::OnSeekData{};
+
+    return [&payload, start](std::uint64_t offset)
+    {
+        payload.clear();
+        return static_cast<bool>(payload.seekg(start + static_cast<std::istream::off_type>(offset)));
+    };
+}
+
+// Installs a reader for the body read from file, compressing the body on the fly
+// if requested by configuration. Returns the size of the body sent, -1 if compressed.
+std::int64_t read_file(::curl::easy::Handle& handle,
+               const http::Request::Configuration& configuration,
+               const std::shared_ptr<http::impl::FileSource>& file,
+               const http::StreamingClient::FileSource::Configuration& source)
+{
+    bool compressed = read_body(handle, configuration, [file](void* dest, std::size_t size, std::size_t nmemb)
+    {
+        try
+        {
+            return file->read(static_cast<char*>(dest), size * nmemb);
+        } catch(const std::system_error&)
+        {
+            return static_cast<std::size_t>(::curl::Code::no_readfunc_abort);
+        }
+    }, file->size(), [file](std::uint64_t offset)
+    {
+        return file->seek(offset);
+    });
+
+    handle.set_option(::curl::Option::upload_buffer_size, static_cast<long>(source.buffer_size));
+
+    if (compressed)
+        return -1;
+
+    // Files beyond 2 GiB do not fit the size set up by read_body on 32-bit platforms.
+    handle.set_option(::curl::Option::in_file_size_large, static_cast<curl_off_t>(file->size()));
+
+    return file->size();
+}
 }
 
-http::impl::curl::Client::Client()
+http::impl::curl::Client::Client(const http::Client::Configuration& configuration)
+    : decoding(configuration.decoding)
 {
+    facilities.hosts = std::make_shared<impl::Hosts>(configuration);
+    facilities.traffic = std::make_shared<impl::Traffic>();
+    facilities.mirrors = std::make_shared<impl::Mirrors>();
+
+    if (configuration.coalescing.enabled)
+        facilities.coalescer = std::make_shared<impl::Coalescer>(configuration.coalescing);
+
+    if (configuration.cache.enabled)
+    {
+        std::unique_ptr<impl::CacheStore> store;
+
+        if (configuration.cache.directory.empty())
+            store.reset(new impl::MemoryCacheStore{configuration.cache.max_size});
+        else
+            store.reset(new impl::DiskCacheStore{configuration.cache.directory, configuration.cache.max_size});
+
+        facilities.cache = std::make_shared<impl::Cache>(configuration.cache, std::move(store));
+    }
+
     multi.set_option(::curl::multi::Option::pipelining, ::curl::easy::enable);
 }
 
@@ -109,6 +273,51 @@ void http::impl::curl::Client::stop()
     multi.stop();
 }
 
+http::Client::Metrics http::impl::curl::Client::metrics()
+{
+    http::Client::Metrics result;
+    facilities.hosts->fill(result);
+    facilities.traffic->fill(result);
+    facilities.mirrors->fill(result);
+
+    if (facilities.coalescer)
+        facilities.coalescer->fill(result);
+
+    if (facilities.cache)
+        facilities.cache->fill(result);
+
+    return result;
+}
+
+std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::make_request(
+        http::Method method,
+        const http::Request::Configuration& configuration,
+        ::curl::easy::Handle handle,
+        std::int64_t body_length)
+{
+    bool decode = configuration.decoding == http::Request::Decoding::inherit ?
+                decoding.enabled : configuration.decoding == http::Request::Decoding::enabled;
+
+    // An empty string makes curl advertise all encodings it was built with.
+    if (decode)
+        handle.set_option(::curl::Option::accept_encoding, decoding.encodings.c_str());
+
+    if (configuration.max_redirects > 0)
+    {
+        handle.set_option(::curl::Option::follow_location, ::curl::easy::enable);
+        handle.set_option(::curl::Option::max_redirects, configuration.max_redirects);
+    }
+
+    // Requests see the decoding actually applied, coalescing and caching tell them apart by it.
+    auto resolved = configuration;
+    resolved.decoding = decode ? http::Request::Decoding::enabled : http::Request::Decoding::disabled;
+
+    std::shared_ptr<http::impl::curl::Request> request{new http::impl::curl::Request{multi, handle, method, resolved, facilities}};
+    request->set_body_length(body_length);
+
+    return request;
+}
+
 std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::head_impl(const http::Request::Configuration& configuration)
 {
     ::curl::easy::Handle handle;
@@ -128,7 +337,7 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::head_impl(c
         handle.http_credentials(credentials.username, credentials.password);
     }
 
-    return std::shared_ptr<http::impl::curl::Request>{new http::impl::curl::Request{multi, handle}};
+    return make_request(http::Method::head, configuration, handle);
 }
 
 std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::get_impl(const http::Request::Configuration& configuration)
@@ -149,19 +358,37 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::get_impl(co
         handle.http_credentials(credentials.username, credentials.password);
     }
 
-    return std::shared_ptr<http::impl::curl::Request>{new http::impl::curl::Request{multi, handle}};
+    return make_request(http::Method::get, configuration, handle);
 }
 
 std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_impl(
         const Request::Configuration& configuration,
         const std::string& payload,
         const std::string& ct)
+{
+    // The caller keeps its payload, the request needs a copy of its own.
+    return post_impl(configuration, std::make_shared<const std::string>(payload), ct);
+}
+
+std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_impl(
+        const Request::Configuration& configuration,
+        const std::shared_ptr<const std::string>& payload,
+        const std::string& ct)
 {
     ::curl::easy::Handle handle;
     handle.method(http::Method::post)
             .url(configuration.uri.c_str())
-            .header(configuration.header)
-            .post_data(payload.c_str(), ct);
+            .header(configuration.header);
+
+    auto body = payload;
+    if (auto compressor = impl::Compressor::for_body(configuration, payload->size()))
+    {
+        announce(handle, compressor);
+        body = std::make_shared<const std::string>(compressor->compress(*payload));
+    }
+
+    handle.post_data(body, ct);
+    expect_continue(handle, configuration, static_cast<std::int64_t>(body->size()));
 
     handle.set_option(::curl::Option::ssl_verify_host,
                       configuration.ssl.verify_host ? ::curl::easy::enable_ssl_host_verification : ::curl::easy::disable);
@@ -174,7 +401,7 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_impl(
         handle.http_credentials(credentials.username, credentials.password);
     }
 
-    return std::shared_ptr<http::impl::curl::Request>{new http::impl::curl::Request{multi, handle}};
+    return make_request(http::Method::post, configuration, handle, static_cast<std::int64_t>(body->size()));
 }
 
 std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_impl(
@@ -185,16 +412,20 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_impl(
     ::curl::easy::Handle handle;
     handle.method(http::Method::post)
             .url(configuration.uri.c_str())
-            .header(configuration.header)
-            .on_read_data([&payload, size](void* dest, std::size_t in_size, std::size_t nmemb)
+            .header(configuration.header);
+
+    bool compressed = read_body(handle, configuration, [&payload, size](void* dest, std::size_t in_size, std::size_t nmemb)
             {
                 //use internal buffer size(in_size *nmemb) instread of size passed by parameter
                 //to avoid client crashing when sending large chuck of data via POST method
                 auto result = payload.readsome(static_cast<char *>(dest), in_size * nmemb);
                 return result;            
-            }, size);   
+            }, size, seek_stream(payload));
     
-    handle.set_option(::curl::Option::post_field_size, size);
+    if (compressed)
+        handle.set_option(::curl::Option::post_field_size, -1L);
+    else
+        handle.set_option(::curl::Option::post_field_size, size);
     handle.set_option(::curl::Option::ssl_verify_host,
                       configuration.ssl.verify_host ? ::curl::easy::enable_ssl_host_verification : ::curl::easy::disable);
     handle.set_option(::curl::Option::ssl_verify_peer,
@@ -206,19 +437,21 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_impl(
         handle.http_credentials(credentials.username, credentials.password);
     }
 
-    return std::shared_ptr<http::impl::curl::Request>{new http::impl::curl::Request{multi, handle}};
+    return make_request(http::Method::post, configuration, handle, body_length(size));
 }
 
 std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_impl(
         const Request::Configuration& configuration,
         std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback,
+        const http::StreamingClient::Upload::Seeker& seeker,
         std::size_t size)
 {
     ::curl::easy::Handle handle;
     handle.method(http::Method::post)
             .url(configuration.uri.c_str())
-            .header(configuration.header)
-            .on_read_data([readdata_callback, size](void* dest, std::size_t in_size, std::size_t nmemb)
+            .header(configuration.header);
+
+    bool compressed = read_body(handle, configuration, [readdata_callback, size](void* dest, std::size_t in_size, std::size_t nmemb)
             {
                 if(readdata_callback) {
                     try 
@@ -232,9 +465,12 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_impl(
 
                 //stop the current operation immediately
                 return (size_t)::curl::Code::no_readfunc_abort;
-            }, size);    
+            }, size, seeker);    
     
-    handle.set_option(::curl::Option::post_field_size, size);
+    if (compressed || size == http::StreamingClient::Upload::unknown_size)
+        handle.set_option(::curl::Option::post_field_size, -1L);
+    else
+        handle.set_option(::curl::Option::post_field_size, size);
     handle.set_option(::curl::Option::ssl_verify_host,
                       configuration.ssl.verify_host ? ::curl::easy::enable_ssl_host_verification : ::curl::easy::disable);
     handle.set_option(::curl::Option::ssl_verify_peer,
@@ -246,7 +482,27 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_impl(
         handle.http_credentials(credentials.username, credentials.password);
     }
 
-    return std::shared_ptr<http::impl::curl::Request>{new http::impl::curl::Request{multi, handle}};
+    return make_request(http::Method::post, configuration, handle, body_length(size));
+}
+
+std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_form_impl(
+        const Request::Configuration& configuration,
+        const std::map<std::string, std::string>& values)
+{
+    // Fields are escaped while the body is sent instead of building up an escaped copy upfront.
+    auto body = std::make_shared<impl::UrlencodedBody>(values);
+
+    auto with_type = configuration;
+    if (not with_type.header.has("Content-Type"))
+        with_type.header.set("Content-Type", http::ContentType::x_www_form_urlencoded);
+
+    return post_impl(with_type, [body](void* dest, std::size_t size)
+    {
+        return body->read(static_cast<char*>(dest), size);
+    }, [body](std::uint64_t offset)
+    {
+        return body->seek(offset);
+    }, body->size());
 }
 
 std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::put_impl(
@@ -257,14 +513,15 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::put_impl(
     ::curl::easy::Handle handle;
     handle.method(http::Method::put)
             .url(configuration.uri.c_str())
-            .header(configuration.header)
-            .on_read_data([&payload, size](void* dest, std::size_t in_size, std::size_t nmemb)
+            .header(configuration.header);
+
+    read_body(handle, configuration, [&payload, size](void* dest, std::size_t in_size, std::size_t nmemb)
             {
                 //use internal buffer size(in_size *nmemb) instread of size passed by parameter
                 //to avoid client crashing when sending large chuck of data via PUT method
                 auto result = payload.readsome(static_cast<char*>(dest), in_size * nmemb);
                 return result;
-            }, size);
+            }, size, seek_stream(payload));
 
     handle.set_option(::curl::Option::ssl_verify_host,
                       configuration.ssl.verify_host ? ::curl::easy::enable_ssl_host_verification : ::curl::easy::disable);
@@ -277,19 +534,21 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::put_impl(
         handle.http_credentials(credentials.username, credentials.password);
     }
 
-    return std::shared_ptr<http::impl::curl::Request>{new http::impl::curl::Request{multi, handle}};
+    return make_request(http::Method::put, configuration, handle, body_length(size));
 }
 
 std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::put_impl(
         const Request::Configuration& configuration,
         std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback,
+        const http::StreamingClient::Upload::Seeker& seeker,
         std::size_t size)
 {
     ::curl::easy::Handle handle;
     handle.method(http::Method::put)
             .url(configuration.uri.c_str())
-            .header(configuration.header)
-            .on_read_data([readdata_callback, size](void* dest, std::size_t in_size, std::size_t nmemb)
+            .header(configuration.header);
+
+    read_body(handle, configuration, [readdata_callback, size](void* dest, std::size_t in_size, std::size_t nmemb)
             {
                 if(readdata_callback) {
                     try 
@@ -303,7 +562,37 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::put_impl(
 
                 //stop the current operation immediately
                 return (size_t)::curl::Code::no_readfunc_abort;
-            }, size);
+            }, size, seeker);
+
+    // Without a size, the body is sent chunked.
+    if (size == http::StreamingClient::Upload::unknown_size)
+        handle.set_option(::curl::Option::in_file_size, -1L);
+
+    handle.set_option(::curl::Option::ssl_verify_host,
+                      configuration.ssl.verify_host ? ::curl::easy::enable_ssl_host_verification : ::curl::easy::disable);
+    handle.set_option(::curl::Option::ssl_verify_peer,
+                      configuration.ssl.verify_peer ? ::curl::easy::enable : ::curl::easy::disable);
+
+    if (configuration.authentication_handler.for_http)
+    {
+        auto credentials = configuration.authentication_handler.for_http(configuration.uri);
+        handle.http_credentials(credentials.username, credentials.password);
+    }
+
+    return make_request(http::Method::put, configuration, handle, body_length(size));
+}
+
+std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::put_impl(
+        const Request::Configuration& configuration,
+        const http::StreamingClient::FileSource::Configuration& source)
+{
+    ::curl::easy::Handle handle;
+    handle.method(http::Method::put)
+            .url(configuration.uri.c_str())
+            .header(configuration.header);
+
+    auto file = std::make_shared<impl::FileSource>(source);
+    read_file(handle, configuration, file, source);
 
     handle.set_option(::curl::Option::ssl_verify_host,
                       configuration.ssl.verify_host ? ::curl::easy::enable_ssl_host_verification : ::curl::easy::disable);
@@ -316,7 +605,39 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::put_impl(
         handle.http_credentials(credentials.username, credentials.password);
     }
 
-    return std::shared_ptr<http::impl::curl::Request>{new http::impl::curl::Request{multi, handle}};
+    return make_request(http::Method::put, configuration, handle, static_cast<std::int64_t>(file->size()));
+}
+
+std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::post_impl(
+        const Request::Configuration& configuration,
+        const http::StreamingClient::FileSource::Configuration& source,
+        const std::string& ct)
+{
+    auto header = configuration.header;
+    if (not header.has("Content-Type"))
+        header.set("Content-Type", ct);
+
+    ::curl::easy::Handle handle;
+    handle.method(http::Method::post)
+            .url(configuration.uri.c_str())
+            .header(header);
+
+    auto file = std::make_shared<impl::FileSource>(source);
+    auto size = read_file(handle, configuration, file, source);
+    handle.set_option(::curl::Option::post_field_size_large, static_cast<curl_off_t>(size));
+
+    handle.set_option(::curl::Option::ssl_verify_host,
+                      configuration.ssl.verify_host ? ::curl::easy::enable_ssl_host_verification : ::curl::easy::disable);
+    handle.set_option(::curl::Option::ssl_verify_peer,
+                      configuration.ssl.verify_peer ? ::curl::easy::enable : ::curl::easy::disable);
+
+    if (configuration.authentication_handler.for_http)
+    {
+        auto credentials = configuration.authentication_handler.for_http(configuration.uri);
+        handle.http_credentials(credentials.username, credentials.password);
+    }
+
+    return make_request(http::Method::post, configuration, handle, static_cast<std::int64_t>(file->size()));
 }
 
 std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::del_impl(const http::Request::Configuration& configuration)
@@ -337,7 +658,7 @@ std::shared_ptr<http::impl::curl::Request> http::impl::curl::Client::del_impl(co
         handle.http_credentials(credentials.username, credentials.password);
     }
 
-    return std::shared_ptr<http::impl::curl::Request>{new http::impl::curl::Request{multi, handle}};
+    return make_request(http::Method::del, configuration, handle);
 }
 
 std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_get(const http::Request::Configuration& configuration)
@@ -362,16 +683,17 @@ std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post
 
 std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post_form(const http::Request::Configuration& configuration, const std::map<std::string, std::string>& values)
 {
-    std::stringstream ss;
-    bool first{true};
+    return post_form_impl(configuration, values);
+}
 
-    for (const auto& pair : values)
-    {
-        ss << (first ? "" : "&") << url_escape(pair.first) << "=" << url_escape(pair.second);
-        first = false;
-    }
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post(const http::Request::Configuration& configuration, std::string&& payload, const std::string& type)
+{
+    return post_impl(configuration, std::make_shared<const std::string>(std::move(payload)), type);
+}
 
-    return post_impl(configuration, ss.str(), http::ContentType::x_www_form_urlencoded);
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post(const http::Request::Configuration& configuration, const std::shared_ptr<const std::string>& payload, const std::string& type)
+{
+    return post_impl(configuration, payload, type);
 }
 
 std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post(const http::Request::Configuration& configuration, std::istream& payload, std::size_t   size)
@@ -381,12 +703,30 @@ std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post
 
 std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post(const http::Request::Configuration& configuration, std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback, std::size_t size)
 {
-    return post_impl(configuration, readdata_callback, size);
+    return post_impl(configuration, readdata_callback, http::StreamingClient::Upload::Seeker{}, size);
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post(
+        const http::Request::Configuration& configuration,
+        std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback,
+        const http::StreamingClient::Upload::Seeker& seeker,
+        std::size_t size)
+{
+    return post_impl(configuration, readdata_callback, seeker, size);
 }
 
 std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_put(const http::Request::Configuration& configuration, std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback, std::size_t size)
 {
-    return put_impl(configuration, readdata_callback, size);
+    return put_impl(configuration, readdata_callback, http::StreamingClient::Upload::Seeker{}, size);
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_put(
+        const http::Request::Configuration& configuration,
+        std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback,
+        const http::StreamingClient::Upload::Seeker& seeker,
+        std::size_t size)
+{
+    return put_impl(configuration, readdata_callback, seeker, size);
 }
 
 std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_del(const http::Request::Configuration& configuration)
@@ -394,6 +734,210 @@ std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_del(
     return del_impl(configuration);
 }
 
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_get_to_file(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::FileSink::Configuration& sink)
+{
+    // Opening the file upfront reports an unusable target before any transfer.
+    auto file = std::make_shared<impl::FileSink>(sink, configuration.uri);
+
+    auto request_configuration = configuration;
+    // Ranges address the body as sent, which must not be decoded on the way.
+    if (sink.resumable)
+        request_configuration.decoding = http::Request::Decoding::disabled;
+
+    auto request = get_impl(request_configuration);
+    request->write_to(file);
+
+    return request;
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::segmented_get_to_file(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::FileSink::Configuration& sink,
+        const http::StreamingClient::Segmentation::Configuration& segmentation)
+{
+    return mirrored_get_to_file(configuration, std::vector<std::string>{configuration.uri}, sink, segmentation);
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::mirrored_get_to_file(
+        const http::Request::Configuration& configuration,
+        const std::vector<std::string>& mirrors,
+        const http::StreamingClient::FileSink::Configuration& sink,
+        const http::StreamingClient::Segmentation::Configuration& segmentation)
+{
+    // Segments keep track of their progress themselves.
+    auto file_configuration = sink;
+    file_configuration.resumable = false;
+
+    auto file = std::make_shared<impl::FileSink>(file_configuration);
+
+    // Ranges address the body as sent, which must not be decoded on the way.
+    auto probe_configuration = configuration;
+    probe_configuration.decoding = http::Request::Decoding::disabled;
+
+    auto uris = mirrors;
+    if (uris.empty())
+        uris.push_back(configuration.uri);
+
+    probe_configuration.uri = uris.front();
+
+    auto probe = head_impl(probe_configuration);
+    probe->header_only();
+
+    return std::make_shared<curl::SegmentedDownload>(multi, probe, probe_configuration, uris, file, segmentation, facilities.mirrors);
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::delta_get_to_file(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::FileSink::Configuration& sink,
+        const http::StreamingClient::Delta::Configuration& delta)
+{
+    std::ifstream in{delta.manifest, std::ios::binary};
+    if (not in)
+        throw std::system_error{errno, std::system_category(), "Could not open " + delta.manifest};
+
+    auto manifest = impl::ZsyncManifest::read(in);
+
+    // Ranges address the body as sent, which must not be decoded on the way.
+    auto request_configuration = configuration;
+    request_configuration.decoding = http::Request::Decoding::disabled;
+    if (request_configuration.uri.empty())
+        request_configuration.uri = manifest.url;
+
+    auto file_configuration = sink;
+    file_configuration.resumable = false;
+
+    auto file = std::make_shared<impl::FileSink>(file_configuration);
+
+    // Only ever used for deriving the requests issued by the download.
+    auto origin = get_impl(request_configuration);
+
+    return std::make_shared<curl::DeltaDownload>(multi, origin, request_configuration, manifest, delta, file);
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::resumable_put(
+        const http::Request::Configuration& configuration,
+        const std::string& path,
+        const std::string& state)
+{
+    // Only ever used for deriving the requests issued by the upload.
+    auto origin = head_impl(configuration);
+
+    return std::make_shared<curl::ResumableUpload>(multi, origin, configuration, path, state);
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_put_file(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::FileSource::Configuration& source)
+{
+    return put_impl(configuration, source);
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post_file(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::FileSource::Configuration& source,
+        const std::string& type)
+{
+    return post_impl(configuration, source, type);
+}
+
+http::StreamingClient::Upload::Writable http::impl::curl::Client::streaming_put_writer(
+        const http::Request::Configuration& configuration,
+        const http::UploadWriter::Configuration& writer)
+{
+    auto queue = std::make_shared<impl::UploadQueue>(writer);
+    auto size = writer.size < 0 ? http::StreamingClient::Upload::unknown_size : static_cast<std::size_t>(writer.size);
+
+    auto request = put_impl(configuration, [queue](void* dest, std::size_t size)
+    {
+        return queue->pull(static_cast<char*>(dest), size);
+    }, http::StreamingClient::Upload::Seeker{}, size);
+
+    return http::StreamingClient::Upload::Writable{std::make_shared<curl::WritableUpload>(request, queue), queue};
+}
+
+http::StreamingClient::Upload::Writable http::impl::curl::Client::streaming_post_writer(
+        const http::Request::Configuration& configuration,
+        const http::UploadWriter::Configuration& writer,
+        const std::string& type)
+{
+    auto queue = std::make_shared<impl::UploadQueue>(writer);
+    auto size = writer.size < 0 ? http::StreamingClient::Upload::unknown_size : static_cast<std::size_t>(writer.size);
+
+    auto with_type = configuration;
+    if (not with_type.header.has("Content-Type"))
+        with_type.header.set("Content-Type", type);
+
+    auto request = post_impl(with_type, [queue](void* dest, std::size_t size)
+    {
+        return queue->pull(static_cast<char*>(dest), size);
+    }, http::StreamingClient::Upload::Seeker{}, size);
+
+    return http::StreamingClient::Upload::Writable{std::make_shared<curl::WritableUpload>(request, queue), queue};
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_put_buffers(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::Upload::Buffers& buffers)
+{
+    auto sequence = std::make_shared<impl::BufferSequence>(buffers);
+
+    return put_impl(configuration, [sequence](void* dest, std::size_t size)
+    {
+        return sequence->read(static_cast<char*>(dest), size);
+    }, [sequence](std::uint64_t offset)
+    {
+        return sequence->seek(offset);
+    }, sequence->size());
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post_buffers(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::Upload::Buffers& buffers,
+        const std::string& type)
+{
+    auto sequence = std::make_shared<impl::BufferSequence>(buffers);
+
+    auto with_type = configuration;
+    if (not with_type.header.has("Content-Type"))
+        with_type.header.set("Content-Type", type);
+
+    return post_impl(with_type, [sequence](void* dest, std::size_t size)
+    {
+        return sequence->read(static_cast<char*>(dest), size);
+    }, [sequence](std::uint64_t offset)
+    {
+        return sequence->seek(offset);
+    }, sequence->size());
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_post_multipart(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::Multipart::Parts& parts)
+{
+    auto body = std::make_shared<impl::MultipartBody>(parts);
+
+    // The boundary belongs to the body, it replaces any content type given by configuration.
+    auto with_type = configuration;
+    with_type.header.set("Content-Type", "multipart/form-data; boundary=" + body->boundary());
+
+    return post_impl(with_type, [body](void* dest, std::size_t size)
+    {
+        return body->read(static_cast<char*>(dest), size);
+    }, [body](std::uint64_t offset)
+    {
+        return body->seek(offset);
+    }, static_cast<std::size_t>(body->size()));
+}
+
+std::shared_ptr<http::StreamingRequest> http::impl::curl::Client::streaming_get_buffered(
+        const http::Request::Configuration& configuration,
+        const http::StreamingClient::Buffering::Configuration& buffering)
+{
+    return std::make_shared<curl::BufferedDownload>(get_impl(configuration), buffering);
+}
+
 std::shared_ptr<http::Request> http::impl::curl::Client::head(const http::Request::Configuration& configuration)
 {
     return head_impl(configuration);
@@ -412,6 +956,22 @@ std::shared_ptr<http::Request> http::impl::curl::Client::post(
     return post_impl(configuration, payload, ct);
 }
 
+std::shared_ptr<http::Request> http::impl::curl::Client::post(
+        const Request::Configuration& configuration,
+        std::string&& payload,
+        const std::string& ct)
+{
+    return post_impl(configuration, std::make_shared<const std::string>(std::move(payload)), ct);
+}
+
+std::shared_ptr<http::Request> http::impl::curl::Client::post(
+        const Request::Configuration& configuration,
+        const std::shared_ptr<const std::string>& payload,
+        const std::string& ct)
+{
+    return post_impl(configuration, payload, ct);
+}
+
 std::shared_ptr<http::Request> http::impl::curl::Client::post(
         const Request::Configuration& configuration,
         std::istream& payload,
@@ -420,12 +980,32 @@ std::shared_ptr<http::Request> http::impl::curl::Client::post(
     return post_impl(configuration, payload, size);
 }
 
+std::shared_ptr<http::Request> http::impl::curl::Client::put(
+        const Request::Configuration& configuration,
+        const http::Client::FileSource::Configuration& source)
+{
+    return put_impl(configuration, source);
+}
+
+std::shared_ptr<http::Request> http::impl::curl::Client::post(
+        const Request::Configuration& configuration,
+        const http::Client::FileSource::Configuration& source,
+        const std::string& ct)
+{
+    return post_impl(configuration, source, ct);
+}
+
 std::shared_ptr<http::Request> http::impl::curl::Client::del(
         const Request::Configuration& configuration)
 {
     return del_impl(configuration);
 }
 
+std::shared_ptr<http::Request> http::impl::curl::Client::post_form(const http::Request::Configuration& configuration, const std::map<std::string, std::string>& values)
+{
+    return post_form_impl(configuration, values);
+}
+
 std::shared_ptr<http::Request> http::impl::curl::Client::put(
         const Request::Configuration& configuration,
         std::istream& payload,
@@ -439,7 +1019,17 @@ std::shared_ptr<http::Client> http::make_client()
     return std::make_shared<http::impl::curl::Client>();
 }
 
+std::shared_ptr<http::Client> http::make_client(const http::Client::Configuration& configuration)
+{
+    return std::make_shared<http::impl::curl::Client>(configuration);
+}
+
 std::shared_ptr<http::StreamingClient> http::make_streaming_client()
 {
     return std::make_shared<http::impl::curl::Client>();
 }
+
+std::shared_ptr<http::StreamingClient> http::make_streaming_client(const http::Client::Configuration& configuration)
+{
+    return std::make_shared<http::impl::curl::Client>(configuration);
+}
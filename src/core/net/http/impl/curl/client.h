@@ -23,6 +23,12 @@
 
 #include "curl.h"
 
+#include "../cache.h"
+#include "../coalescer.h"
+#include "../host.h"
+#include "../mirrors.h"
+#include "../traffic.h"
+
 namespace core
 {
 namespace net
@@ -35,10 +41,20 @@ namespace curl
 {
 class Request;
 
+// Client-wide facilities shared with the requests created by a client, all of them optional.
+struct Facilities
+{
+    std::shared_ptr<impl::Hosts> hosts;
+    std::shared_ptr<impl::Coalescer> coalescer;
+    std::shared_ptr<impl::Cache> cache;
+    std::shared_ptr<impl::Traffic> traffic;
+    std::shared_ptr<impl::Mirrors> mirrors;
+};
+
 class Client : public core::net::http::StreamingClient
 {
 public:
-    Client();
+    Client(const http::Client::Configuration& configuration = http::Client::Configuration{});
 
     // From core::net::http::Client
 
@@ -57,6 +73,7 @@ public:
     std::shared_ptr<http::Request> get(const http::Request::Configuration& configuration) override;
     std::shared_ptr<http::Request> head(const http::Request::Configuration& configuration) override;
     std::shared_ptr<http::Request> post(const http::Request::Configuration& configuration, const std::string&, const std::string&) override;
+    std::shared_ptr<http::Request> post_form(const http::Request::Configuration& configuration, const std::map<std::string, std::string>& values) override;
     std::shared_ptr<http::Request> put(const http::Request::Configuration& configuration, std::istream& payload, std::size_t size) override;
 
     std::shared_ptr<http::StreamingRequest> streaming_get(const http::Request::Configuration& configuration) override;
@@ -65,25 +82,84 @@ public:
     std::shared_ptr<http::StreamingRequest> streaming_post(const http::Request::Configuration& configuration, const std::string& payload, const std::string& type) override;
     std::shared_ptr<http::StreamingRequest> streaming_post_form(const http::Request::Configuration& configuration, const std::map<std::string, std::string>& values) override;
 
+    std::shared_ptr<http::Request> post(const http::Request::Configuration& configuration, std::string&& payload, const std::string& type);
+    std::shared_ptr<http::Request> post(const http::Request::Configuration& configuration, const std::shared_ptr<const std::string>& payload, const std::string& type);
     std::shared_ptr<http::Request> post(const http::Request::Configuration& configuration, std::istream& payload, std::size_t size);
+    std::shared_ptr<http::Request> put(const http::Request::Configuration& configuration, const http::Client::FileSource::Configuration& source);
+    std::shared_ptr<http::Request> post(const http::Request::Configuration& configuration, const http::Client::FileSource::Configuration& source, const std::string& type);
     std::shared_ptr<http::Request> del(const http::Request::Configuration& configuration);
+    std::shared_ptr<http::StreamingRequest> streaming_post(const http::Request::Configuration& configuration, std::string&& payload, const std::string& type);
+    std::shared_ptr<http::StreamingRequest> streaming_post(const http::Request::Configuration& configuration, const std::shared_ptr<const std::string>& payload, const std::string& type);
     std::shared_ptr<http::StreamingRequest> streaming_post(const http::Request::Configuration& configuration, std::istream& payload, std::size_t size) override;
     std::shared_ptr<http::StreamingRequest> streaming_post(const http::Request::Configuration& configuration, std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback, std::size_t size) override;
     std::shared_ptr<http::StreamingRequest> streaming_put(const http::Request::Configuration& configuration, std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback, std::size_t size) override;
+    std::shared_ptr<http::StreamingRequest> streaming_post(const http::Request::Configuration& configuration,
+                                                           std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback,
+                                                           const http::StreamingClient::Upload::Seeker& seeker,
+                                                           std::size_t size);
+    std::shared_ptr<http::StreamingRequest> streaming_put(const http::Request::Configuration& configuration,
+                                                          std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback,
+                                                          const http::StreamingClient::Upload::Seeker& seeker,
+                                                          std::size_t size);
     std::shared_ptr<http::StreamingRequest> streaming_del(const http::Request::Configuration& configuration) override;
+    std::shared_ptr<http::StreamingRequest> streaming_get_to_file(const http::Request::Configuration& configuration, const http::StreamingClient::FileSink::Configuration& sink);
+    std::shared_ptr<http::StreamingRequest> segmented_get_to_file(const http::Request::Configuration& configuration,
+                                                                  const http::StreamingClient::FileSink::Configuration& sink,
+                                                                  const http::StreamingClient::Segmentation::Configuration& segmentation);
+    std::shared_ptr<http::StreamingRequest> mirrored_get_to_file(const http::Request::Configuration& configuration,
+                                                                 const std::vector<std::string>& mirrors,
+                                                                 const http::StreamingClient::FileSink::Configuration& sink,
+                                                                 const http::StreamingClient::Segmentation::Configuration& segmentation);
+    std::shared_ptr<http::StreamingRequest> delta_get_to_file(const http::Request::Configuration& configuration,
+                                                              const http::StreamingClient::FileSink::Configuration& sink,
+                                                              const http::StreamingClient::Delta::Configuration& delta);
+    std::shared_ptr<http::StreamingRequest> resumable_put(const http::Request::Configuration& configuration,
+                                                          const std::string& path,
+                                                          const std::string& state);
+    std::shared_ptr<http::StreamingRequest> streaming_put_file(const http::Request::Configuration& configuration,
+                                                               const http::StreamingClient::FileSource::Configuration& source);
+    std::shared_ptr<http::StreamingRequest> streaming_post_file(const http::Request::Configuration& configuration,
+                                                                const http::StreamingClient::FileSource::Configuration& source,
+                                                                const std::string& type);
+    http::StreamingClient::Upload::Writable streaming_put_writer(const http::Request::Configuration& configuration,
+                                                                 const http::UploadWriter::Configuration& writer);
+    http::StreamingClient::Upload::Writable streaming_post_writer(const http::Request::Configuration& configuration,
+                                                                  const http::UploadWriter::Configuration& writer,
+                                                                  const std::string& type);
+    std::shared_ptr<http::StreamingRequest> streaming_put_buffers(const http::Request::Configuration& configuration,
+                                                                  const http::StreamingClient::Upload::Buffers& buffers);
+    std::shared_ptr<http::StreamingRequest> streaming_post_buffers(const http::Request::Configuration& configuration,
+                                                                   const http::StreamingClient::Upload::Buffers& buffers,
+                                                                   const std::string& type);
+    std::shared_ptr<http::StreamingRequest> streaming_post_multipart(const http::Request::Configuration& configuration,
+                                                                     const http::StreamingClient::Multipart::Parts& parts);
+    std::shared_ptr<http::StreamingRequest> streaming_get_buffered(const http::Request::Configuration& configuration,
+                                                                   const http::StreamingClient::Buffering::Configuration& buffering);
+
+    http::Client::Metrics metrics();
 
 private:
     std::shared_ptr<curl::Request> get_impl(const http::Request::Configuration& configuration);
     std::shared_ptr<curl::Request> head_impl(const http::Request::Configuration& configuration);
     std::shared_ptr<curl::Request> post_impl(const http::Request::Configuration& configuration, const std::string&, const std::string&);
+    std::shared_ptr<curl::Request> post_impl(const http::Request::Configuration& configuration, const std::shared_ptr<const std::string>& payload, const std::string& type);
     std::shared_ptr<curl::Request> put_impl(const http::Request::Configuration& configuration, std::istream& payload, std::size_t size);
 
     std::shared_ptr<curl::Request> post_impl(const http::Request::Configuration& configuration, std::istream& payload, std::size_t size);
-    std::shared_ptr<curl::Request> post_impl(const http::Request::Configuration& configuration, std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback, std::size_t size);
-    std::shared_ptr<curl::Request> put_impl(const http::Request::Configuration& configuration, std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback, std::size_t size);
+    std::shared_ptr<curl::Request> post_impl(const http::Request::Configuration& configuration, std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback, const http::StreamingClient::Upload::Seeker& seeker, std::size_t size);
+    std::shared_ptr<curl::Request> put_impl(const http::Request::Configuration& configuration, std::function<size_t(void *dest, std::size_t buf_size)> readdata_callback, const http::StreamingClient::Upload::Seeker& seeker, std::size_t size);
     std::shared_ptr<curl::Request> del_impl(const http::Request::Configuration& configuration);
+    std::shared_ptr<curl::Request> put_impl(const http::Request::Configuration& configuration, const http::StreamingClient::FileSource::Configuration& source);
+    std::shared_ptr<curl::Request> post_form_impl(const http::Request::Configuration& configuration, const std::map<std::string, std::string>& values);
+    std::shared_ptr<curl::Request> post_impl(const http::Request::Configuration& configuration, const http::StreamingClient::FileSource::Configuration& source, const std::string& type);
+
+    // Wraps up handle in a request, attaching the client-wide facilities.
+    // body_length is the size of the request body, if any, -1 if unknown.
+    std::shared_ptr<curl::Request> make_request(http::Method method, const http::Request::Configuration& configuration, ::curl::easy::Handle handle, std::int64_t body_length = -1);
 
-    ::curl::multi::Handle multi;    
+    ::curl::multi::Handle multi;
+    Facilities facilities;
+    http::Client::Decoding::Configuration decoding;
 };
 }
 }
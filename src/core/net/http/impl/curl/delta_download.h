@@ -0,0 +1,502 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_CURL_DELTA_DOWNLOAD_H_
+#define CORE_NET_HTTP_IMPL_CURL_DELTA_DOWNLOAD_H_
+
+#include <core/net/http/streaming_client.h>
+
+#include <core/net/http/error.h>
+
+#include "request.h"
+
+#include "../byte_ranges.h"
+#include "../digest.h"
+#include "../file_sink.h"
+#include "../zsync.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+namespace curl
+{
+// Downloads a resource to a file, copying the blocks found in a local seed file
+// and fetching the missing ones, see core::net::http::StreamingClient::delta_get_to_file.
+// Once the seed has been scanned, all of the state is only ever touched from the
+// reactor the requests run on.
+class DeltaDownload : public core::net::http::StreamingRequest,
+                      public std::enable_shared_from_this<DeltaDownload>
+{
+public:
+    typedef core::net::http::StreamingClient::Delta::Configuration Configuration;
+
+    // Requests for request_configuration are derived from origin, which is never
+    // executed itself. The resource described by manifest is written to file.
+    DeltaDownload(::curl::multi::Handle multi,
+                  const std::shared_ptr<curl::Request>& origin,
+                  const core::net::http::Request::Configuration& request_configuration,
+                  const impl::ZsyncManifest& manifest,
+                  const Configuration& configuration,
+                  const std::shared_ptr<impl::FileSink>& file)
+        : atomic_state(core::net::http::Request::State::ready),
+          multi(multi),
+          origin(origin),
+          request_configuration(request_configuration),
+          manifest(manifest),
+          configuration(configuration),
+          file(file)
+    {
+    }
+
+    State state()
+    {
+        return atomic_state.load();
+    }
+
+    void set_timeout(const std::chrono::milliseconds& timeout)
+    {
+        ensure_ready();
+        this->timeout = timeout;
+    }
+
+    Response execute(const ProgressHandler& ph)
+    {
+        return execute(ph, [](const std::string&){});
+    }
+
+    // The resource goes to the file, dh is never invoked.
+    Response execute(const ProgressHandler& ph, const DataHandler&)
+    {
+        ensure_ready();
+
+        // The requests run on a reactor of their own, driven by the calling thread.
+        ::curl::multi::Handle reactor;
+        multi = reactor;
+        origin->bind(reactor);
+
+        Response response;
+        std::string error;
+        bool failed{false};
+
+        start(Handler()
+                .on_progress(ph)
+                .on_response([&response, reactor](const Response& r) mutable
+                {
+                    response = r;
+                    reactor.stop();
+                })
+                .on_error([&failed, &error, reactor](const core::net::Error& e) mutable
+                {
+                    failed = true;
+                    error = e.what();
+                    reactor.stop();
+                }));
+
+        reactor.run();
+
+        if (failed)
+            throw core::net::http::Error(error, CORE_FROM_HERE());
+
+        return response;
+    }
+
+    void async_execute(const Handler& handler)
+    {
+        async_execute(handler, [](const std::string&){});
+    }
+
+    // The resource goes to the file, dh is never invoked.
+    void async_execute(const Handler& handler, const DataHandler&)
+    {
+        ensure_ready();
+        start(handler);
+    }
+
+    std::string url_escape(const std::string& s)
+    {
+        return origin->url_escape(s);
+    }
+
+    std::string url_unescape(const std::string& s)
+    {
+        return origin->url_unescape(s);
+    }
+
+    void pause()
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        if (current)
+            current->pause();
+    }
+
+    void resume()
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        if (current)
+            current->resume();
+    }
+
+    void abort_request_if(std::uint64_t limit, const std::chrono::seconds& time)
+    {
+        ensure_ready();
+        low_speed = std::make_pair(limit, time);
+    }
+
+private:
+    // A range of the resource, the end being exclusive.
+    typedef std::pair<std::uint64_t, std::uint64_t> Range;
+
+    void ensure_ready()
+    {
+        if (atomic_state.load() != core::net::http::Request::State::ready)
+            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
+    }
+
+    void start(const Handler& handler)
+    {
+        atomic_state.store(core::net::http::Request::State::active);
+        this->handler = handler;
+
+        // Scanning the seed takes a while, better not to hold up the reactor with it.
+        try
+        {
+            assemble();
+        } catch(const std::exception& e)
+        {
+            failure = e.what();
+        }
+
+        auto thiz = shared_from_this();
+        multi.dispatch([thiz]()
+        {
+            if (thiz->failure.empty())
+                thiz->next();
+            else
+                thiz->complete();
+        });
+    }
+
+    // Copies the blocks found in the seed and queues up the missing ones.
+    void assemble()
+    {
+        if (not file->begin(core::net::http::Status::ok, core::net::http::Header{}, manifest.length))
+            throw std::runtime_error(file->error());
+
+        std::vector<std::int64_t> offsets(manifest.blocks(), -1);
+
+        int seed = configuration.seed.empty() ? -1 : ::open(configuration.seed.c_str(), O_RDONLY | O_CLOEXEC);
+        if (seed != -1)
+        {
+            try
+            {
+                offsets = impl::locate(manifest, seed);
+
+                std::vector<char> block(manifest.block_size);
+                for (std::size_t i = 0; i < offsets.size(); i++)
+                {
+                    if (offsets[i] < 0)
+                        continue;
+
+                    // Blocks found at the end of the seed are padded with zeros.
+                    std::fill(block.begin(), block.end(), 0);
+                    if (::pread(seed, block.data(), block.size(), offsets[i]) < 0)
+                        throw std::system_error{errno, std::system_category(), "Could not read " + configuration.seed};
+
+                    auto first = static_cast<std::uint64_t>(i) * manifest.block_size;
+                    write(first, block.data(), std::min<std::uint64_t>(manifest.block_size, manifest.length - first));
+                }
+            } catch(...)
+            {
+                ::close(seed);
+                throw;
+            }
+
+            ::close(seed);
+        }
+
+        // Runs of missing blocks, split into pieces that fit into a request.
+        auto max_size = std::max<std::uint64_t>(configuration.max_request_size, manifest.block_size);
+
+        for (std::size_t i = 0; i < offsets.size(); i++)
+        {
+            if (offsets[i] >= 0)
+                continue;
+
+            auto first = static_cast<std::uint64_t>(i) * manifest.block_size;
+            auto last = std::min<std::uint64_t>(first + manifest.block_size, manifest.length);
+
+            if (not missing.empty() && missing.back().second == first && missing.back().second - missing.back().first < max_size)
+                missing.back().second = last;
+            else
+                missing.push_back(Range{first, last});
+
+            total += last - first;
+        }
+    }
+
+    // Requests the next batch of missing ranges, or completes the download if there are none.
+    void next()
+    {
+        if (missing.empty())
+        {
+            complete();
+            return;
+        }
+
+        // Ranges close to each other are requested as one span, the bytes in
+        // between cost less than the overhead of another part.
+        std::vector<Range> batch, spans;
+        std::uint64_t size{0};
+        auto max_size = std::max<std::uint64_t>(configuration.max_request_size, manifest.block_size);
+
+        while (not missing.empty())
+        {
+            auto range = missing.front();
+            bool joins = not spans.empty() && range.first - spans.back().second <= configuration.max_gap;
+            auto added = joins ? range.second - spans.back().second : range.second - range.first;
+
+            if (not batch.empty() && (size + added > max_size || (not joins && spans.size() >= std::max<std::size_t>(configuration.max_ranges, 1))))
+                break;
+
+            if (joins)
+                spans.back().second = range.second;
+            else
+                spans.push_back(range);
+
+            size += added;
+            batch.push_back(range);
+            missing.pop_front();
+        }
+
+        std::string value{"bytes="};
+        for (const auto& span : spans)
+            value += (value.size() > 6 ? "," : "") + std::to_string(span.first) + "-" + std::to_string(span.second - 1);
+
+        auto configuration = request_configuration;
+        configuration.header.set("Range", value);
+
+        auto request = origin->derive(core::net::http::Method::get, configuration);
+
+        if (timeout.count() > 0)
+            request->set_timeout(timeout);
+
+        if (low_speed.second.count() > 0)
+            request->abort_request_if(low_speed.first, low_speed.second);
+
+        {
+            std::lock_guard<std::mutex> lg(guard);
+            current = request;
+        }
+
+        auto thiz = shared_from_this();
+        // Invoked from the reactor, which does not take in new transfers from there.
+        multi.dispatch([thiz, request, batch]()
+        {
+            request->async_execute(
+                        Handler()
+                            .on_progress([thiz](const Progress& progress) { return thiz->progress(progress); })
+                            .on_response([thiz, batch](const Response& response) { thiz->received(batch, response); })
+                            .on_error([thiz](const core::net::Error& e) { thiz->failure = e.what(); thiz->complete(); }),
+                        [](const std::string&) {});
+        });
+    }
+
+    // Writes the parts of response that fall into the ranges of batch, queueing up what is left.
+    void received(const std::vector<Range>& batch, const Response& response)
+    {
+        auto parts = impl::body_parts(response);
+        std::uint64_t written{0};
+        std::deque<Range> left;
+
+        for (const auto& range : batch)
+        {
+            // Parts come in ascending order, see RFC 7233, section 4.1.
+            auto position = range.first;
+
+            for (const auto& part : parts)
+            {
+                auto first = std::max(position, part.first);
+                auto last = std::min(range.second, part.first + part.size);
+
+                if (first >= last)
+                    continue;
+
+                if (first > position)
+                    left.push_back(Range{position, first});
+
+                try
+                {
+                    write(first, response.body.data() + part.offset + (first - part.first), last - first);
+                } catch(const std::exception& e)
+                {
+                    failure = e.what();
+                    complete();
+                    return;
+                }
+
+                written += last - first;
+                position = last;
+            }
+
+            if (position < range.second)
+                left.push_back(Range{position, range.second});
+        }
+
+        if (written == 0)
+        {
+            failure = "Unexpected response to range request, status " + std::to_string(static_cast<int>(response.status));
+            complete();
+            return;
+        }
+
+        fetched += written;
+        last_response = response;
+
+        // Servers answering with a subset of the ranges get asked for the rest.
+        missing.insert(missing.begin(), left.begin(), left.end());
+        next();
+    }
+
+    Progress::Next progress(const Progress&)
+    {
+        if (not handler.on_progress())
+            return Progress::Next::continue_operation;
+
+        Progress progress;
+        progress.download.total = total;
+        progress.download.current = fetched;
+
+        return handler.on_progress()(progress);
+    }
+
+    // Writes size bytes at position of the resource to the file, throwing on failure.
+    void write(std::uint64_t position, const char* data, std::uint64_t size)
+    {
+        auto segment = file->segment(position, size);
+        if (not segment->begin(core::net::http::Status::partial_content, core::net::http::Header{}, size) ||
+            not segment->write(data, size))
+            throw std::runtime_error(segment->error());
+
+        segment->finish();
+        file->adopt(*segment);
+    }
+
+    // Checks the file against the block checksums and the checksum of the complete resource.
+    void verify()
+    {
+        std::vector<char> block(manifest.block_size);
+        impl::Sha1 sha1;
+
+        for (std::size_t i = 0; i < manifest.blocks(); i++)
+        {
+            auto first = static_cast<std::uint64_t>(i) * manifest.block_size;
+            auto size = file->read(first, block.data(), std::min<std::uint64_t>(manifest.block_size, manifest.length - first));
+
+            if (manifest.checksum(reinterpret_cast<const unsigned char*>(block.data()), size) != manifest.strong[i])
+                throw std::runtime_error("Block " + std::to_string(i) + " does not match its checksum");
+
+            sha1.update(block.data(), size);
+        }
+
+        if (not manifest.sha1.empty() && impl::to_hex(sha1.digest()) != manifest.sha1)
+            throw std::runtime_error("The assembled file does not match its SHA-1 checksum");
+    }
+
+    // Reports the outcome once there is nothing left to fetch, or fetching failed.
+    void complete()
+    {
+        {
+            std::lock_guard<std::mutex> lg(guard);
+            current.reset();
+        }
+
+        if (failure.empty())
+        {
+            try
+            {
+                verify();
+                file->finish();
+            } catch(const std::exception& e)
+            {
+                failure = e.what();
+            }
+        }
+
+        if (not failure.empty())
+            file->abort();
+
+        atomic_state.store(core::net::http::Request::State::done);
+
+        if (not failure.empty())
+        {
+            if (handler.on_error())
+                handler.on_error()(core::net::http::Error(failure, CORE_FROM_HERE()));
+            return;
+        }
+
+        Response response;
+        response.status = core::net::http::Status::ok;
+        response.header = last_response.header;
+
+        if (handler.on_response())
+            handler.on_response()(response);
+    }
+
+    std::atomic<core::net::http::Request::State> atomic_state;
+    ::curl::multi::Handle multi;
+    std::shared_ptr<curl::Request> origin;
+    core::net::http::Request::Configuration request_configuration;
+    impl::ZsyncManifest manifest;
+    Configuration configuration;
+    std::shared_ptr<impl::FileSink> file;
+
+    std::chrono::milliseconds timeout{0};
+    std::pair<std::uint64_t, std::chrono::seconds> low_speed{0, std::chrono::seconds{0}};
+
+    Handler handler;
+    // The ranges still to be fetched, in ascending order.
+    std::deque<Range> missing;
+    // Number of bytes to be fetched, and fetched so far.
+    std::uint64_t total{0};
+    std::uint64_t fetched{0};
+    Response last_response;
+    // The reason the download failed, empty unless it did.
+    std::string failure;
+
+    // Guards current, which pause and resume are invoked for from other threads.
+    std::mutex guard;
+    std::shared_ptr<curl::Request> current;
+};
+}
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_CURL_DELTA_DOWNLOAD_H_
@@ -22,6 +22,7 @@
 #include "shared.h"
 
 #include <cassert>
+#include <cstdio>
 
 #include <atomic>
 #include <chrono>
@@ -162,11 +163,15 @@ struct easy::Handle::Private
     easy::Handle::OnFinished on_finished_cb;
     easy::Handle::OnProgress on_progress;
     easy::Handle::OnReadData on_read_data_cb;
+    easy::Handle::OnSeekData on_seek_data_cb;
     easy::Handle::OnWriteData on_write_data_cb;
     easy::Handle::OnWriteHeader on_write_header_cb;
 
     ::curl::StringList* header_string_list;
     char error[CURL_ERROR_SIZE];
+
+    // Posted by the handle, without being copied by curl.
+    std::shared_ptr<const std::string> post_data;
 };
 
 int easy::Handle::progress_cb(void* data, double dltotal, double dlnow, double ultotal, double ulnow)
@@ -225,6 +230,17 @@ std::size_t easy::Handle::read_data_cb(void* data, std::size_t size, std::size_t
     return did_not_consume_any_data;
 }
 
+int easy::Handle::seek_data_cb(void* cookie, curl_off_t offset, int origin)
+{
+    auto thiz = static_cast<easy::Handle::Private*>(cookie);
+
+    // curl only ever rewinds to an offset from the start of the data.
+    if (not thiz || not thiz->on_seek_data_cb || origin != SEEK_SET || offset < 0)
+        return CURL_SEEKFUNC_CANTSEEK;
+
+    return thiz->on_seek_data_cb(offset) ? CURL_SEEKFUNC_OK : CURL_SEEKFUNC_CANTSEEK;
+}
+
 easy::Handle::HandleHasBeenAbandoned::HandleHasBeenAbandoned()
     : std::runtime_error("Handle has been abandoned.")
 {
@@ -333,6 +349,18 @@ easy::Handle& easy::Handle::on_read_data(const easy::Handle::OnReadData& on_read
     return *this;
 }
 
+easy::Handle& easy::Handle::on_seek_data(const easy::Handle::OnSeekData& on_seek_data)
+{
+    if (!d) throw easy::Handle::HandleHasBeenAbandoned{};
+
+    set_option(Option::seek_function, Handle::seek_data_cb);
+    set_option(Option::seek_data, d.get());
+
+    d->on_seek_data_cb = on_seek_data;
+
+    return *this;
+}
+
 easy::Handle& easy::Handle::on_write_data(const easy::Handle::OnWriteData& on_new_data)
 {
     if (!d) throw easy::Handle::HandleHasBeenAbandoned{};
@@ -388,13 +416,16 @@ easy::Handle& easy::Handle::method(core::net::http::Method method)
     return *this;
 }
 
-easy::Handle& easy::Handle::post_data(const std::string& data, const std::string&)
+easy::Handle& easy::Handle::post_data(const std::shared_ptr<const std::string>& data, const std::string&)
 {
     if (!d) throw easy::Handle::HandleHasBeenAbandoned{};
 
-    long content_length = data.size();
-    set_option(Option::post_field_size, content_length);
-    set_option(Option::copy_postfields, data.c_str());
+    // curl refers to the data for as long as the handle lives.
+    d->post_data = data;
+
+    curl_off_t content_length = data->size();
+    set_option(Option::post_field_size_large, content_length);
+    set_option(Option::postfields, data->data());
 
     return *this;
 }
@@ -429,6 +460,42 @@ core::net::http::Status easy::Handle::status()
     return static_cast<core::net::http::Status>(result);
 }
 
+std::uint64_t easy::Handle::download_size()
+{
+    if (!d) throw easy::Handle::HandleHasBeenAbandoned{};
+
+    curl_off_t result;
+    get_option(curl::Info::size_download, &result);
+    return static_cast<std::uint64_t>(result);
+}
+
+std::int64_t easy::Handle::content_length()
+{
+    if (!d) throw easy::Handle::HandleHasBeenAbandoned{};
+
+    curl_off_t result;
+    get_option(curl::Info::content_length_download, &result);
+    return static_cast<std::int64_t>(result);
+}
+
+std::uint64_t easy::Handle::upload_size()
+{
+    if (!d) throw easy::Handle::HandleHasBeenAbandoned{};
+
+    curl_off_t result;
+    get_option(curl::Info::size_upload, &result);
+    return static_cast<std::uint64_t>(result);
+}
+
+std::int64_t easy::Handle::upload_length()
+{
+    if (!d) throw easy::Handle::HandleHasBeenAbandoned{};
+
+    curl_off_t result;
+    get_option(curl::Info::content_length_upload, &result);
+    return static_cast<std::int64_t>(result);
+}
+
 easy::native::Handle easy::Handle::native() const
 {
     if (!d) throw easy::Handle::HandleHasBeenAbandoned{};
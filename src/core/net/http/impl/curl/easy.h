@@ -29,6 +29,7 @@
 #include <curl/curl.h>
 
 #include <chrono>
+#include <cstdint>
 #include <iosfwd>
 #include <sstream>
 #include <system_error>
@@ -90,7 +91,9 @@ enum class Code
     ssl_issuer_error = CURLE_SSL_ISSUER_ERROR,
     chunk_failed = CURLE_CHUNK_FAILED,
     no_connection_available = CURLE_NO_CONNECTION_AVAILABLE,
-    no_readfunc_abort = CURL_READFUNC_ABORT
+    no_readfunc_abort = CURL_READFUNC_ABORT,
+    no_readfunc_pause = CURL_READFUNC_PAUSE,
+    no_writefunc_pause = CURL_WRITEFUNC_PAUSE
 };
 
 std::ostream& operator<<(std::ostream& out, Code code);
@@ -103,7 +106,11 @@ enum class Info
     appconnect_time = CURLINFO_APPCONNECT_TIME,
     pretransfer_time = CURLINFO_PRETRANSFER_TIME,
     starttransfer_time = CURLINFO_STARTTRANSFER_TIME,
-    total_time = CURLINFO_TOTAL_TIME
+    total_time = CURLINFO_TOTAL_TIME,
+    size_download = CURLINFO_SIZE_DOWNLOAD_T,
+    content_length_download = CURLINFO_CONTENT_LENGTH_DOWNLOAD_T,
+    size_upload = CURLINFO_SIZE_UPLOAD_T,
+    content_length_upload = CURLINFO_CONTENT_LENGTH_UPLOAD_T
 };
 
 enum class Option
@@ -119,6 +126,8 @@ enum class Option
     write_data = CURLOPT_WRITEDATA,
     read_function = CURLOPT_READFUNCTION,
     read_data = CURLOPT_READDATA,
+    seek_function = CURLOPT_SEEKFUNCTION,
+    seek_data = CURLOPT_SEEKDATA,
     url = CURLOPT_URL,
     user_agent = CURLOPT_USERAGENT,
     http_header = CURLOPT_HTTPHEADER,
@@ -127,9 +136,13 @@ enum class Option
     http_post = CURLOPT_POST,
     http_put = CURLOPT_PUT,
     copy_postfields = CURLOPT_COPYPOSTFIELDS,
+    postfields = CURLOPT_POSTFIELDS,
     post_field_size = CURLOPT_POSTFIELDSIZE,
     upload = CURLOPT_UPLOAD,
     in_file_size = CURLOPT_INFILESIZE,
+    in_file_size_large = CURLOPT_INFILESIZE_LARGE,
+    post_field_size_large = CURLOPT_POSTFIELDSIZE_LARGE,
+    upload_buffer_size = CURLOPT_UPLOAD_BUFFERSIZE,
     sharing = CURLOPT_SHARE,
     username = CURLOPT_USERNAME,
     password = CURLOPT_PASSWORD,
@@ -141,7 +154,13 @@ enum class Option
     ssl_verify_host = CURLOPT_SSL_VERIFYHOST,
     customrequest = CURLOPT_CUSTOMREQUEST,
     low_speed_limit = CURLOPT_LOW_SPEED_LIMIT,
-    low_speed_time = CURLOPT_LOW_SPEED_TIME
+    low_speed_time = CURLOPT_LOW_SPEED_TIME,
+    accept_encoding = CURLOPT_ACCEPT_ENCODING,
+    buffer_size = CURLOPT_BUFFERSIZE,
+    no_body = CURLOPT_NOBODY,
+    follow_location = CURLOPT_FOLLOWLOCATION,
+    max_redirects = CURLOPT_MAXREDIRS,
+    expect_100_timeout_ms = CURLOPT_EXPECT_100_TIMEOUT_MS
 };
 
 namespace native
@@ -270,6 +289,8 @@ public:
     typedef std::function<int(void*, double, double, double, double)> OnProgress;
     // Function type that gets called whenever data should be read.
     typedef std::function<std::size_t(void*, std::size_t, std::size_t)> OnReadData;
+    // Function type that gets called to rewind the data read to the given offset, returning false if that is not possible.
+    typedef std::function<bool(std::uint64_t)> OnSeekData;
     // Function type that gets called whenever body/payload data should be written.
     typedef std::function<std::size_t(char*, std::size_t, std::size_t)> OnWriteData;
     // Function type that gets called whenever header data should be written.
@@ -328,19 +349,29 @@ public:
     Handle& on_progress(const OnProgress& on_progress);
     // Sets the OnReadData handler.
     Handle& on_read_data(const OnReadData& on_read_data, std::size_t size);
+    // Sets the OnSeekData handler, allowing curl to send the data read again for redirects and authentication.
+    Handle& on_seek_data(const OnSeekData& on_seek_data);
     // Sets the OnWriteData handler.
     Handle& on_write_data(const OnWriteData& on_new_data);
     // Sets the OnWriteHeader handler.
     Handle& on_write_header(const OnWriteHeader& on_new_header);
     // Sets the http method used by this instance.
     Handle& method(core::net::http::Method method);
-    // Sets the data to be posted by this instance.
-    Handle& post_data(const std::string& data, const std::string&);
+    // Sets the data to be posted by this instance, which keeps it alive instead of copying it.
+    Handle& post_data(const std::shared_ptr<const std::string>& data, const std::string&);
     // Sets custom request headers
     Handle& header(const core::net::http::Header& header);
 
     // Queries the current status of this instance.
     core::net::http::Status status();
+    // Queries the number of body bytes received by the last transfer, before any decoding.
+    std::uint64_t download_size();
+    // Queries the announced size of the body being received, -1 if unknown.
+    std::int64_t content_length();
+    // Queries the number of body bytes sent by the last transfer.
+    std::uint64_t upload_size();
+    // Queries the announced size of the body being sent, -1 if unknown.
+    std::int64_t upload_length();
     // Queries the native curl easy handle.
     native::Handle native() const;
 
@@ -365,6 +396,7 @@ public:
 private:
     static int progress_cb(void* data, double dltotal, double dlnow, double ultotal, double ulnow);
     static std::size_t read_data_cb(void* data, std::size_t size, std::size_t nmemb, void *cookie);
+    static int seek_data_cb(void* cookie, curl_off_t offset, int origin);
     static std::size_t write_data_cb(char* data, size_t size, size_t nmemb, void* cookie);
     static std::size_t write_header_cb(void* data, size_t size, size_t nmemb, void* cookie);
 
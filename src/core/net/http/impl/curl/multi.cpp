@@ -192,8 +192,9 @@ struct multi::Handle::Private
                multi::native::Socket native);
         ~Socket();
 
-        void async_wait_for_readable(const std::weak_ptr<Handle::Private>& context);
-        void async_wait_for_writeable(const std::weak_ptr<Handle::Private>& context);
+        // Waits for the events given by action, one of CURL_POLL_*, no longer
+        // waiting for those left out.
+        void watch(const std::weak_ptr<Handle::Private>& context, int action);
 
         struct Private : public std::enable_shared_from_this<Private>
         {
@@ -202,10 +203,15 @@ struct multi::Handle::Private
             ~Private();
 
             void cancel();
+            void watch(const std::weak_ptr<Handle::Private>& context, int action);
             void async_wait_for_readable(const std::weak_ptr<Handle::Private>& context);
             void async_wait_for_writeable(std::weak_ptr<Handle::Private> context);
 
             bool cancel_requested;
+            // The events curl is interested in, and the waits in flight.
+            int wanted{CURL_POLL_NONE};
+            bool reading{false};
+            bool writing{false};
             boost::asio::posix::stream_descriptor sd;
         };
         std::shared_ptr<Private> d;
@@ -454,14 +460,9 @@ multi::Handle::Private::Socket::~Socket()
     d->cancel();
 }
 
-void multi::Handle::Private::Socket::async_wait_for_readable(const std::weak_ptr<multi::Handle::Private>& context)
+void multi::Handle::Private::Socket::watch(const std::weak_ptr<multi::Handle::Private>& context, int action)
 {
-    d->async_wait_for_readable(context);
-}
-
-void multi::Handle::Private::Socket::async_wait_for_writeable(const std::weak_ptr<multi::Handle::Private>& context)
-{
-    d->async_wait_for_writeable(context);
+    d->watch(context, action);
 }
 
 multi::Handle::Private::Socket::Socket::Private::Private(boost::asio::io_service& dispatcher,
@@ -482,8 +483,23 @@ void multi::Handle::Private::Socket::Socket::Private::cancel()
     sd.release();
 }
 
+void multi::Handle::Private::Socket::Socket::Private::watch(const std::weak_ptr<multi::Handle::Private>& context, int action)
+{
+    // A socket that is not waited for is left alone, e.g., while its transfer
+    // is paused. Waiting regardless would keep waking up curl for nothing.
+    wanted = action;
+
+    if ((wanted & CURL_POLL_IN) && not reading)
+        async_wait_for_readable(context);
+
+    if ((wanted & CURL_POLL_OUT) && not writing)
+        async_wait_for_writeable(context);
+}
+
 void multi::Handle::Private::Socket::Socket::Private::async_wait_for_readable(const std::weak_ptr<multi::Handle::Private>& context)
 {
+    reading = true;
+
     std::weak_ptr<Private> self{shared_from_this()};
     sd.async_read_some(boost::asio::null_buffers{}, [self, context](const boost::system::error_code& ec, std::size_t)
     {
@@ -499,6 +515,10 @@ void multi::Handle::Private::Socket::Socket::Private::async_wait_for_readable(co
             {
                 std::lock_guard<std::mutex> lg(spc->guard);
 
+                sp->reading = false;
+                if (not (sp->wanted & CURL_POLL_IN))
+                    return;
+
                 int bitmask{0};
 
                 if (ec)
@@ -514,8 +534,9 @@ void multi::Handle::Private::Socket::Socket::Private::async_wait_for_readable(co
                 if (result.second <= 0)
                     spc->timeout.cancel();
 
-                // Restart
-                sp->async_wait_for_readable(context);
+                // Restart, unless curl has lost interest or already did meanwhile.
+                if ((sp->wanted & CURL_POLL_IN) && not sp->reading)
+                    sp->async_wait_for_readable(context);
             }
         }
     });
@@ -524,6 +545,8 @@ void multi::Handle::Private::Socket::Socket::Private::async_wait_for_readable(co
 void multi::Handle::Private::Socket::Socket::Private::async_wait_for_writeable(
         std::weak_ptr<multi::Handle::Private> context)
 {
+    writing = true;
+
     std::weak_ptr<Private> self(shared_from_this());
     sd.async_write_some(boost::asio::null_buffers{}, [self, context](const boost::system::error_code& ec, std::size_t)
     {
@@ -539,6 +562,10 @@ void multi::Handle::Private::Socket::Socket::Private::async_wait_for_writeable(
             {
                 std::lock_guard<std::mutex> lg(spc->guard);
 
+                sp->writing = false;
+                if (not (sp->wanted & CURL_POLL_OUT))
+                    return;
+
                 int bitmask{0};
 
                 if (ec)
@@ -553,9 +580,11 @@ void multi::Handle::Private::Socket::Socket::Private::async_wait_for_writeable(
 
                 if (result.second <= 0)
                     spc->timeout.cancel();
+
+                // Restart, unless curl has lost interest or already did meanwhile.
+                if ((sp->wanted & CURL_POLL_OUT) && not sp->writing)
+                    sp->async_wait_for_writeable(context);
             }
-            // Restart
-            sp->async_wait_for_writeable(context);
         }
     });
 }
@@ -586,18 +615,10 @@ int multi::Handle::Private::socket_callback(
     switch (action)
     {
     case CURL_POLL_NONE:
-    {
-        break;
-    }
     case CURL_POLL_IN:
-        socket->async_wait_for_readable(thiz);
-        break;
     case CURL_POLL_OUT:
-        socket->async_wait_for_writeable(thiz);
-        break;
     case CURL_POLL_INOUT:
-        socket->async_wait_for_readable(thiz);
-        socket->async_wait_for_writeable(thiz);
+        socket->watch(thiz, action);
         break;
     case CURL_POLL_REMOVE:
     {
@@ -27,10 +27,14 @@
 #include "client.h"
 #include "curl.h"
 
+#include "../buffered_reader.h"
+#include "../file_sink.h"
+#include "../host.h"
+#include "../receive_buffer.h"
+
 #include <algorithm>
 #include <atomic>
 #include <iostream>
-#include <regex>
 #include <sstream>
 
 namespace core
@@ -39,30 +43,67 @@ namespace net
 {
 namespace http
 {
-// A regex for parsing key,value pairs from an http header line.
-std::regex header_line{"\\s*(\\S*)\\s*:\\s*(\\S*)\\s*"};
 namespace impl
 {
 namespace curl
 {
 
 // See http://www.w3.org/Protocols/rfc2616/rfc2616-sec4.html
-std::tuple<std::string, std::string> parse_header_line(const char* line, std::size_t size)
+// Splits a header line at the first colon, stripping surrounding whitespace from
+// name and value. Values may contain whitespace, e.g. "Date: Tue, 15 Nov 1994 08:12:31 GMT".
+inline std::tuple<std::string, std::string> parse_header_line(const char* line, std::size_t size)
 {
-    std::cmatch matches;
+    static constexpr const char* whitespace{" \t\r\n"};
+
+    std::string s{line, size};
+
+    auto colon = s.find(':');
+    if (colon == std::string::npos)
+        return std::make_tuple(std::string{}, std::string{});
+
+    auto trim = [](const std::string& in)
+    {
+        auto begin = in.find_first_not_of(whitespace);
+        if (begin == std::string::npos)
+            return std::string{};
 
-    if (not std::regex_match(line, line + size, matches, http::header_line))
+        return in.substr(begin, in.find_last_not_of(whitespace) - begin + 1);
+    };
+
+    auto key = trim(s.substr(0, colon));
+    // Header field names do not contain whitespace, the line is not a header field then.
+    if (key.find_first_of(whitespace) != std::string::npos)
         return std::make_tuple(std::string{}, std::string{});
 
-    return std::make_tuple(matches.str(1), matches.str(2));
+    return std::make_tuple(key, trim(s.substr(colon + 1)));
 }
 
-std::tuple<std::string, std::string, std::size_t> handle_header_line(void* data, std::size_t size, std::size_t nmemb)
+inline std::tuple<std::string, std::string, std::size_t> handle_header_line(void* data, std::size_t size, std::size_t nmemb)
 {
     std::size_t length = size * nmemb;
     return std::tuple_cat(parse_header_line(static_cast<const char*>(data), length), std::make_tuple(length));
 }
 
+// Returns true if a request body of size bytes, -1 if unknown, is announced
+// with Expect: 100-continue, by the caller or following the configured policy.
+inline bool expects_continue(const core::net::http::Request::Configuration& configuration, std::int64_t size)
+{
+    if (configuration.header.has("Expect"))
+        return configuration.header.has("Expect", "100-continue");
+
+    switch (configuration.expect_continue.policy)
+    {
+    case core::net::http::Request::ExpectContinue::never:
+        return false;
+    case core::net::http::Request::ExpectContinue::always:
+        return true;
+    case core::net::http::Request::ExpectContinue::above_threshold:
+        break;
+    }
+
+    return size < 0 || static_cast<std::uint64_t>(size) >= configuration.expect_continue.threshold;
+}
+
 // Make sure that we switch the state back to idle whenever an instance
 // of StateGuard goes out of scope.
 struct StateGuard
@@ -87,16 +128,28 @@ class Request : public core::net::http::StreamingRequest,
 public:
 
     static std::shared_ptr<Request> create(::curl::multi::Handle multi,
-                                           ::curl::easy::Handle easy)
+                                           ::curl::easy::Handle easy,
+                                           core::net::http::Method method = core::net::http::Method::get,
+                                           const Request::Configuration& configuration = Request::Configuration{},
+                                           const Facilities& facilities = Facilities{})
     {
-        return std::make_shared<Request>(multi, easy);
+        return std::make_shared<Request>(multi, easy, method, configuration, facilities);
     }
 
     Request(::curl::multi::Handle multi,
-            ::curl::easy::Handle easy)
+            ::curl::easy::Handle easy,
+            core::net::http::Method method = core::net::http::Method::get,
+            const Request::Configuration& configuration = Request::Configuration{},
+            const Facilities& facilities = Facilities{})
         : atomic_state(core::net::http::Request::State::ready),
           multi(multi),
-          easy(easy)
+          easy(easy),
+          facilities(facilities),
+          method(method),
+          uri(configuration.uri),
+          configuration(configuration),
+          affinity_key(configuration.affinity_key),
+          coalescing_key(facilities.coalescer ? facilities.coalescer->key_for(method, configuration) : std::string{})
     {
     }
 
@@ -117,6 +170,12 @@ public:
         easy.set_option(::curl::Option::timeout_ms, adjusted_timeout);
     }
 
+    // Sets the size of the request body, -1 if unknown, as it decided on Expect: 100-continue.
+    void set_body_length(std::int64_t length)
+    {
+        body_length = length;
+    }
+
     Response execute(const Request::ProgressHandler& ph)
     {
         return execute(ph, [](const std::string&){});
@@ -127,7 +186,450 @@ public:
         if (atomic_state.load() != core::net::http::Request::State::ready)
             throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
 
+        impl::Cache::Lookup lookup;
+
+        if (facilities.cache && not sink)
+        {
+            lookup = facilities.cache->lookup(method, uri, configuration.decoding, configuration.header);
+
+            if (lookup.result == impl::Cache::Lookup::Result::fresh ||
+                lookup.result == impl::Cache::Lookup::Result::unsatisfiable)
+            {
+                StateGuard sg{atomic_state};
+
+                auto response = serve(lookup);
+                if (not response.body.empty())
+                    dh(response.body);
+
+                refresh(lookup);
+
+                return response;
+            }
+        }
+
+        if (coalescing_key.empty())
+            return execute_cached(lookup, ph, dh);
+
+        bool leader{false};
+        auto flight = facilities.coalescer->join(coalescing_key, leader);
+
+        if (not leader)
+        {
+            StateGuard sg{atomic_state};
+
+            auto response = flight->wait();
+            if (not response.body.empty())
+                dh(response.body);
+
+            return response;
+        }
+
+        try
+        {
+            auto response = execute_cached(lookup, ph, dh);
+            facilities.coalescer->complete(coalescing_key, flight, response);
+            return response;
+        } catch(...)
+        {
+            facilities.coalescer->complete(coalescing_key, flight, Response{}, std::current_exception());
+            throw;
+        }
+    }
+
+    void async_execute(const Request::Handler& handler)
+    {
+        async_execute(handler, [](const std::string&){});
+    }
+
+    void async_execute(const Request::Handler& handler, const StreamingRequest::DataHandler& dh)
+    {
+        if (atomic_state.load() != core::net::http::Request::State::ready)
+            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
+
+        impl::Cache::Lookup lookup;
+
+        if (facilities.cache && not sink)
+        {
+            lookup = facilities.cache->lookup(method, uri, configuration.decoding, configuration.header);
+
+            if (lookup.result == impl::Cache::Lookup::Result::fresh ||
+                lookup.result == impl::Cache::Lookup::Result::unsatisfiable)
+            {
+                auto sg = std::make_shared<StateGuard>(atomic_state);
+                auto response = serve(lookup);
+
+                multi.dispatch([sg, handler, dh, response]()
+                {
+                    if (not response.body.empty())
+                        dh(response.body);
+
+                    if (handler.on_response())
+                        handler.on_response()(response);
+                });
+
+                refresh(lookup);
+
+                return;
+            }
+        }
+
+        if (coalescing_key.empty())
+        {
+            async_execute_cached(lookup, handler, dh);
+            return;
+        }
+
+        bool leader{false};
+        auto flight = facilities.coalescer->join(coalescing_key, leader);
+
+        if (not leader)
+        {
+            join(flight, handler, dh);
+            return;
+        }
+
+        // Hand out the outcome to all requests that joined in the meantime,
+        // before reporting to the handler of the leading request.
+        auto coalescer = facilities.coalescer;
+        auto key = coalescing_key;
+
+        Request::Handler leading{handler};
+        leading.on_response([coalescer, key, flight, handler](const Response& response)
+        {
+            coalescer->complete(key, flight, response);
+            if (handler.on_response())
+                handler.on_response()(response);
+        });
+        leading.on_error([coalescer, key, flight, handler](const core::net::Error& e)
+        {
+            coalescer->complete(key, flight, Response{}, std::make_exception_ptr(e));
+            if (handler.on_error())
+                handler.on_error()(e);
+        });
+
+        // Requests that joined must not wait forever if the transfer does not even start,
+        // e.g. if the host does not accept requests right now.
+        try
+        {
+            async_execute_cached(lookup, leading, dh);
+        } catch(...)
+        {
+            coalescer->complete(key, flight, Response{}, std::current_exception());
+            throw;
+        }
+    }
+
+    std::string url_escape(const std::string& s)
+    {
+        return easy.escape(s);
+    }
+
+    std::string url_unescape(const std::string& s)
+    {
+        return easy.unescape(s);
+    }
+
+    void pause()
+    {   
+        auto copy = easy;
+        multi.dispatch([copy]() mutable
+        {   
+            try 
+            {   
+                copy.pause();
+            }   
+            catch(...) {}
+        }); 
+    }    
+
+    void resume()
+    {   
+        auto copy = easy;
+        multi.dispatch([copy]() mutable
+        {   
+            try 
+            {   
+                copy.resume();
+            }   
+            catch(...) {}
+        }); 
+    }   
+
+    // Writes the body of a successful response to sink instead of handing it out.
+    void write_to(const std::shared_ptr<impl::FileSink>& sink)
+    {
+        if (atomic_state.load() != core::net::http::Request::State::ready)
+            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
+
+        this->sink = sink;
+        // The body never makes it into a response that could be shared.
+        coalescing_key.clear();
+        // Larger chunks from curl mean fewer calls into the sink.
+        easy.set_option(::curl::Option::buffer_size, sink_buffer_size);
+
+        // Ask for the remainder of an interrupted download, or the complete
+        // body if the representation has changed in the meantime.
+        if (sink->resume_offset() > 0)
+        {
+            core::net::http::Header header;
+            header.add("Range", "bytes=" + std::to_string(sink->resume_offset()) + "-");
+            header.add("If-Range", sink->resume_validator());
+            easy.header(header);
+        }
+    }
+
+    // Hands the body to buffer instead of to the data handler, pausing the transfer while
+    // the buffer is full. The buffer's wake-up resumes it, the request has to be executed
+    // asynchronously as the buffer is drained on another thread.
+    void receive_into(const std::shared_ptr<impl::ReceiveBuffer>& buffer)
+    {
+        if (atomic_state.load() != core::net::http::Request::State::ready)
+            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
+
+        this->buffer = buffer;
+        // The body never makes it into a response that could be shared or cached.
+        coalescing_key.clear();
+        facilities.cache.reset();
+    }
+
+    // Executes the request asynchronously, handing the body to the returned reader.
+    // The handlers of handler are invoked once the reader has been told the outcome.
+    std::shared_ptr<core::net::http::BodyReader> open(const core::net::http::BodyReader::Configuration& configuration,
+                                                      const Request::Handler& handler = Request::Handler{})
+    {
+        if (sink)
+            throw core::net::http::Error("The body of the request is written to a file", CORE_FROM_HERE());
+
+        // Resuming is dispatched to the reactor, never running into the transfer.
+        std::weak_ptr<Request> wp{shared_from_this()};
+        auto buffer = std::make_shared<impl::ReceiveBuffer>(configuration.capacity, [wp]()
+        {
+            if (auto sp = wp.lock())
+                sp->resume();
+        });
+
+        receive_into(buffer);
+
+        // The reader may go away before the transfer completes, the buffer stays.
+        async_execute(
+                    Request::Handler()
+                        .on_progress(handler.on_progress())
+                        .on_response([buffer, handler](const Response& response)
+                        {
+                            buffer->finish(response);
+                            if (handler.on_response())
+                                handler.on_response()(response);
+                        })
+                        .on_error([buffer, handler](const core::net::Error& e)
+                        {
+                            buffer->fail(std::make_exception_ptr(e));
+                            if (handler.on_error())
+                                handler.on_error()(e);
+                        }),
+                    [](const std::string&) {});
+
+        return std::make_shared<impl::BufferedReader>(buffer, configuration);
+    }
+
+    // Sends the size bytes handed out by reader as the body of the request.
+    void read_from(const ::curl::easy::Handle::OnReadData& reader, std::size_t size)
+    {
+        if (atomic_state.load() != core::net::http::Request::State::ready)
+            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
+
+        easy.on_read_data(reader, size);
+    }
+
+    // Leaves out the body of the response. Requests for Method::head transfer it, too, otherwise.
+    void header_only()
+    {
+        if (atomic_state.load() != core::net::http::Request::State::ready)
+            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
+
+        easy.set_option(::curl::Option::no_body, ::curl::easy::enable);
+    }
+
+    // Creates a request for method and configuration, sharing the facilities of this request.
+    std::shared_ptr<Request> derive(core::net::http::Method method, const Request::Configuration& configuration)
+    {
+        return Request::create(multi, prepare(method, configuration), method, configuration, facilities);
+    }
+
+    // Executes asynchronous transfers on the reactor of multi instead of the one of the client.
+    void bind(::curl::multi::Handle multi)
+    {
+        this->multi = multi;
+    }
+
+    void abort_request_if(std::uint64_t limit, const std::chrono::seconds& time)
+    {   
+        if (atomic_state.load() != core::net::http::Request::State::ready)
+            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
+    
+        easy.set_option(::curl::Option::low_speed_limit, limit);
+        easy.set_option(::curl::Option::low_speed_time, time.count());
+    }
+
+private:
+    // Size of the chunks requested from curl when writing the body to a sink.
+    static constexpr const long sink_buffer_size{512 * 1024};
+
+    struct Context
+    {
+        Response result;
+        std::stringstream body;
+        // Number of body bytes handed out.
+        std::uint64_t received{0};
+        // True if the body is accumulated despite a sink, as the response is unsuccessful.
+        bool buffered{false};
+    };
+
+    // Sets up a handle for method and configuration, as the client does.
+    static ::curl::easy::Handle prepare(core::net::http::Method method, const Request::Configuration& configuration)
+    {
+        ::curl::easy::Handle handle;
+        handle.method(method)
+              .url(configuration.uri.c_str())
+              .header(configuration.header);
+
+        handle.set_option(::curl::Option::ssl_verify_host,
+                          configuration.ssl.verify_host ? ::curl::easy::enable_ssl_host_verification : ::curl::easy::disable);
+        handle.set_option(::curl::Option::ssl_verify_peer,
+                          configuration.ssl.verify_peer ? ::curl::easy::enable : ::curl::easy::disable);
+
+        if (configuration.authentication_handler.for_http)
+        {
+            auto credentials = configuration.authentication_handler.for_http(configuration.uri);
+            handle.http_credentials(credentials.username, credentials.password);
+        }
+
+        return handle;
+    }
+
+    // Returns the response for a request that is answered from the cache alone.
+    Response serve(const impl::Cache::Lookup& lookup)
+    {
+        if (lookup.result == impl::Cache::Lookup::Result::fresh)
+            return facilities.cache->serve(lookup);
+
+        // See RFC 7234, section 5.2.1.7.
+        Response response;
+        response.status = core::net::http::Status::gateway_timeout;
+        return response;
+    }
+
+    // Revalidates the cached response in the background if the lookup asks
+    // for it, unless a revalidation is in progress already.
+    void refresh(const impl::Cache::Lookup& lookup)
+    {
+        if (not lookup.refresh || not facilities.cache->begin_refresh(lookup.key))
+            return;
+
+        auto handle = prepare(core::net::http::Method::get, configuration);
+
+        // Requests issued in the meantime are served from the cache and
+        // must not wait for the revalidation.
+        Facilities background{facilities};
+        background.coalescer.reset();
+
+        auto request = Request::create(multi, handle, core::net::http::Method::get, configuration, background);
+
+        impl::Cache::Lookup revalidation{lookup};
+        revalidation.result = impl::Cache::Lookup::Result::stale;
+        revalidation.request_time = impl::Cache::Clock::now();
+
+        auto cache = facilities.cache;
+        auto key = lookup.key;
+
+        // Queued behind the work the reactor has at hand.
+        multi.dispatch([request, revalidation, cache, key]()
+        {
+            try
+            {
+                request->async_execute_cached(
+                            revalidation,
+                            Request::Handler()
+                                .on_response([cache, key](const Response&) { cache->end_refresh(key); })
+                                .on_error([cache, key](const core::net::Error&) { cache->end_refresh(key); }),
+                            [](const std::string&) {});
+            } catch(...)
+            {
+                cache->end_refresh(key);
+            }
+        });
+    }
+
+    // Executes the transfer synchronously, revalidating a stale response and
+    // updating the cache with the outcome if the client caches responses.
+    Response execute_cached(const impl::Cache::Lookup& lookup,
+                            const Request::ProgressHandler& ph,
+                            const StreamingRequest::DataHandler& dh)
+    {
+        if (not facilities.cache || sink)
+            return execute_transfer(ph, dh);
+
+        if (lookup.result == impl::Cache::Lookup::Result::stale)
+            easy.header(lookup.conditional);
+
+        auto response = execute_transfer(ph, dh);
+
+        bool served_from_cache{false};
+        auto result = facilities.cache->update(method, uri, configuration.header, lookup, response, served_from_cache);
+
+        // A 304 comes without a body, hand out the cached one instead.
+        if (served_from_cache && not result.body.empty())
+            dh(result.body);
+
+        return result;
+    }
+
+    // Asynchronous counterpart of execute_cached.
+    void async_execute_cached(const impl::Cache::Lookup& lookup,
+                              const Request::Handler& handler,
+                              const StreamingRequest::DataHandler& dh)
+    {
+        if (not facilities.cache || sink)
+        {
+            async_execute_transfer(handler, dh);
+            return;
+        }
+
+        if (lookup.result == impl::Cache::Lookup::Result::stale)
+            easy.header(lookup.conditional);
+
+        auto cache = facilities.cache;
+        auto method = this->method;
+        auto uri = this->uri;
+        auto header = this->configuration.header;
+
+        Request::Handler caching{handler};
+        caching.on_response([cache, method, uri, header, lookup, handler, dh](const Response& response)
+        {
+            bool served_from_cache{false};
+            auto result = cache->update(method, uri, header, lookup, response, served_from_cache);
+
+            if (served_from_cache && not result.body.empty())
+                dh(result.body);
+
+            if (handler.on_response())
+                handler.on_response()(result);
+        });
+
+        async_execute_transfer(caching, dh);
+    }
+
+    // Executes the transfer synchronously, the state has been checked by the caller.
+    Response execute_transfer(const Request::ProgressHandler& ph, const StreamingRequest::DataHandler& dh)
+    {
+        // Throws if the host does not accept requests right now, leaving
+        // the request in State::ready.
+        auto ticket = admit();
+
         StateGuard sg{atomic_state};
+
+        if (route.host)
+            route.host->acquire(ticket);
+
         Context context;
 
         if (ph)
@@ -155,10 +657,7 @@ public:
         easy.on_write_data(
                     [&](char* data, std::size_t size, std::size_t nmemb)
                     {
-                        // Report out to the data handler prior to accumulating data.
-                        dh(std::string{data, size * nmemb});
-                        context.body.write(data, size * nmemb);
-                        return size * nmemb;
+                        return receive(context, dh, data, size * nmemb);
                     });
         easy.on_write_header(
                     [&](void* data, std::size_t size, std::size_t nmemb)
@@ -180,46 +679,84 @@ public:
             easy.perform();
         } catch(const std::system_error& se)
         {
-            throw core::net::http::Error(se.what(), CORE_FROM_HERE());
+            if (not stopped())
+            {
+                report(ticket, true);
+                throw core::net::http::Error(discard(se.what()), CORE_FROM_HERE());
+            }
+        } catch(...)
+        {
+            report(ticket, true);
+            discard(std::string{});
+            throw;
         }
 
         context.result.status = easy.status();
         context.result.body = context.body.str();
 
+        report(ticket, is_server_error(context.result.status));
+        account(context.received);
+        commit(context.result.status);
+
         return context.result;
     }
 
-    void async_execute(const Request::Handler& handler)
+    // Hands the transfer over to the reactor, the state has been checked by the caller.
+    void async_execute_transfer(const Request::Handler& handler, const StreamingRequest::DataHandler& dh)
     {
-        async_execute(handler, [](const std::string&){});
-    }
+        impl::Host::Ticket ticket;
 
-    void async_execute(const Request::Handler& handler, const StreamingRequest::DataHandler& dh)
-    {
-        if (atomic_state.load() != core::net::http::Request::State::ready)
-            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
+        try
+        {
+            ticket = admit();
+        } catch(const core::net::http::Client::Errors::CircuitOpen& e)
+        {
+            // Fail fast, but still report on the reactor like any other error.
+            auto on_error = handler.on_error();
+            if (on_error)
+                multi.dispatch([on_error, e]() { on_error(e); });
+
+            return;
+        }
 
         auto sg = std::make_shared<StateGuard>(atomic_state);
         auto context = std::make_shared<Context>();
 
         auto thiz = shared_from_this();
 
-        easy.on_finished([thiz, handler, context](::curl::Code code)
+        easy.on_finished([thiz, handler, context, ticket](::curl::Code code)
         {
-            if (code == ::curl::Code::ok)
+            if (code == ::curl::Code::ok || thiz->stopped())
             {
                 context->result.status = thiz->easy.status();
                 context->result.body = context->body.str();
 
+                thiz->report(ticket, is_server_error(context->result.status));
+                thiz->account(context->received);
+
+                try
+                {
+                    thiz->commit(context->result.status);
+                } catch(const core::net::http::Error& e)
+                {
+                    if (handler.on_error())
+                        handler.on_error()(e);
+
+                    thiz->easy.release();
+                    return;
+                }
+
                 if (handler.on_response())
                     handler.on_response()(context->result);
             } else
             {
+                thiz->report(ticket, true);
+
+                std::stringstream ss; ss << code;
+                auto reason = thiz->discard(ss.str());
+
                 if (handler.on_error())
-                {
-                    std::stringstream ss; ss << code;
-                    handler.on_error()(core::net::http::Error(ss.str(), CORE_FROM_HERE()));
-                }
+                    handler.on_error()(core::net::http::Error(reason, CORE_FROM_HERE()));
             }
 
             thiz->easy.release();
@@ -247,12 +784,9 @@ public:
         }
 
         easy.on_write_data(
-                    [context, dh](char* data, std::size_t size, std::size_t nmemb)
+                    [thiz, context, dh](char* data, std::size_t size, std::size_t nmemb)
                     {
-                        // Report out to the data handler prior to accumulating data.
-                        dh(std::string{data, size * nmemb});
-                        context->body.write(data, size * nmemb);
-                        return size * nmemb;
+                        return thiz->receive(*context, dh, data, size * nmemb);
                     });
 
         easy.on_write_header(
@@ -270,64 +804,246 @@ public:
                         return std::get<size_index>(kvs);
                     });
 
+        // Hand over to the reactor once the host's concurrency limit admits
+        // another request in flight. The handle is added from the reactor as
+        // slots are released while the multi instance is being worked on.
+        if (route.host && not route.host->acquire_or_enqueue(ticket, [thiz]()
+        {
+            thiz->multi.dispatch([thiz]() { thiz->multi.add(thiz->easy); });
+        }))
+            return;
+
         multi.add(easy);
     }
 
-    std::string url_escape(const std::string& s)
+    // Waits for the outcome of the transfer of an identical request, reporting it from the reactor.
+    void join(const std::shared_ptr<impl::Coalescer::Flight>& flight,
+              const Request::Handler& handler,
+              const StreamingRequest::DataHandler& dh)
     {
-        return easy.escape(s);
+        auto sg = std::make_shared<StateGuard>(atomic_state);
+        auto thiz = shared_from_this();
+
+        flight->on_complete([thiz, sg, handler, dh](const Response& response, const std::exception_ptr& error)
+        {
+            thiz->multi.dispatch([sg, handler, dh, response, error]()
+            {
+                if (error)
+                {
+                    if (not handler.on_error())
+                        return;
+
+                    try
+                    {
+                        std::rethrow_exception(error);
+                    } catch(const core::net::Error& e)
+                    {
+                        handler.on_error()(e);
+                    } catch(const std::exception& e)
+                    {
+                        handler.on_error()(core::net::http::Error(e.what(), CORE_FROM_HERE()));
+                    }
+
+                    return;
+                }
+
+                if (not response.body.empty())
+                    dh(response.body);
+
+                if (handler.on_response())
+                    handler.on_response()(response);
+            });
+        });
     }
 
-    std::string url_unescape(const std::string& s)
+    // Responses with a 5xx status count as failures against the host.
+    static bool is_server_error(core::net::http::Status status)
     {
-        return easy.unescape(s);
+        return static_cast<int>(status) >= 500;
     }
 
-    void pause()
-    {   
-        auto copy = easy;
-        multi.dispatch([copy]() mutable
-        {   
-            try 
-            {   
-                copy.pause();
-            }   
-            catch(...) {}
-        }); 
-    }    
+    // Resolves the route of the request and admits it against the target host.
+    impl::Host::Ticket admit()
+    {
+        if (not facilities.hosts)
+            return impl::Host::Ticket{};
 
-    void resume()
-    {   
-        auto copy = easy;
-        multi.dispatch([copy]() mutable
-        {   
-            try 
-            {   
-                copy.resume();
-            }   
-            catch(...) {}
-        }); 
-    }   
+        route = facilities.hosts->route(uri, affinity_key);
 
-    void abort_request_if(std::uint64_t limit, const std::chrono::seconds& time)
-    {   
-        if (atomic_state.load() != core::net::http::Request::State::ready)
-            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
-    
-        easy.set_option(::curl::Option::low_speed_limit, limit);
-        easy.set_option(::curl::Option::low_speed_time, time.count());
+        // The uri addressed an endpoint group, send the request to the selected endpoint.
+        if (route.uri != uri)
+            easy.url(route.uri.c_str());
+
+        try
+        {
+            return route.host->admit();
+        } catch(...)
+        {
+            // An endpoint refusing requests counts as failing.
+            if (route.group)
+                route.group->report(route.endpoint, true, impl::EndpointGroup::Seconds{});
+            throw;
+        }
+    }
+
+    void report(const impl::Host::Ticket& ticket, bool failed)
+    {
+        if (not route.host)
+            return;
+
+        impl::Host::Outcome outcome;
+        outcome.failed = failed;
+
+        try
+        {
+            outcome.latency = easy.timings().total;
+        } catch(...)
+        {
+            // Failed requests do not contribute a latency sample.
+        }
+
+        route.host->report(ticket, outcome);
+
+        if (route.group)
+            route.group->report(route.endpoint, outcome.failed, outcome.latency);
+    }
+
+    // Hands out a chunk of the body, or writes it to the sink if the response is successful.
+    std::size_t receive(Context& context, const StreamingRequest::DataHandler& dh, const char* data, std::size_t size)
+    {
+        if (buffer)
+        {
+            switch (buffer->offer(data, size))
+            {
+            case impl::ReceiveBuffer::Offer::accepted:
+                break;
+            // curl hands out the very same chunk again once resumed.
+            case impl::ReceiveBuffer::Offer::full:
+                return static_cast<std::size_t>(::curl::Code::no_writefunc_pause);
+            // Returning less than size aborts the transfer with a write error.
+            case impl::ReceiveBuffer::Offer::closed:
+                return 0;
+            }
+
+            context.received += size;
+            return size;
+        }
+
+        context.received += size;
+
+        if (sink && not context.buffered)
+        {
+            if (not sink->begun())
+            {
+                // Bodies of unsuccessful responses are for the caller to inspect, not for the file.
+                if (static_cast<int>(easy.status()) >= 300)
+                    context.buffered = true;
+                else if (not sink->begin(easy.status(), context.result.header, easy.content_length()))
+                    return 0;
+            }
+
+            // Returning less than size aborts the transfer with a write error.
+            if (sink->begun())
+                return sink->write(data, size) ? size : 0;
+        }
+
+        // Report out to the data handler prior to accumulating data.
+        dh(std::string{data, size});
+        context.body.write(data, size);
+        return size;
+    }
+
+    // Commits the file written for a successful response, discarding it otherwise.
+    // Throws core::net::http::Error if committing fails.
+    void commit(core::net::http::Status status)
+    {
+        if (not sink)
+            return;
+
+        if (static_cast<int>(status) >= 300)
+        {
+            sink->abort();
+            return;
+        }
+
+        try
+        {
+            sink->finish();
+        } catch(const std::system_error& se)
+        {
+            throw core::net::http::Error(se.what(), CORE_FROM_HERE());
+        }
+    }
+
+    // Returns true if the sink ended the transfer, having received all of the range it asked for.
+    bool stopped() const
+    {
+        return sink && sink->complete();
+    }
+
+    // Discards the file of a failed transfer, returning the reason for the failure.
+    std::string discard(const std::string& reason)
+    {
+        if (not sink)
+            return reason;
+
+        sink->abort();
+
+        return sink->error().empty() ? reason : sink->error();
+    }
+
+    // Accounts for the bytes received by a successful transfer.
+    void account(std::uint64_t decoded_bytes)
+    {
+        if (not facilities.traffic)
+            return;
+
+        try
+        {
+            facilities.traffic->account(easy.download_size(), decoded_bytes);
+
+            if (method != core::net::http::Method::post && method != core::net::http::Method::put)
+                return;
+
+            if (not expects_continue(configuration, body_length))
+                return;
+
+            // Compressed bodies are sent chunked, their length on the wire is not known.
+            auto length = easy.upload_length();
+
+            // A final response arriving before all of the body went out spared sending the rest of it.
+            auto sent = easy.upload_size();
+            bool rejected = static_cast<int>(easy.status()) >= 300 &&
+                    (length < 0 ? sent == 0 : sent < static_cast<std::uint64_t>(length));
+
+            facilities.traffic->account_expectation(rejected, rejected && length > 0 ? length - sent : 0);
+        } catch(...)
+        {
+            // Not worth failing the request over.
+        }
     }
 
-private:
     std::atomic<core::net::http::Request::State> atomic_state;
     ::curl::multi::Handle multi;
     ::curl::easy::Handle easy;
-
-    struct Context
-    {
-        Response result;
-        std::stringstream body;
-    };
+    Facilities facilities;
+    core::net::http::Method method;
+    // The uri as configured by the caller, possibly addressing an endpoint group.
+    std::string uri;
+    // The configuration as passed in by the caller.
+    Request::Configuration configuration;
+    // Routes requests to a stable endpoint of consistent-hash endpoint groups.
+    std::string affinity_key;
+    // Identifies identical requests that may share a transfer, empty if the request is not coalesced.
+    std::string coalescing_key;
+    // Size of the request body, -1 if unknown.
+    std::int64_t body_length{-1};
+    // Valid once the request has been admitted.
+    impl::Route route;
+    // Receives the body of a successful response, if set.
+    std::shared_ptr<impl::FileSink> sink;
+    // Receives the body of asynchronous executions, if set.
+    std::shared_ptr<impl::ReceiveBuffer> buffer;
 };
 }
 }
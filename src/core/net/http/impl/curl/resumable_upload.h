@@ -0,0 +1,450 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_CURL_RESUMABLE_UPLOAD_H_
+#define CORE_NET_HTTP_IMPL_CURL_RESUMABLE_UPLOAD_H_
+
+#include <core/net/http/streaming_client.h>
+
+#include <core/net/http/error.h>
+
+#include "request.h"
+
+#include "../transfer_state.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+namespace curl
+{
+// Uploads a file with PUT, resuming an interrupted upload of it, see
+// core::net::http::StreamingClient::resumable_put. Once started, all
+// of the state is only ever touched from the reactor the requests run on.
+class ResumableUpload : public core::net::http::StreamingRequest,
+                        public std::enable_shared_from_this<ResumableUpload>
+{
+public:
+    // Status code a server answers with while the upload is incomplete.
+    static constexpr const int resume_incomplete{308};
+
+    // Requests for configuration are derived from origin, which is never executed
+    // itself. Opens the file at path, throws std::system_error if that fails.
+    ResumableUpload(::curl::multi::Handle multi,
+                    const std::shared_ptr<curl::Request>& origin,
+                    const core::net::http::Request::Configuration& configuration,
+                    const std::string& path,
+                    const std::string& state_path)
+        : atomic_state(core::net::http::Request::State::ready),
+          multi(multi),
+          origin(origin),
+          configuration(configuration),
+          state_path(state_path)
+    {
+        fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+            throw std::system_error{errno, std::system_category(), "Could not open " + path};
+
+        struct stat st;
+        if (::fstat(fd, &st) == -1)
+        {
+            auto error = errno;
+            ::close(fd);
+            throw std::system_error{error, std::system_category(), "Could not stat " + path};
+        }
+
+        size = st.st_size;
+        // Any change to the file invalidates what the server has received so far.
+        validator = std::to_string(st.st_size) + ":" + std::to_string(st.st_mtim.tv_sec) + "." + std::to_string(st.st_mtim.tv_nsec);
+    }
+
+    ~ResumableUpload()
+    {
+        ::close(fd);
+    }
+
+    State state()
+    {
+        return atomic_state.load();
+    }
+
+    void set_timeout(const std::chrono::milliseconds& timeout)
+    {
+        ensure_ready();
+        this->timeout = timeout;
+    }
+
+    Response execute(const ProgressHandler& ph)
+    {
+        return execute(ph, [](const std::string&){});
+    }
+
+    Response execute(const ProgressHandler& ph, const DataHandler& dh)
+    {
+        ensure_ready();
+
+        // The requests run on a reactor of their own, driven by the calling thread.
+        ::curl::multi::Handle reactor;
+        multi = reactor;
+        origin->bind(reactor);
+
+        Response response;
+        std::string error;
+        bool failed{false};
+
+        start(Handler()
+                .on_progress(ph)
+                .on_response([&response, reactor](const Response& r) mutable
+                {
+                    response = r;
+                    reactor.stop();
+                })
+                .on_error([&failed, &error, reactor](const core::net::Error& e) mutable
+                {
+                    failed = true;
+                    error = e.what();
+                    reactor.stop();
+                }), dh);
+
+        reactor.run();
+
+        if (failed)
+            throw core::net::http::Error(error, CORE_FROM_HERE());
+
+        return response;
+    }
+
+    void async_execute(const Handler& handler)
+    {
+        async_execute(handler, [](const std::string&){});
+    }
+
+    void async_execute(const Handler& handler, const DataHandler& dh)
+    {
+        ensure_ready();
+        start(handler, dh);
+    }
+
+    // Executes the upload asynchronously, handing the body of the final response to the returned reader.
+    std::shared_ptr<core::net::http::BodyReader> open(const core::net::http::BodyReader::Configuration& configuration)
+    {
+        ensure_ready();
+
+        // Resuming is dispatched to the reactor, never running into the transfer.
+        std::weak_ptr<ResumableUpload> wp{shared_from_this()};
+        auto buffer = std::make_shared<impl::ReceiveBuffer>(configuration.capacity, [wp]()
+        {
+            if (auto sp = wp.lock())
+                sp->resume();
+        });
+
+        this->buffer = buffer;
+
+        // The reader may go away before the upload completes, the buffer stays.
+        start(Handler()
+                .on_response([buffer](const Response& response) { buffer->finish(response); })
+                .on_error([buffer](const core::net::Error& e) { buffer->fail(std::make_exception_ptr(e)); }),
+              [](const std::string&) {});
+
+        return std::make_shared<impl::BufferedReader>(buffer, configuration);
+    }
+
+    std::string url_escape(const std::string& s)
+    {
+        return origin->url_escape(s);
+    }
+
+    std::string url_unescape(const std::string& s)
+    {
+        return origin->url_unescape(s);
+    }
+
+    void pause()
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        if (current)
+            current->pause();
+    }
+
+    void resume()
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        if (current)
+            current->resume();
+    }
+
+    void abort_request_if(std::uint64_t limit, const std::chrono::seconds& time)
+    {
+        ensure_ready();
+        low_speed = std::make_pair(limit, time);
+    }
+
+private:
+    void ensure_ready()
+    {
+        if (atomic_state.load() != core::net::http::Request::State::ready)
+            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
+    }
+
+    void start(const Handler& handler, const DataHandler& dh)
+    {
+        atomic_state.store(core::net::http::Request::State::active);
+        this->handler = handler;
+        this->dh = dh;
+
+        impl::TransferState state;
+        if (impl::TransferState::load(state_path, state) && state.uri == configuration.uri && state.validator == validator)
+        {
+            confirmed = state.confirmed;
+            query();
+        }
+        else
+            upload(0);
+    }
+
+    // Asks the server for the number of bytes it has received, see
+    // https://cloud.google.com/storage/docs/performing-resumable-uploads.
+    void query()
+    {
+        auto thiz = shared_from_this();
+
+        auto query_configuration = configuration;
+        query_configuration.header.set("Content-Range", "bytes */" + std::to_string(size));
+
+        auto request = origin->derive(core::net::http::Method::put, query_configuration);
+        request->read_from([](void*, std::size_t, std::size_t) { return std::size_t{0}; }, 0);
+
+        run(request, Handler()
+                .on_response([thiz](const Response& response) { thiz->queried(response); })
+                .on_error([thiz](const core::net::Error& e) { thiz->failed(e); }),
+            [](const std::string&) {});
+    }
+
+    void queried(const Response& response)
+    {
+        auto status = static_cast<int>(response.status);
+
+        // A plain server happily stores the empty body of the query, only a server
+        // known to resume uploads is trusted to report the upload as complete.
+        if (status >= 200 && status < 300 && confirmed)
+        {
+            completed(response);
+            return;
+        }
+
+        std::uint64_t offset{0};
+
+        // The server holds bytes 0-n, and nothing if there is no Range header.
+        if (status == resume_incomplete)
+        {
+            confirmed = true;
+
+            std::string range;
+            response.header.enumerate([&range](const std::string& key, const std::set<std::string>& values)
+            {
+                if (key == "Range" && not values.empty())
+                    range = *values.begin();
+            });
+
+            static constexpr const char* prefix{"bytes=0-"};
+            if (range.compare(0, std::strlen(prefix), prefix) == 0)
+            {
+                char* end{nullptr};
+                auto last = std::strtoull(range.c_str() + std::strlen(prefix), &end, 10);
+                if (*end == '\0' && last < size)
+                    offset = last + 1;
+            }
+        }
+
+        upload(offset);
+    }
+
+    // Sends the file from offset on.
+    void upload(std::uint64_t offset)
+    {
+        auto thiz = shared_from_this();
+
+        impl::TransferState state;
+        state.uri = configuration.uri;
+        state.validator = validator;
+        state.size = size;
+        state.committed = offset;
+        state.confirmed = confirmed;
+
+        try
+        {
+            state.save(state_path);
+        } catch(const std::system_error& se)
+        {
+            failed(core::net::http::Error(se.what(), CORE_FROM_HERE()));
+            return;
+        }
+
+        auto upload_configuration = configuration;
+        if (offset > 0)
+            upload_configuration.header.set("Content-Range", "bytes " + std::to_string(offset) + "-" + std::to_string(size - 1) + "/" + std::to_string(size));
+
+        auto request = origin->derive(core::net::http::Method::put, upload_configuration);
+        if (buffer)
+            request->receive_into(buffer);
+
+        auto position = std::make_shared<std::uint64_t>(offset);
+        auto descriptor = fd;
+        request->read_from([position, descriptor](void* dest, std::size_t item_size, std::size_t nmemb)
+        {
+            auto result = ::pread(descriptor, dest, item_size * nmemb, *position);
+            if (result < 0)
+                return static_cast<std::size_t>(::curl::Code::no_readfunc_abort);
+
+            *position += result;
+            return static_cast<std::size_t>(result);
+        }, size - offset);
+
+        run(request, Handler()
+                .on_progress(handler.on_progress())
+                .on_response([thiz](const Response& response)
+                {
+                    auto status = static_cast<int>(response.status);
+                    if (status >= 200 && status < 300)
+                        thiz->completed(response);
+                    else if (status == resume_incomplete)
+                        thiz->incomplete(response);
+                    else
+                        thiz->reported(response);
+                })
+                .on_error([thiz](const core::net::Error& e) { thiz->failed(e); }),
+            dh);
+    }
+
+    // Executes request on the reactor, which does not take in new transfers from within callbacks.
+    void run(const std::shared_ptr<curl::Request>& request, const Handler& handler, const DataHandler& dh)
+    {
+        if (timeout.count() > 0)
+            request->set_timeout(timeout);
+
+        if (low_speed.second.count() > 0)
+            request->abort_request_if(low_speed.first, low_speed.second);
+
+        {
+            std::lock_guard<std::mutex> lg(guard);
+            current = request;
+        }
+
+        multi.dispatch([request, handler, dh]()
+        {
+            request->async_execute(handler, dh);
+        });
+    }
+
+    void completed(const Response& response)
+    {
+        ::unlink(state_path.c_str());
+        reported(response);
+    }
+
+    // Remembers that the server resumes uploads, for later queries to rely on it.
+    void incomplete(const Response& response)
+    {
+        impl::TransferState state;
+        if (not confirmed && impl::TransferState::load(state_path, state))
+        {
+            state.confirmed = confirmed = true;
+
+            try
+            {
+                state.save(state_path);
+            } catch(const std::system_error&)
+            {
+                // The next query merely distrusts a completion reported by the server.
+            }
+        }
+
+        reported(response);
+    }
+
+    void reported(const Response& response)
+    {
+        finish();
+
+        if (handler.on_response())
+            handler.on_response()(response);
+    }
+
+    void failed(const core::net::Error& e)
+    {
+        finish();
+
+        if (handler.on_error())
+            handler.on_error()(e);
+    }
+
+    void finish()
+    {
+        {
+            // The handlers of the request refer back to this upload.
+            std::lock_guard<std::mutex> lg(guard);
+            current.reset();
+        }
+
+        atomic_state.store(core::net::http::Request::State::done);
+    }
+
+    std::atomic<core::net::http::Request::State> atomic_state;
+    ::curl::multi::Handle multi;
+    std::shared_ptr<curl::Request> origin;
+    core::net::http::Request::Configuration configuration;
+    std::string state_path;
+
+    int fd{-1};
+    std::uint64_t size{0};
+    std::string validator;
+    // Whether the server has answered with resume_incomplete before.
+    bool confirmed{false};
+
+    std::chrono::milliseconds timeout{0};
+    std::pair<std::uint64_t, std::chrono::seconds> low_speed{0, std::chrono::seconds{0}};
+
+    Handler handler;
+    DataHandler dh;
+    // Takes the response body of the upload instead of dh if the upload has been opened.
+    std::shared_ptr<impl::ReceiveBuffer> buffer;
+
+    // Guards current, which pause and resume are invoked for from other threads.
+    std::mutex guard;
+    std::shared_ptr<curl::Request> current;
+};
+}
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_CURL_RESUMABLE_UPLOAD_H_
@@ -0,0 +1,734 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_CURL_SEGMENTED_DOWNLOAD_H_
+#define CORE_NET_HTTP_IMPL_CURL_SEGMENTED_DOWNLOAD_H_
+
+#include <core/net/http/streaming_client.h>
+
+#include <core/net/http/error.h>
+
+#include "request.h"
+
+#include "../file_sink.h"
+#include "../mirrors.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+namespace curl
+{
+// Returns all values of field key in header, combined into a comma-separated list.
+inline std::string header_field(const core::net::http::Header& header, const std::string& key)
+{
+    std::string result;
+    auto canonical_key = core::net::http::Header::canonicalize_key(key);
+
+    header.enumerate([&result, &canonical_key](const std::string& k, const std::set<std::string>& values)
+    {
+        if (k != canonical_key)
+            return;
+
+        for (const auto& value : values)
+            result += (result.empty() ? "" : ", ") + value;
+    });
+
+    return result;
+}
+
+// Downloads a resource to a file in byte ranges fetched concurrently from one or
+// more mirrors, see core::net::http::StreamingClient::segmented_get_to_file and
+// core::net::http::StreamingClient::mirrored_get_to_file. Once started, all
+// of the state is only ever touched from the reactor the transfers run on.
+class SegmentedDownload : public core::net::http::StreamingRequest,
+                          public std::enable_shared_from_this<SegmentedDownload>
+{
+public:
+    typedef core::net::http::StreamingClient::Segmentation::Configuration Configuration;
+
+    // probe is the HEAD request issued for configuration on the reactor of multi, to the
+    // first of the non-empty uris. The body is written to file, figures about the mirrors
+    // are accounted to statistics.
+    SegmentedDownload(::curl::multi::Handle multi,
+                      const std::shared_ptr<curl::Request>& probe,
+                      const core::net::http::Request::Configuration& request_configuration,
+                      const std::vector<std::string>& uris,
+                      const std::shared_ptr<impl::FileSink>& file,
+                      const Configuration& configuration,
+                      const std::shared_ptr<impl::Mirrors>& statistics)
+        : atomic_state(core::net::http::Request::State::ready),
+          multi(multi),
+          probe(probe),
+          request_configuration(request_configuration),
+          file(file),
+          configuration(configuration),
+          statistics(statistics)
+    {
+        for (const auto& uri : uris)
+        {
+            auto mirror = std::make_shared<Mirror>();
+            mirror->uri = uri;
+            mirrors.push_back(mirror);
+        }
+
+        probed_mirror = mirrors.front();
+    }
+
+    State state()
+    {
+        return atomic_state.load();
+    }
+
+    void set_timeout(const std::chrono::milliseconds& timeout)
+    {
+        ensure_ready();
+        this->timeout = timeout;
+    }
+
+    Response execute(const ProgressHandler& ph)
+    {
+        return execute(ph, [](const std::string&){});
+    }
+
+    // The body goes to the file, dh is never invoked.
+    Response execute(const ProgressHandler& ph, const DataHandler&)
+    {
+        ensure_ready();
+
+        // The transfers run on a reactor of their own, driven by the calling thread.
+        ::curl::multi::Handle reactor;
+        multi = reactor;
+        probe->bind(reactor);
+
+        Response response;
+        std::string error;
+        bool failed{false};
+
+        start(Handler()
+                .on_progress(ph)
+                .on_response([&response, reactor](const Response& r) mutable
+                {
+                    response = r;
+                    reactor.stop();
+                })
+                .on_error([&failed, &error, reactor](const core::net::Error& e) mutable
+                {
+                    failed = true;
+                    error = e.what();
+                    reactor.stop();
+                }));
+
+        reactor.run();
+
+        if (failed)
+            throw core::net::http::Error(error, CORE_FROM_HERE());
+
+        return response;
+    }
+
+    void async_execute(const Handler& handler)
+    {
+        async_execute(handler, [](const std::string&){});
+    }
+
+    // The body goes to the file, dh is never invoked.
+    void async_execute(const Handler& handler, const DataHandler&)
+    {
+        ensure_ready();
+        start(handler);
+    }
+
+    std::string url_escape(const std::string& s)
+    {
+        return probe->url_escape(s);
+    }
+
+    std::string url_unescape(const std::string& s)
+    {
+        return probe->url_unescape(s);
+    }
+
+    void pause()
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        for (const auto& transfer : transfers)
+            transfer->pause();
+    }
+
+    void resume()
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        for (const auto& transfer : transfers)
+            transfer->resume();
+    }
+
+    void abort_request_if(std::uint64_t limit, const std::chrono::seconds& time)
+    {
+        ensure_ready();
+        low_speed = std::make_pair(limit, time);
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    // A server the resource is fetched from.
+    struct Mirror
+    {
+        std::string uri;
+        // Number of transfers in flight.
+        std::size_t active{0};
+        // Set once the mirror has failed, it is not issued any transfers after that.
+        bool dropped{false};
+        // Received bytes and accumulated duration of the completed transfers.
+        std::uint64_t bytes{0};
+        double seconds{0.};
+
+        double rate() const
+        {
+            return seconds > 0. ? bytes / seconds : 0.;
+        }
+    };
+
+    // A range of the body, fetched by one transfer at a time.
+    struct Segment
+    {
+        // Where the current attempt starts.
+        std::uint64_t position;
+        // The end of the range, exclusive. Moves forward if the segment is split.
+        std::uint64_t end;
+        // The sink of the current attempt, reset once the segment is complete.
+        std::shared_ptr<impl::FileSink> sink;
+        // Number of consecutive attempts failing without making any progress.
+        unsigned int failures{0};
+        // The mirror of the current attempt, and when the attempt started.
+        std::shared_ptr<Mirror> mirror;
+        Clock::time_point started;
+    };
+
+    void ensure_ready()
+    {
+        if (atomic_state.load() != core::net::http::Request::State::ready)
+            throw core::net::http::Request::Errors::AlreadyActive{CORE_FROM_HERE()};
+    }
+
+    void start(const Handler& handler)
+    {
+        atomic_state.store(core::net::http::Request::State::active);
+        this->handler = handler;
+
+        issue_probe();
+    }
+
+    // Sends the probe to probed_mirror.
+    void issue_probe()
+    {
+        auto thiz = shared_from_this();
+        auto request = probe;
+
+        prepare(request);
+        // Invoked from the reactor, which does not take in new transfers from there.
+        multi.dispatch([thiz, request]()
+        {
+            request->async_execute(
+                        Handler()
+                            .on_response([thiz](const Response& response) { thiz->probed(response); })
+                            .on_error([thiz](const core::net::Error& e) { thiz->probe_failed(e.what()); }),
+                        [](const std::string&) {});
+        });
+    }
+
+    // Moves on to the next mirror if the probed one fails, returning false if there is none.
+    bool reprobe()
+    {
+        if (not drop(probed_mirror))
+            return false;
+
+        for (const auto& mirror : mirrors)
+        {
+            if (mirror->dropped)
+                continue;
+
+            probed_mirror = mirror;
+
+            auto configuration = request_configuration;
+            configuration.uri = mirror->uri;
+
+            probe = probe->derive(core::net::http::Method::head, configuration);
+            probe->header_only();
+
+            issue_probe();
+            return true;
+        }
+
+        return false;
+    }
+
+    void probe_failed(const std::string& reason)
+    {
+        if (reprobe())
+            return;
+
+        failure = reason;
+        complete();
+    }
+
+    // Splits up the body as announced by the probe, if the server allows for it.
+    void probed(const Response& response)
+    {
+        auto status = static_cast<int>(response.status);
+
+        // The caller gets to see what is wrong with the resource, unless another mirror has it.
+        if ((status < 200 || status >= 300) && reprobe())
+            return;
+
+        if (status < 200 || status >= 300)
+        {
+            file->abort();
+            atomic_state.store(core::net::http::Request::State::done);
+
+            if (handler.on_response())
+                handler.on_response()(response);
+
+            return;
+        }
+
+        result = response;
+
+        auto content_length = header_field(response.header, "Content-Length");
+        char* end{nullptr};
+        auto size = content_length.empty() ? -1 : std::strtoll(content_length.c_str(), &end, 10);
+        if (end && *end != '\0')
+            size = -1;
+
+        std::string accept_ranges = header_field(response.header, "Accept-Ranges");
+        std::transform(accept_ranges.begin(), accept_ranges.end(), accept_ranges.begin(), ::tolower);
+
+        auto min_segment_size = std::max<std::uint64_t>(configuration.min_segment_size, 1);
+
+        if (accept_ranges.find("bytes") == std::string::npos || size <= 0 ||
+            static_cast<std::uint64_t>(size) < 2 * min_segment_size)
+        {
+            single();
+            return;
+        }
+
+        length = size;
+
+        // Only strong validators make sure that ranges fit together. If-Range is only
+        // sent to the probed mirror, segments check the answers of all mirrors.
+        validator = impl::TransferState::validator_of(response.header);
+
+        file->begin(response.status, response.header, size);
+
+        auto max_segments = std::max<std::size_t>(configuration.max_segments, 1);
+        target = std::min(std::max<std::size_t>(configuration.segments, 1), max_segments);
+
+        auto count = std::min<std::uint64_t>(target, length / min_segment_size);
+
+        measured_at = Clock::now();
+
+        for (std::uint64_t i = 0; i < count; i++)
+        {
+            auto segment = std::make_shared<Segment>();
+            segment->position = i * (length / count);
+            segment->end = i + 1 == count ? length : (i + 1) * (length / count);
+
+            segments.push_back(segment);
+        }
+
+        for (const auto& segment : segments)
+            attempt(segment);
+    }
+
+    // Downloads the body in a single transfer.
+    void single()
+    {
+        auto thiz = shared_from_this();
+
+        auto configuration = request_configuration;
+        configuration.uri = probed_mirror->uri;
+
+        auto request = probe->derive(core::net::http::Method::get, configuration);
+
+        request->write_to(file);
+        prepare(request);
+        track(request);
+
+        auto progress = handler.on_progress();
+        // Invoked from the reactor, which does not take in new transfers from there.
+        multi.dispatch([thiz, request, progress]()
+        {
+            request->async_execute(
+                        Handler()
+                            .on_progress(progress)
+                            .on_response([thiz, request](const Response& response)
+                            {
+                                thiz->untrack(request);
+                                thiz->atomic_state.store(core::net::http::Request::State::done);
+
+                                if (thiz->handler.on_response())
+                                    thiz->handler.on_response()(response);
+                            })
+                            .on_error([thiz, request](const core::net::Error& e)
+                            {
+                                thiz->untrack(request);
+                                thiz->atomic_state.store(core::net::http::Request::State::done);
+
+                                if (thiz->handler.on_error())
+                                    thiz->handler.on_error()(e);
+                            }),
+                        [](const std::string&) {});
+        });
+    }
+
+    // Fetches the outstanding part of segment.
+    void attempt(const std::shared_ptr<Segment>& segment)
+    {
+        auto thiz = shared_from_this();
+
+        segment->sink = file->segment(segment->position, segment->end - segment->position);
+        // A mirror disagreeing on length or validator fails without delivering anything, and is dropped.
+        segment->sink->verify(segment->position, length, validator);
+        segment->mirror = pick();
+        segment->mirror->active++;
+        segment->started = Clock::now();
+
+        auto configuration = request_configuration;
+        configuration.uri = segment->mirror->uri;
+        configuration.header.set("Range", "bytes=" + std::to_string(segment->position) + "-" + std::to_string(segment->end - 1));
+        if (not validator.empty() && segment->mirror == probed_mirror)
+            configuration.header.set("If-Range", validator);
+
+        auto request = probe->derive(core::net::http::Method::get, configuration);
+
+        request->write_to(segment->sink);
+        prepare(request);
+        track(request);
+
+        // Invoked from the reactor, which does not take in new transfers from there.
+        multi.dispatch([thiz, segment, request]()
+        {
+            request->async_execute(
+                        Handler()
+                            .on_progress([thiz](const Progress&) { return thiz->progress(); })
+                            .on_response([thiz, segment, request](const Response& response)
+                            {
+                                thiz->finished(segment, request, "Unexpected status " + std::to_string(static_cast<int>(response.status)));
+                            })
+                            .on_error([thiz, segment, request](const core::net::Error& e)
+                            {
+                                thiz->finished(segment, request, e.what());
+                            }),
+                        [](const std::string&) {});
+        });
+    }
+
+    // Accounts for the attempt on segment having ended, retrying it if incomplete.
+    void finished(const std::shared_ptr<Segment>& segment, const std::shared_ptr<curl::Request>& request, const std::string& reason)
+    {
+        untrack(request);
+
+        auto written = segment->sink->written();
+        file->adopt(*segment->sink);
+        segment->position += written;
+
+        std::chrono::duration<double> elapsed = Clock::now() - segment->started;
+        auto mirror = segment->mirror;
+        mirror->active--;
+        mirror->bytes += written;
+        mirror->seconds += elapsed.count();
+
+        if (statistics)
+            statistics->account(mirror->uri, written, elapsed, segment->position < segment->end);
+
+        if (segment->position >= segment->end)
+        {
+            segment->sink.reset();
+        } else if (failure.empty())
+        {
+            if (written > 0)
+                segment->failures = 0;
+
+            // A mirror failing without delivering anything is given up on while others are left.
+            if (written == 0 && (mirror->dropped || drop(mirror)))
+                attempt(segment);
+            else if (++segment->failures > configuration.max_retries)
+                failure = "Failed to fetch bytes " + std::to_string(segment->position) + "-" + std::to_string(segment->end - 1) + ": " + reason;
+            else
+                attempt(segment);
+        }
+
+        if (failure.empty())
+            rebalance();
+
+        if (active() == 0)
+            complete();
+    }
+
+    // Returns the mirror to issue the next transfer to, the one with the fewest
+    // transfers in flight and, among those, the best throughput so far.
+    std::shared_ptr<Mirror> pick() const
+    {
+        std::shared_ptr<Mirror> result;
+
+        for (const auto& mirror : mirrors)
+        {
+            if (mirror->dropped)
+                continue;
+
+            if (not result || mirror->active < result->active ||
+                (mirror->active == result->active && mirror->rate() > result->rate()))
+                result = mirror;
+        }
+
+        return result;
+    }
+
+    // Stops issuing transfers to mirror, returning false if it is the last one left.
+    bool drop(const std::shared_ptr<Mirror>& mirror)
+    {
+        std::size_t left{0};
+        for (const auto& m : mirrors)
+            if (not m->dropped)
+                left++;
+
+        if (mirror->dropped || left < 2)
+            return false;
+
+        mirror->dropped = true;
+
+        if (statistics)
+            statistics->drop(mirror->uri);
+
+        return true;
+    }
+
+    // Keeps the target number of segments busy by splitting the largest outstanding one.
+    void rebalance()
+    {
+        auto min_segment_size = std::max<std::uint64_t>(configuration.min_segment_size, 1);
+
+        while (active() < target)
+        {
+            std::shared_ptr<Segment> largest;
+            std::uint64_t outstanding{0};
+
+            for (const auto& segment : segments)
+            {
+                if (not segment->sink)
+                    continue;
+
+                auto remaining = segment->end - std::min(segment->end, segment->position + segment->sink->written());
+                if (remaining > outstanding)
+                {
+                    largest = segment;
+                    outstanding = remaining;
+                }
+            }
+
+            if (not largest || outstanding < 2 * min_segment_size)
+                return;
+
+            auto split = std::make_shared<Segment>();
+            split->position = largest->end - outstanding / 2;
+            split->end = largest->end;
+
+            // The transfer of the largest segment stops once it reaches the split.
+            largest->end = split->position;
+            largest->sink->shrink(largest->end - largest->position);
+
+            segments.push_back(split);
+            attempt(split);
+        }
+    }
+
+    // Hill-climbs the number of concurrent segments towards the best aggregate
+    // throughput, measured over fixed intervals.
+    void adapt()
+    {
+        static constexpr const std::chrono::milliseconds interval{500};
+
+        if (not configuration.adaptive)
+            return;
+
+        auto now = Clock::now();
+        std::chrono::duration<double> elapsed = now - measured_at;
+
+        if (elapsed < interval)
+            return;
+
+        auto current = transferred();
+        auto rate = (current - measured) / elapsed.count();
+
+        // Probe for another connection while adding them pays off, back off if it did not.
+        if (rate > 1.1 * last_rate)
+            target = std::min(target + 1, std::max<std::size_t>(configuration.max_segments, 1));
+        else if (rate < 0.9 * last_rate && target > 1)
+            target--;
+
+        last_rate = rate;
+        measured = current;
+        measured_at = now;
+
+        rebalance();
+    }
+
+    // Reports the aggregate progress, returning non-zero to abort the transfer it is invoked for.
+    Progress::Next progress()
+    {
+        if (not failure.empty())
+            return Progress::Next::abort_operation;
+
+        adapt();
+
+        if (not handler.on_progress())
+            return Progress::Next::continue_operation;
+
+        Progress progress;
+        progress.download.total = length;
+        progress.download.current = transferred();
+
+        if (handler.on_progress()(progress) == Progress::Next::abort_operation)
+        {
+            failure = "Aborted by progress handler";
+            return Progress::Next::abort_operation;
+        }
+
+        return Progress::Next::continue_operation;
+    }
+
+    // Reports the outcome once all transfers have ended.
+    void complete()
+    {
+        if (failure.empty())
+        {
+            try
+            {
+                file->finish();
+            } catch(const std::system_error& se)
+            {
+                failure = se.what();
+            }
+        } else
+        {
+            file->abort();
+        }
+
+        atomic_state.store(core::net::http::Request::State::done);
+
+        if (not failure.empty())
+        {
+            if (handler.on_error())
+                handler.on_error()(core::net::http::Error(failure, CORE_FROM_HERE()));
+            return;
+        }
+
+        if (handler.on_response())
+            handler.on_response()(result);
+    }
+
+    // Returns the number of body bytes written so far.
+    std::uint64_t transferred() const
+    {
+        auto result = file->written();
+
+        for (const auto& segment : segments)
+            if (segment->sink)
+                result += segment->sink->written();
+
+        return result;
+    }
+
+    // Applies the options set by the caller to request.
+    void prepare(const std::shared_ptr<curl::Request>& request)
+    {
+        if (timeout.count() > 0)
+            request->set_timeout(timeout);
+
+        if (low_speed.second.count() > 0)
+            request->abort_request_if(low_speed.first, low_speed.second);
+    }
+
+    void track(const std::shared_ptr<curl::Request>& request)
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        transfers.insert(request);
+    }
+
+    void untrack(const std::shared_ptr<curl::Request>& request)
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        transfers.erase(request);
+    }
+
+    std::size_t active()
+    {
+        std::lock_guard<std::mutex> lg(guard);
+        return transfers.size();
+    }
+
+    std::atomic<core::net::http::Request::State> atomic_state;
+    ::curl::multi::Handle multi;
+    std::shared_ptr<curl::Request> probe;
+    core::net::http::Request::Configuration request_configuration;
+    std::shared_ptr<impl::FileSink> file;
+    Configuration configuration;
+    std::shared_ptr<impl::Mirrors> statistics;
+
+    std::vector<std::shared_ptr<Mirror>> mirrors;
+    // The mirror answering the probe, the validator applies to it only.
+    std::shared_ptr<Mirror> probed_mirror;
+
+    std::chrono::milliseconds timeout{0};
+    std::pair<std::uint64_t, std::chrono::seconds> low_speed{0, std::chrono::seconds{0}};
+
+    Handler handler;
+    // The response to the probe, reported on success.
+    Response result;
+    // Validates that ranges are taken from the same representation.
+    std::string validator;
+    std::uint64_t length{0};
+    std::vector<std::shared_ptr<Segment>> segments;
+    // The reason the download failed, empty unless it did.
+    std::string failure;
+
+    // Number of segments to keep busy, and the throughput measured for it.
+    std::size_t target{1};
+    double last_rate{0.};
+    std::uint64_t measured{0};
+    Clock::time_point measured_at;
+
+    // Guards the transfers in flight, which are paused and resumed from any thread.
+    std::mutex guard;
+    std::set<std::shared_ptr<curl::Request>> transfers;
+};
+}
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_CURL_SEGMENTED_DOWNLOAD_H_
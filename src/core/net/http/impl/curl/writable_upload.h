@@ -0,0 +1,173 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_CURL_WRITABLE_UPLOAD_H_
+#define CORE_NET_HTTP_IMPL_CURL_WRITABLE_UPLOAD_H_
+
+#include <core/net/http/streaming_request.h>
+
+#include "request.h"
+
+#include "../upload_queue.h"
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+namespace curl
+{
+// An upload whose body is pulled from a queue fed by an UploadWriter. Executed
+// synchronously, the transfer waits for data on the calling thread. Executed
+// asynchronously, it pauses instead and is resumed through the reactor once data
+// arrives. Writers fail once the request has completed.
+class WritableUpload : public core::net::http::StreamingRequest
+{
+public:
+    WritableUpload(const std::shared_ptr<curl::Request>& request,
+                   const std::shared_ptr<impl::UploadQueue>& queue)
+        : request(request),
+          queue(queue)
+    {
+    }
+
+    ~WritableUpload()
+    {
+        queue->finish();
+    }
+
+    State state()
+    {
+        return request->state();
+    }
+
+    void set_timeout(const std::chrono::milliseconds& timeout)
+    {
+        request->set_timeout(timeout);
+    }
+
+    Response execute(const ProgressHandler& ph)
+    {
+        return execute(ph, [](const std::string&){});
+    }
+
+    Response execute(const ProgressHandler& ph, const DataHandler& dh)
+    {
+        queue->wait_by(impl::UploadQueue::Waiting::block);
+
+        try
+        {
+            auto response = request->execute(ph, dh);
+            queue->finish();
+            return response;
+        } catch(...)
+        {
+            queue->finish();
+            throw;
+        }
+    }
+
+    void async_execute(const Handler& handler)
+    {
+        async_execute(handler, [](const std::string&){});
+    }
+
+    void async_execute(const Handler& handler, const DataHandler& dh)
+    {
+        wait_by_pausing();
+
+        auto queue = this->queue;
+
+        request->async_execute(
+                    Handler()
+                        .on_progress(handler.on_progress())
+                        .on_response([queue, handler](const Response& response)
+                        {
+                            queue->finish();
+                            if (handler.on_response())
+                                handler.on_response()(response);
+                        })
+                        .on_error([queue, handler](const core::net::Error& e)
+                        {
+                            queue->finish();
+                            if (handler.on_error())
+                                handler.on_error()(e);
+                        }),
+                    dh);
+    }
+
+    // Executes the upload asynchronously, handing the response body to the returned reader.
+    std::shared_ptr<core::net::http::BodyReader> open(const core::net::http::BodyReader::Configuration& configuration)
+    {
+        wait_by_pausing();
+
+        auto queue = this->queue;
+
+        return request->open(configuration, Handler()
+                             .on_response([queue](const Response&) { queue->finish(); })
+                             .on_error([queue](const core::net::Error&) { queue->finish(); }));
+    }
+
+    std::string url_escape(const std::string& s)
+    {
+        return request->url_escape(s);
+    }
+
+    std::string url_unescape(const std::string& s)
+    {
+        return request->url_unescape(s);
+    }
+
+    void pause()
+    {
+        request->pause();
+    }
+
+    void resume()
+    {
+        request->resume();
+    }
+
+    void abort_request_if(std::uint64_t limit, const std::chrono::seconds& time)
+    {
+        request->abort_request_if(limit, time);
+    }
+
+private:
+    // Makes the transfer pause while the queue is empty, as it runs on the reactor.
+    void wait_by_pausing()
+    {
+        // Resuming is dispatched to the reactor, never running into the transfer.
+        std::weak_ptr<curl::Request> wp{request};
+        queue->wait_by(impl::UploadQueue::Waiting::pause, [wp]()
+        {
+            if (auto sp = wp.lock())
+                sp->resume();
+        });
+    }
+
+    std::shared_ptr<curl::Request> request;
+    std::shared_ptr<impl::UploadQueue> queue;
+};
+}
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_CURL_WRITABLE_UPLOAD_H_
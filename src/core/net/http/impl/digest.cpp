@@ -0,0 +1,207 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "digest.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace impl = core::net::http::impl;
+
+namespace
+{
+inline std::uint32_t rotl(std::uint32_t x, unsigned int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+// Feeds data to transform in blocks of 64 bytes, keeping the remainder in buffer.
+template<typename Transform>
+void consume(const unsigned char* data, std::size_t size, std::uint64_t& length, unsigned char* buffer, Transform transform)
+{
+    auto used = length % 64;
+    length += size;
+
+    if (used > 0)
+    {
+        auto count = std::min<std::size_t>(64 - used, size);
+        std::memcpy(buffer + used, data, count);
+        data += count;
+        size -= count;
+
+        if (used + count < 64)
+            return;
+
+        transform(buffer);
+    }
+
+    for (; size >= 64; data += 64, size -= 64)
+        transform(data);
+
+    std::memcpy(buffer, data, size);
+}
+
+// Appends the padding and the length in bits, see RFC 1320, section 3.1 and 3.2.
+template<typename Update>
+void pad(std::uint64_t length, bool big_endian, Update update)
+{
+    unsigned char padding[72] = {0x80};
+    auto used = length % 64;
+    auto count = used < 56 ? 56 - used : 120 - used;
+
+    auto bits = length * 8;
+    for (int i = 0; i < 8; i++)
+        padding[count + i] = static_cast<unsigned char>(bits >> (big_endian ? 56 - 8 * i : 8 * i));
+
+    update(padding, count + 8);
+}
+}
+
+impl::Md4::Md4()
+    : state{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476}
+{
+}
+
+void impl::Md4::update(const void* data, std::size_t size)
+{
+    consume(static_cast<const unsigned char*>(data), size, length, buffer, [this](const unsigned char* block) { transform(block); });
+}
+
+std::string impl::Md4::digest()
+{
+    pad(length, false, [this](const unsigned char* data, std::size_t size) { update(data, size); });
+
+    std::string result(size, '\0');
+    for (std::size_t i = 0; i < size; i++)
+        result[i] = static_cast<char>(state[i / 4] >> (8 * (i % 4)));
+
+    *this = Md4{};
+    return result;
+}
+
+void impl::Md4::transform(const unsigned char* block)
+{
+    std::uint32_t x[16];
+    for (int i = 0; i < 16; i++)
+        x[i] = block[4 * i] | (block[4 * i + 1] << 8) | (block[4 * i + 2] << 16) | (static_cast<std::uint32_t>(block[4 * i + 3]) << 24);
+
+    auto a = state[0], b = state[1], c = state[2], d = state[3];
+
+    auto f = [](std::uint32_t x, std::uint32_t y, std::uint32_t z) { return (x & y) | (~x & z); };
+    auto g = [](std::uint32_t x, std::uint32_t y, std::uint32_t z) { return (x & y) | (x & z) | (y & z); };
+    auto h = [](std::uint32_t x, std::uint32_t y, std::uint32_t z) { return x ^ y ^ z; };
+
+    static constexpr const unsigned int s1[4]{3, 7, 11, 19};
+    for (int i = 0; i < 16; i++)
+    {
+        auto t = rotl(a + f(b, c, d) + x[i], s1[i % 4]);
+        a = d; d = c; c = b; b = t;
+    }
+
+    static constexpr const int k2[16]{0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15};
+    static constexpr const unsigned int s2[4]{3, 5, 9, 13};
+    for (int i = 0; i < 16; i++)
+    {
+        auto t = rotl(a + g(b, c, d) + x[k2[i]] + 0x5a827999, s2[i % 4]);
+        a = d; d = c; c = b; b = t;
+    }
+
+    static constexpr const int k3[16]{0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15};
+    static constexpr const unsigned int s3[4]{3, 9, 11, 15};
+    for (int i = 0; i < 16; i++)
+    {
+        auto t = rotl(a + h(b, c, d) + x[k3[i]] + 0x6ed9eba1, s3[i % 4]);
+        a = d; d = c; c = b; b = t;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+}
+
+impl::Sha1::Sha1()
+    : state{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0}
+{
+}
+
+void impl::Sha1::update(const void* data, std::size_t size)
+{
+    consume(static_cast<const unsigned char*>(data), size, length, buffer, [this](const unsigned char* block) { transform(block); });
+}
+
+std::string impl::Sha1::digest()
+{
+    pad(length, true, [this](const unsigned char* data, std::size_t size) { update(data, size); });
+
+    std::string result(size, '\0');
+    for (std::size_t i = 0; i < size; i++)
+        result[i] = static_cast<char>(state[i / 4] >> (24 - 8 * (i % 4)));
+
+    *this = Sha1{};
+    return result;
+}
+
+void impl::Sha1::transform(const unsigned char* block)
+{
+    std::uint32_t w[80];
+    for (int i = 0; i < 16; i++)
+        w[i] = (static_cast<std::uint32_t>(block[4 * i]) << 24) | (block[4 * i + 1] << 16) | (block[4 * i + 2] << 8) | block[4 * i + 3];
+
+    for (int i = 16; i < 80; i++)
+        w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    auto a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+    for (int i = 0; i < 80; i++)
+    {
+        std::uint32_t f, k;
+
+        if (i < 20)
+        {
+            f = (b & c) | (~b & d);
+            k = 0x5a827999;
+        } else if (i < 40)
+        {
+            f = b ^ c ^ d;
+            k = 0x6ed9eba1;
+        } else if (i < 60)
+        {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8f1bbcdc;
+        } else
+        {
+            f = b ^ c ^ d;
+            k = 0xca62c1d6;
+        }
+
+        auto t = rotl(a, 5) + f + e + k + w[i];
+        e = d; d = c; c = rotl(b, 30); b = a; a = t;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d; state[4] += e;
+}
+
+std::string impl::to_hex(const std::string& digest)
+{
+    static constexpr const char* digits{"0123456789abcdef"};
+
+    std::string result;
+    for (auto c : digest)
+    {
+        result += digits[static_cast<unsigned char>(c) >> 4];
+        result += digits[static_cast<unsigned char>(c) & 0x0f];
+    }
+
+    return result;
+}
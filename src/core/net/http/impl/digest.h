@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_DIGEST_H_
+#define CORE_NET_HTTP_IMPL_DIGEST_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// The message digests used by zsync control files, implemented here to spare a
+// dependency on a crypto library. They serve for detecting corrupt or mismatching
+// data only, and must not be relied upon for security.
+class Md4
+{
+public:
+    static constexpr const std::size_t size{16};
+
+    Md4();
+
+    void update(const void* data, std::size_t size);
+
+    // Returns the raw digest of the data hashed so far, resetting the instance.
+    std::string digest();
+
+private:
+    void transform(const unsigned char* block);
+
+    std::uint32_t state[4];
+    std::uint64_t length{0};
+    unsigned char buffer[64];
+};
+
+class Sha1
+{
+public:
+    static constexpr const std::size_t size{20};
+
+    Sha1();
+
+    void update(const void* data, std::size_t size);
+
+    // Returns the raw digest of the data hashed so far, resetting the instance.
+    std::string digest();
+
+private:
+    void transform(const unsigned char* block);
+
+    std::uint32_t state[5];
+    std::uint64_t length{0};
+    unsigned char buffer[64];
+};
+
+// Returns digest in lowercase hexadecimal notation.
+std::string to_hex(const std::string& digest);
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_DIGEST_H_
@@ -0,0 +1,649 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "disk_cache_store.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <system_error>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+struct impl::DiskCacheStore::Slot
+{
+    // 0 marks an empty slot.
+    std::uint64_t hash;
+    std::uint64_t size;
+    // Nanoseconds since the epoch.
+    std::int64_t last_used;
+};
+
+struct impl::DiskCacheStore::Index
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t slot_count;
+    std::uint64_t entries;
+    std::uint64_t size;
+
+    Slot* slots()
+    {
+        return reinterpret_cast<Slot*>(this + 1);
+    }
+};
+
+namespace
+{
+constexpr const char index_magic[8] = {'n', 'e', 't', 'c', 'p', 'p', 'i', 'x'};
+constexpr const char entry_magic[8] = {'n', 'e', 't', 'c', 'p', 'p', 'e', 'n'};
+constexpr const std::uint32_t version{1};
+
+// The index is a fixed-size open-addressing hash table, kept at most three quarters full.
+constexpr const std::uint32_t slot_count{8192};
+constexpr const std::uint64_t max_entries{slot_count / 4 * 3};
+
+constexpr const char* entry_suffix{".entry"};
+constexpr const char* temporary_prefix{".tmp-"};
+
+// Writers in other processes fill temporary files without holding the lock,
+// only files untouched for this long are considered left behind by a crash.
+constexpr const std::chrono::hours stale_temporary_age{1};
+
+// Precedes the serialized entry in an entry file.
+struct EntryHeader
+{
+    char magic[8];
+    std::uint64_t checksum;
+    std::uint64_t payload_size;
+};
+
+std::system_error system_error(const std::string& what)
+{
+    return std::system_error{errno, std::system_category(), what};
+}
+
+std::int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// FNV-1a over 64-bit words, finalized with the splitmix64 mixer. Only needs
+// to be stable on a single machine, as the cache directory is not shared
+// between machines.
+std::uint64_t hash(const char* data, std::size_t size, std::uint64_t seed = 0)
+{
+    std::uint64_t h = 14695981039346656037ULL ^ seed;
+
+    for (; size >= sizeof(std::uint64_t); data += sizeof(std::uint64_t), size -= sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        h ^= word;
+        h *= 1099511628211ULL;
+    }
+
+    for (; size > 0; data++, size--)
+    {
+        h ^= static_cast<unsigned char>(*data);
+        h *= 1099511628211ULL;
+    }
+
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+
+    return h;
+}
+
+std::uint64_t key_hash(const std::string& key)
+{
+    auto result = hash(key.data(), key.size());
+    // 0 marks empty slots.
+    return result == 0 ? 1 : result;
+}
+
+void put(std::string& out, std::uint64_t value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void put(std::string& out, const std::string& value)
+{
+    put(out, static_cast<std::uint64_t>(value.size()));
+    out.append(value);
+}
+
+// Reads back values written by put, failing on truncated input.
+class Reader
+{
+public:
+    Reader(const char* begin, const char* end) : current(begin), end(end)
+    {
+    }
+
+    bool get(std::uint64_t& value)
+    {
+        if (static_cast<std::size_t>(end - current) < sizeof(value))
+            return false;
+
+        std::memcpy(&value, current, sizeof(value));
+        current += sizeof(value);
+        return true;
+    }
+
+    bool get(std::string& value)
+    {
+        std::uint64_t size;
+        if (not get(size) || static_cast<std::uint64_t>(end - current) < size)
+            return false;
+
+        value.assign(current, size);
+        current += size;
+        return true;
+    }
+
+private:
+    const char* current;
+    const char* end;
+};
+
+std::string serialize(const std::string& key, const impl::CacheEntry& entry)
+{
+    std::string payload;
+
+    auto to_nanoseconds = [](impl::CacheEntry::Clock::time_point tp)
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count());
+    };
+
+    put(payload, key);
+    put(payload, static_cast<std::uint64_t>(entry.response.status));
+    put(payload, to_nanoseconds(entry.request_time));
+    put(payload, to_nanoseconds(entry.response_time));
+
+    std::string fields;
+    std::uint64_t field_count{0};
+    entry.response.header.enumerate([&fields, &field_count](const std::string& k, const std::set<std::string>& values)
+    {
+        for (const auto& value : values)
+        {
+            put(fields, k);
+            put(fields, value);
+            ++field_count;
+        }
+    });
+    put(payload, field_count);
+    payload.append(fields);
+
+    put(payload, static_cast<std::uint64_t>(entry.vary.size()));
+    for (const auto& pair : entry.vary)
+    {
+        put(payload, pair.first);
+        put(payload, pair.second);
+    }
+
+    put(payload, entry.response.body);
+
+    EntryHeader header;
+    std::memcpy(header.magic, entry_magic, sizeof(header.magic));
+    header.checksum = hash(payload.data(), payload.size());
+    header.payload_size = payload.size();
+
+    return std::string{reinterpret_cast<const char*>(&header), sizeof(header)} + payload;
+}
+
+// Returns the entry stored in the file at path if it is intact and stored for key.
+// corrupted is set to true if the file exists, but does not hold a valid entry.
+std::shared_ptr<impl::CacheEntry> deserialize(const std::string& path, const std::string& key, bool& corrupted)
+{
+    corrupted = false;
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return std::shared_ptr<impl::CacheEntry>{};
+
+    struct stat st;
+    if (::fstat(fd, &st) == -1 || static_cast<std::size_t>(st.st_size) < sizeof(EntryHeader))
+    {
+        ::close(fd);
+        corrupted = true;
+        return std::shared_ptr<impl::CacheEntry>{};
+    }
+
+    // The body is copied straight from the page cache into the response,
+    // without staging it in intermediate buffers.
+    std::size_t size = st.st_size;
+    auto mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED)
+        return std::shared_ptr<impl::CacheEntry>{};
+
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+
+    std::shared_ptr<void> unmap{mapping, [size](void* p) { ::munmap(p, size); }};
+
+    auto data = static_cast<const char*>(mapping);
+    EntryHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    auto payload = data + sizeof(header);
+    auto payload_size = size - sizeof(header);
+
+    if (std::memcmp(header.magic, entry_magic, sizeof(header.magic)) != 0 ||
+        header.payload_size != payload_size ||
+        header.checksum != hash(payload, payload_size))
+    {
+        corrupted = true;
+        return std::shared_ptr<impl::CacheEntry>{};
+    }
+
+    Reader reader{payload, payload + payload_size};
+
+    std::string stored_key;
+    if (not reader.get(stored_key))
+    {
+        corrupted = true;
+        return std::shared_ptr<impl::CacheEntry>{};
+    }
+
+    // Different keys hashing to the same value, not a corruption.
+    if (stored_key != key)
+        return std::shared_ptr<impl::CacheEntry>{};
+
+    auto entry = std::make_shared<impl::CacheEntry>();
+    std::uint64_t status, request_time, response_time, field_count, vary_count;
+
+    bool valid = reader.get(status) && reader.get(request_time) && reader.get(response_time) && reader.get(field_count);
+
+    for (std::uint64_t i = 0; valid && i < field_count; i++)
+    {
+        std::string k, v;
+        valid = reader.get(k) && reader.get(v);
+        if (valid)
+            entry->response.header.add(k, v);
+    }
+
+    valid = valid && reader.get(vary_count);
+
+    for (std::uint64_t i = 0; valid && i < vary_count; i++)
+    {
+        std::string k, v;
+        valid = reader.get(k) && reader.get(v);
+        if (valid)
+            entry->vary.push_back(std::make_pair(k, v));
+    }
+
+    valid = valid && reader.get(entry->response.body);
+
+    if (not valid)
+    {
+        corrupted = true;
+        return std::shared_ptr<impl::CacheEntry>{};
+    }
+
+    entry->response.status = static_cast<http::Status>(status);
+    entry->request_time = impl::CacheEntry::Clock::time_point{
+            std::chrono::duration_cast<impl::CacheEntry::Clock::duration>(std::chrono::nanoseconds{request_time})};
+    entry->response_time = impl::CacheEntry::Clock::time_point{
+            std::chrono::duration_cast<impl::CacheEntry::Clock::duration>(std::chrono::nanoseconds{response_time})};
+
+    return entry;
+}
+
+bool write_all(int fd, const std::string& data)
+{
+    std::size_t written{0};
+
+    while (written < data.size())
+    {
+        auto result = ::write(fd, data.data() + written, data.size() - written);
+        if (result == -1 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            return false;
+
+        written += result;
+    }
+
+    return true;
+}
+
+// Creates directory and all its missing parents.
+void create_directories(const std::string& directory)
+{
+    for (auto pos = directory.find('/', 1); ; pos = directory.find('/', pos + 1))
+    {
+        auto path = directory.substr(0, pos);
+        if (::mkdir(path.c_str(), 0700) == -1 && errno != EEXIST)
+            throw system_error("Could not create cache directory " + path);
+
+        if (pos == std::string::npos)
+            break;
+    }
+}
+}
+
+// Holds the in-process guard together with a lock on the index file.
+class impl::DiskCacheStore::Lock
+{
+public:
+    Lock(DiskCacheStore& store, int operation)
+        : lg(store.guard),
+          fd(store.fd)
+    {
+        while (::flock(fd, operation) == -1)
+            if (errno != EINTR)
+                throw system_error("Could not lock cache index");
+    }
+
+    ~Lock()
+    {
+        ::flock(fd, LOCK_UN);
+    }
+
+private:
+    std::lock_guard<std::mutex> lg;
+    int fd;
+};
+
+impl::DiskCacheStore::DiskCacheStore(const std::string& directory, std::uint64_t max_size)
+    : directory(directory),
+      max_size(max_size)
+{
+    create_directories(directory);
+
+    auto path = directory + "/index";
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd == -1)
+        throw system_error("Could not open cache index " + path);
+
+    std::size_t size = sizeof(Index) + slot_count * sizeof(Slot);
+
+    try
+    {
+        Lock lock{*this, LOCK_EX};
+
+        struct stat st;
+        if (::fstat(fd, &st) == -1)
+            throw system_error("Could not stat cache index " + path);
+
+        bool valid_size = static_cast<std::size_t>(st.st_size) == size;
+        if (not valid_size && ::ftruncate(fd, size) == -1)
+            throw system_error("Could not resize cache index " + path);
+
+        auto mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+            throw system_error("Could not map cache index " + path);
+
+        index = static_cast<Index*>(mapping);
+
+        if (not valid_size ||
+            std::memcmp(index->magic, index_magic, sizeof(index_magic)) != 0 ||
+            index->version != version ||
+            index->slot_count != slot_count)
+        {
+            reset();
+        } else
+        {
+            // Totals might be off after a crash in the middle of an update, the slots are authoritative.
+            index->entries = 0;
+            index->size = 0;
+
+            for (std::uint32_t i = 0; i < slot_count; i++)
+            {
+                if (index->slots()[i].hash == 0)
+                    continue;
+
+                ++index->entries;
+                index->size += index->slots()[i].size;
+            }
+
+            // A crash between renaming an entry into place and inserting its slot leaves the file behind.
+            sweep();
+        }
+    } catch(...)
+    {
+        if (index)
+            ::munmap(index, size);
+        ::close(fd);
+        throw;
+    }
+}
+
+impl::DiskCacheStore::~DiskCacheStore()
+{
+    ::munmap(index, sizeof(Index) + slot_count * sizeof(Slot));
+    ::close(fd);
+}
+
+std::shared_ptr<const impl::CacheEntry> impl::DiskCacheStore::lookup(const std::string& key)
+{
+    auto h = key_hash(key);
+
+    {
+        Lock lock{*this, LOCK_SH};
+
+        auto slot = find(h);
+        if (not slot)
+            return std::shared_ptr<const CacheEntry>{};
+
+        // Concurrent readers only ever race on storing a timestamp.
+        __atomic_store_n(&slot->last_used, now(), __ATOMIC_RELAXED);
+    }
+
+    // Entry files are replaced atomically, reading them does not need the lock.
+    bool corrupted{false};
+    auto entry = deserialize(path_for(h), key, corrupted);
+
+    if (corrupted)
+        erase(key);
+
+    return entry;
+}
+
+void impl::DiskCacheStore::store(const std::string& key, const std::shared_ptr<const CacheEntry>& entry)
+{
+    auto h = key_hash(key);
+    auto data = serialize(key, *entry);
+
+    if (data.size() > max_size)
+    {
+        erase(key);
+        return;
+    }
+
+    auto temporary = directory + "/" + temporary_prefix + "XXXXXX";
+    int tfd = ::mkstemp(&temporary[0]);
+    if (tfd == -1)
+        throw system_error("Could not create cache entry in " + directory);
+
+    // Without syncing, a crash after the rename can leave an empty entry behind.
+    bool written = write_all(tfd, data) && ::fdatasync(tfd) == 0;
+    ::close(tfd);
+
+    if (not written)
+    {
+        ::unlink(temporary.c_str());
+        throw system_error("Could not write cache entry in " + directory);
+    }
+
+    Lock lock{*this, LOCK_EX};
+
+    if (auto slot = find(h))
+        remove(slot);
+
+    make_room_for(data.size());
+
+    if (::rename(temporary.c_str(), path_for(h).c_str()) == -1)
+    {
+        ::unlink(temporary.c_str());
+        throw system_error("Could not store cache entry in " + directory);
+    }
+
+    insert(h, data.size());
+}
+
+void impl::DiskCacheStore::erase(const std::string& key)
+{
+    Lock lock{*this, LOCK_EX};
+
+    if (auto slot = find(key_hash(key)))
+        remove(slot);
+}
+
+void impl::DiskCacheStore::fill(http::Client::Metrics& metrics)
+{
+    Lock lock{*this, LOCK_SH};
+
+    metrics.cache.entries = index->entries;
+    metrics.cache.size = index->size;
+}
+
+std::string impl::DiskCacheStore::path_for(std::uint64_t hash) const
+{
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+    return directory + "/" + name + entry_suffix;
+}
+
+impl::DiskCacheStore::Slot* impl::DiskCacheStore::find(std::uint64_t hash)
+{
+    auto slots = index->slots();
+
+    for (std::uint32_t i = hash % slot_count; slots[i].hash != 0; i = (i + 1) % slot_count)
+        if (slots[i].hash == hash)
+            return &slots[i];
+
+    return nullptr;
+}
+
+void impl::DiskCacheStore::insert(std::uint64_t hash, std::uint64_t size)
+{
+    auto slots = index->slots();
+
+    auto i = hash % slot_count;
+    while (slots[i].hash != 0)
+        i = (i + 1) % slot_count;
+
+    slots[i].size = size;
+    slots[i].last_used = now();
+    slots[i].hash = hash;
+
+    ++index->entries;
+    index->size += size;
+}
+
+void impl::DiskCacheStore::remove(Slot* slot)
+{
+    auto slots = index->slots();
+
+    ::unlink(path_for(slot->hash).c_str());
+
+    --index->entries;
+    index->size -= slot->size;
+
+    // Backward shift deletion keeps the probe sequences of the remaining slots intact.
+    std::uint32_t i = slot - slots;
+    for (std::uint32_t j = (i + 1) % slot_count; slots[j].hash != 0; j = (j + 1) % slot_count)
+    {
+        std::uint32_t home = slots[j].hash % slot_count;
+        // Move slot j into the gap at i unless its home lies cyclically within (i, j].
+        bool in_place = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (in_place)
+            continue;
+
+        slots[i] = slots[j];
+        i = j;
+    }
+
+    slots[i].hash = 0;
+}
+
+void impl::DiskCacheStore::make_room_for(std::uint64_t size)
+{
+    auto slots = index->slots();
+
+    while (index->entries > 0 && (index->size + size > max_size || index->entries + 1 > max_entries))
+    {
+        Slot* lru{nullptr};
+
+        for (std::uint32_t i = 0; i < slot_count; i++)
+            if (slots[i].hash != 0 && (not lru || slots[i].last_used < lru->last_used))
+                lru = &slots[i];
+
+        remove(lru);
+    }
+}
+
+void impl::DiskCacheStore::reset()
+{
+    std::memset(index, 0, sizeof(Index) + slot_count * sizeof(Slot));
+    std::memcpy(index->magic, index_magic, sizeof(index_magic));
+    index->version = version;
+    index->slot_count = slot_count;
+
+    // Entry files are not reachable anymore without the index.
+    sweep();
+}
+
+void impl::DiskCacheStore::sweep()
+{
+    auto dir = ::opendir(directory.c_str());
+    if (not dir)
+        return;
+
+    auto now = std::chrono::system_clock::now();
+
+    while (auto e = ::readdir(dir))
+    {
+        std::string name{e->d_name};
+
+        struct stat st;
+        if (name.compare(0, std::strlen(temporary_prefix), temporary_prefix) == 0 &&
+            ::stat((directory + "/" + name).c_str(), &st) == 0 &&
+            now - std::chrono::system_clock::from_time_t(st.st_mtime) > stale_temporary_age)
+        {
+            ::unlink((directory + "/" + name).c_str());
+            continue;
+        }
+
+        if (name.size() <= std::strlen(entry_suffix) ||
+            name.compare(name.size() - std::strlen(entry_suffix), std::string::npos, entry_suffix) != 0)
+            continue;
+
+        char* end{nullptr};
+        auto hash = std::strtoull(name.c_str(), &end, 16);
+
+        if (end != name.c_str() + name.size() - std::strlen(entry_suffix) || hash == 0 || not find(hash))
+            ::unlink((directory + "/" + name).c_str());
+    }
+
+    ::closedir(dir);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_DISK_CACHE_STORE_H_
+#define CORE_NET_HTTP_IMPL_DISK_CACHE_STORE_H_
+
+#include "cache.h"
+
+#include <cstdint>
+#include <mutex>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Keeps cache entries in files below a directory, one file per entry. A hash
+// index mapped into memory keeps track of the entries and their last use and
+// is shared by all stores, possibly in different processes, using the same
+// directory. Writers hold an exclusive lock on the index file.
+//
+// Entries are written to a temporary file first and renamed into place, and
+// carry a checksum that is verified when reading them back. Torn or otherwise
+// corrupted entries are dropped. Once the accumulated size of all entries
+// exceeds the configured maximum, the least recently used ones are evicted.
+class DiskCacheStore : public CacheStore
+{
+public:
+    // Opens the store in directory, creating it and its index if necessary.
+    // Throws std::system_error if the directory or index is not accessible.
+    DiskCacheStore(const std::string& directory, std::uint64_t max_size);
+    ~DiskCacheStore();
+
+    DiskCacheStore(const DiskCacheStore&) = delete;
+    DiskCacheStore& operator=(const DiskCacheStore&) = delete;
+
+    std::shared_ptr<const CacheEntry> lookup(const std::string& key) override;
+    void store(const std::string& key, const std::shared_ptr<const CacheEntry>& entry) override;
+    void erase(const std::string& key) override;
+    void fill(http::Client::Metrics& metrics) override;
+
+private:
+    struct Index;
+    struct Slot;
+    class Lock;
+
+    // Returns the path of the entry file for a key hash.
+    std::string path_for(std::uint64_t hash) const;
+    // Returns the slot for hash or nullptr, the lock has to be held.
+    Slot* find(std::uint64_t hash);
+    // Inserts or updates the slot for hash, the exclusive lock has to be held.
+    void insert(std::uint64_t hash, std::uint64_t size);
+    // Removes slot and its entry file, the exclusive lock has to be held.
+    void remove(Slot* slot);
+    // Evicts the least recently used entries until an entry of size fits, the exclusive lock has to be held.
+    void make_room_for(std::uint64_t size);
+    // Resets the index after it was found to be missing or damaged, the exclusive lock has to be held.
+    void reset();
+    // Removes the entry files without a slot and stale temporary files, the exclusive lock has to be held.
+    void sweep();
+
+    std::string directory;
+    std::uint64_t max_size;
+
+    // Serializes access within this process, the file lock on the index
+    // only excludes other processes.
+    std::mutex guard;
+    int fd{-1};
+    Index* index{nullptr};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_DISK_CACHE_STORE_H_
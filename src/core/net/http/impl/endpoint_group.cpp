@@ -0,0 +1,392 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "endpoint_group.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+namespace
+{
+std::size_t random_index(std::size_t count)
+{
+    static thread_local std::minstd_rand generator{std::random_device{}()};
+    return std::uniform_int_distribution<std::size_t>{0, count - 1}(generator);
+}
+
+std::string without_trailing_slash(const std::string& uri)
+{
+    auto end = uri.find_last_not_of('/');
+    return end == std::string::npos ? uri : uri.substr(0, end + 1);
+}
+
+// A hash that is stable across processes and platforms, such that all clients
+// agree on the endpoint a key maps to (FNV-1a, finalized with the splitmix64 mixer).
+std::uint64_t stable_hash(const std::string& s, std::uint64_t seed)
+{
+    std::uint64_t h = 14695981039346656037ULL ^ seed;
+    for (unsigned char c : s)
+    {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+
+    return h;
+}
+
+// A failed request counts as a sample this many times slower than the average endpoint,
+// but at most as slow as max_failure_penalty seconds, unless the failure took longer.
+constexpr const double failure_penalty{4.};
+constexpr const double max_failure_penalty{30.};
+
+// Slots of the lookup table walked per endpoint before consistent_hash gives up.
+constexpr const std::size_t probe_steps{4};
+
+// Returns a prime table size of roughly 100 entries per endpoint, keeping
+// the imbalance between endpoints in the lookup table around 1%.
+std::size_t lookup_table_size(std::size_t endpoints)
+{
+    static const std::size_t primes[] = {251, 509, 1021, 2039, 4093, 8191, 16381, 32749, 65521};
+
+    for (auto prime : primes)
+        if (prime >= endpoints * 100)
+            return prime;
+
+    return primes[sizeof(primes) / sizeof(primes[0]) - 1];
+}
+}
+
+impl::EndpointGroup::EndpointGroup(const Configuration& configuration)
+    : configuration(configuration)
+{
+    for (const auto& uri : configuration.endpoints)
+    {
+        std::unique_ptr<Endpoint> endpoint{new Endpoint};
+        endpoint->uri = without_trailing_slash(uri);
+        endpoints.push_back(std::move(endpoint));
+    }
+
+    if (configuration.policy == Policy::consistent_hash && not endpoints.empty())
+        populate_lookup_table();
+}
+
+bool impl::EndpointGroup::empty() const
+{
+    return endpoints.empty();
+}
+
+const std::string& impl::EndpointGroup::endpoint(std::size_t index) const
+{
+    return endpoints.at(index)->uri;
+}
+
+std::size_t impl::EndpointGroup::select(const std::string& affinity_key)
+{
+    auto now = Clock::now().time_since_epoch().count();
+    auto count = endpoints.size();
+    std::size_t result{0};
+
+    switch (configuration.policy)
+    {
+    case Policy::round_robin:
+    {
+        auto start = next.fetch_add(1);
+        result = start % count;
+        // Skip ejected endpoints, falling back to the original pick if all of them are.
+        for (std::size_t i = 0; i < count; i++)
+        {
+            auto candidate = (start + i) % count;
+            if (eligible(candidate, now))
+            {
+                result = candidate;
+                break;
+            }
+        }
+        break;
+    }
+    case Policy::least_outstanding:
+        result = least_outstanding(now);
+        break;
+    case Policy::power_of_two_choices:
+        result = two_choices(now, false);
+        break;
+    case Policy::ewma_latency:
+        result = two_choices(now, true);
+        break;
+    case Policy::consistent_hash:
+        result = affinity_key.empty() ? two_choices(now, false) : consistent_hash(affinity_key, now);
+        break;
+    }
+
+    ++endpoints[result]->outstanding;
+    ++outstanding;
+
+    return result;
+}
+
+void impl::EndpointGroup::report(std::size_t index, bool failed, const Seconds& latency)
+{
+    auto& endpoint = *endpoints.at(index);
+    auto now = Clock::now().time_since_epoch().count();
+
+    --endpoint.outstanding;
+    --outstanding;
+    ++endpoint.requests;
+
+    if (not failed)
+    {
+        endpoint.consecutive_failures.store(0);
+        if (latency.count() > 0)
+            update_ewma(endpoint, latency, now);
+        return;
+    }
+
+    ++endpoint.failures;
+
+    // Failing fast must not make an endpoint look fast, failures raise the average to a penalty.
+    penalize(endpoint, Seconds{std::max(latency.count(), std::min(failure_penalty * mean_latency().count(), max_failure_penalty))}, now);
+
+    if (configuration.outlier_ejection.enabled &&
+        ++endpoint.consecutive_failures >= configuration.outlier_ejection.consecutive_failures)
+        eject(endpoint, now);
+}
+
+void impl::EndpointGroup::fill(http::Client::Metrics::EndpointGroup& metrics)
+{
+    auto now = Clock::now().time_since_epoch().count();
+
+    for (const auto& endpoint : endpoints)
+    {
+        auto& m = metrics.endpoints[endpoint->uri];
+        m.outstanding = endpoint->outstanding.load();
+        m.requests = endpoint->requests.load();
+        m.failures = endpoint->failures.load();
+        m.ewma_latency = Seconds{endpoint->ewma_latency.load()};
+        m.ejected = now < endpoint->ejected_until.load();
+        m.ejections = endpoint->ejections.load();
+    }
+}
+
+bool impl::EndpointGroup::eligible(std::size_t index, Clock::rep now) const
+{
+    return now >= endpoints[index]->ejected_until.load();
+}
+
+std::size_t impl::EndpointGroup::least_outstanding(Clock::rep now)
+{
+    auto count = endpoints.size();
+    // Rotate the starting point to spread ties evenly.
+    auto start = next.fetch_add(1);
+
+    std::size_t result = start % count;
+    auto least = std::numeric_limits<std::uint32_t>::max();
+    bool found_eligible{false};
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        auto candidate = (start + i) % count;
+        bool candidate_eligible = eligible(candidate, now);
+
+        if (found_eligible && not candidate_eligible)
+            continue;
+
+        auto outstanding = endpoints[candidate]->outstanding.load();
+        if (outstanding < least || (candidate_eligible && not found_eligible))
+        {
+            least = outstanding;
+            result = candidate;
+            found_eligible = candidate_eligible;
+        }
+    }
+
+    return result;
+}
+
+std::size_t impl::EndpointGroup::two_choices(Clock::rep now, bool weigh_by_latency)
+{
+    auto count = endpoints.size();
+    if (count == 1)
+        return 0;
+
+    auto first = random_index(count);
+    // Picking the second one from the remaining endpoints guarantees two distinct choices.
+    auto second = (first + 1 + random_index(count - 1)) % count;
+
+    bool first_eligible = eligible(first, now);
+    bool second_eligible = eligible(second, now);
+
+    if (not first_eligible && not second_eligible)
+        return least_outstanding(now);
+
+    if (first_eligible != second_eligible)
+        return first_eligible ? first : second;
+
+    return cost(first, weigh_by_latency) <= cost(second, weigh_by_latency) ? first : second;
+}
+
+std::size_t impl::EndpointGroup::consistent_hash(const std::string& key, Clock::rep now)
+{
+    auto size = lookup_table.size();
+    auto slot = stable_hash(key, 0) % size;
+
+    // Bounded load: allow for load_factor times the average load per endpoint,
+    // counting in the request that is about to be placed.
+    auto average = (outstanding.load() + 1) / static_cast<double>(endpoints.size());
+    auto bound = static_cast<std::uint32_t>(std::ceil(std::max(configuration.load_factor, 1.) * average));
+
+    auto preferred = lookup_table[slot];
+
+    // Walking the table visits the remaining endpoints in an order that depends
+    // on the key, spreading the load of an unavailable endpoint across the group.
+    // Slots map to endpoints at random, a walk of probe_steps slots per endpoint sees
+    // all but about 2% of them. Endpoints seen again are simply checked again, which
+    // is cheaper than keeping track of them on every selection.
+    auto steps = std::min(size, probe_steps * endpoints.size());
+
+    for (std::size_t i = 0; i < steps; i++)
+    {
+        auto candidate = lookup_table[(slot + i) % size];
+
+        if (eligible(candidate, now) && endpoints[candidate]->outstanding.load() + 1 <= bound)
+            return candidate;
+    }
+
+    return eligible(preferred, now) ? preferred : least_outstanding(now);
+}
+
+void impl::EndpointGroup::populate_lookup_table()
+{
+    auto size = lookup_table_size(endpoints.size());
+    static constexpr const std::uint32_t empty{std::numeric_limits<std::uint32_t>::max()};
+
+    lookup_table.assign(size, empty);
+
+    // Each endpoint walks its own permutation of the table, derived from its uri.
+    // Taking turns in claiming the next free slot of their permutation results in an
+    // even share per endpoint and few remapped keys as endpoints come and go (Maglev).
+    std::vector<std::size_t> offset(endpoints.size()), skip(endpoints.size()), position(endpoints.size(), 0);
+    for (std::size_t i = 0; i < endpoints.size(); i++)
+    {
+        offset[i] = stable_hash(endpoints[i]->uri, 1) % size;
+        skip[i] = stable_hash(endpoints[i]->uri, 2) % (size - 1) + 1;
+    }
+
+    std::size_t filled{0};
+    while (true)
+    {
+        for (std::size_t i = 0; i < endpoints.size(); i++)
+        {
+            auto slot = (offset[i] + position[i] * skip[i]) % size;
+            while (lookup_table[slot] != empty)
+            {
+                ++position[i];
+                slot = (offset[i] + position[i] * skip[i]) % size;
+            }
+
+            lookup_table[slot] = i;
+            ++position[i];
+
+            if (++filled == size)
+                return;
+        }
+    }
+}
+
+double impl::EndpointGroup::cost(std::size_t index, bool weigh_by_latency) const
+{
+    double load = endpoints[index]->outstanding.load() + 1;
+
+    if (not weigh_by_latency)
+        return load;
+
+    // Endpoints without samples yet are considered fast, making sure that they are probed.
+    // Failures count as slow samples, an endpoint that only fails is not preferred.
+    return endpoints[index]->ewma_latency.load() * load;
+}
+
+impl::EndpointGroup::Seconds impl::EndpointGroup::mean_latency() const
+{
+    double sum{0};
+    std::size_t sampled{0};
+
+    for (const auto& endpoint : endpoints)
+    {
+        if (endpoint->ewma_updated_at.load() == 0)
+            continue;
+
+        sum += endpoint->ewma_latency.load();
+        sampled++;
+    }
+
+    return Seconds{sampled == 0 ? 0. : sum / sampled};
+}
+
+void impl::EndpointGroup::update_ewma(Endpoint& endpoint, const Seconds& latency, Clock::rep now)
+{
+    auto last = endpoint.ewma_updated_at.exchange(now);
+    auto tau = std::chrono::duration_cast<Seconds>(configuration.ewma_decay).count();
+    auto elapsed = std::chrono::duration_cast<Seconds>(Clock::duration{now - last}).count();
+
+    // The first sample replaces the initial value, later ones are weighted by their age.
+    double weight = (last == 0 || tau <= 0) ? 0. : std::exp(-std::max(elapsed, 0.) / tau);
+
+    auto current = endpoint.ewma_latency.load();
+    while (not endpoint.ewma_latency.compare_exchange_weak(current, current * weight + latency.count() * (1. - weight)))
+        ;
+}
+
+void impl::EndpointGroup::penalize(Endpoint& endpoint, const Seconds& penalty, Clock::rep now)
+{
+    endpoint.ewma_updated_at.store(now);
+
+    // Unlike a sample, the penalty takes effect at once and only decays with later samples.
+    auto current = endpoint.ewma_latency.load();
+    while (current < penalty.count() && not endpoint.ewma_latency.compare_exchange_weak(current, penalty.count()))
+        ;
+}
+
+void impl::EndpointGroup::eject(Endpoint& endpoint, Clock::rep now)
+{
+    // Already ejected, nothing to do.
+    if (now < endpoint.ejected_until.load())
+        return;
+
+    std::size_t ejected{0};
+    for (const auto& e : endpoints)
+        if (now < e->ejected_until.load())
+            ++ejected;
+
+    auto max_ejected = std::max<std::size_t>(1, configuration.outlier_ejection.max_ejection_ratio * endpoints.size());
+    // Never eject the last endpoint standing.
+    if (ejected >= max_ejected || ejected + 1 >= endpoints.size())
+        return;
+
+    auto ejections = ++endpoint.ejections;
+    auto duration = std::min(configuration.outlier_ejection.base_ejection_time * ejections,
+                             configuration.outlier_ejection.max_ejection_time);
+
+    endpoint.consecutive_failures.store(0);
+    endpoint.ejected_until.store(now + std::chrono::duration_cast<Clock::duration>(duration).count());
+}
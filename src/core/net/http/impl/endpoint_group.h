@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_ENDPOINT_GROUP_H_
+#define CORE_NET_HTTP_IMPL_ENDPOINT_GROUP_H_
+
+#include <core/net/http/client.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Distributes requests across the endpoints of a group. The set of endpoints
+// is fixed on construction, all per-endpoint state is kept in atomics and
+// selecting an endpoint never takes a lock. All methods are thread-safe.
+class EndpointGroup
+{
+public:
+    typedef http::Client::LoadBalancing::EndpointGroup Configuration;
+    typedef http::Client::LoadBalancing::Policy Policy;
+    typedef std::chrono::steady_clock Clock;
+    typedef std::chrono::duration<double> Seconds;
+
+    EndpointGroup(const Configuration& configuration);
+
+    // Returns true if the group does not contain any endpoints.
+    bool empty() const;
+
+    // Returns the base uri of the endpoint with the given index.
+    const std::string& endpoint(std::size_t index) const;
+
+    // Selects an endpoint for a new request, accounting it as outstanding. A non-empty
+    // affinity key is mapped onto the same endpoint as long as it is eligible and not
+    // overloaded with the consistent_hash policy. The returned index has to be handed
+    // back to report once the request completed.
+    std::size_t select(const std::string& affinity_key = std::string{});
+
+    // Reports the outcome of a request sent to the endpoint with the given index.
+    void report(std::size_t index, bool failed, const Seconds& latency);
+
+    // Fills in the per-endpoint figures of the given group metrics.
+    void fill(http::Client::Metrics::EndpointGroup& metrics);
+
+private:
+    struct Endpoint
+    {
+        std::string uri;
+        std::atomic<std::uint32_t> outstanding{0};
+        std::atomic<std::uint64_t> requests{0};
+        std::atomic<std::uint64_t> failures{0};
+        std::atomic<double> ewma_latency{0};
+        std::atomic<Clock::rep> ewma_updated_at{0};
+        std::atomic<std::uint32_t> consecutive_failures{0};
+        std::atomic<Clock::rep> ejected_until{0};
+        std::atomic<std::uint32_t> ejections{0};
+    };
+
+    // Returns true if the endpoint with the given index currently accepts requests.
+    bool eligible(std::size_t index, Clock::rep now) const;
+    // Returns the index of an eligible endpoint with the fewest requests in flight.
+    std::size_t least_outstanding(Clock::rep now);
+    // Picks two random eligible endpoints and returns the cheaper one.
+    std::size_t two_choices(Clock::rep now, bool weigh_by_latency);
+    // Looks up the endpoint for key in the consistent hash table, walking on to the next
+    // endpoint in the table if the preferred one is ejected or exceeds its load bound.
+    std::size_t consistent_hash(const std::string& key, Clock::rep now);
+    // Populates the Maglev lookup table for the consistent_hash policy.
+    void populate_lookup_table();
+    // Returns the estimated cost of sending another request to the endpoint with the given index.
+    double cost(std::size_t index, bool weigh_by_latency) const;
+    // Returns the mean of the moving averages over the endpoints with samples, zero if there are none.
+    Seconds mean_latency() const;
+    // Folds the latency of a successful request into the moving average of endpoint.
+    void update_ewma(Endpoint& endpoint, const Seconds& latency, Clock::rep now);
+    // Raises the moving average of endpoint to at least penalty after a failed request.
+    void penalize(Endpoint& endpoint, const Seconds& penalty, Clock::rep now);
+    // Ejects endpoint unless too many endpoints of the group are ejected already.
+    void eject(Endpoint& endpoint, Clock::rep now);
+
+    Configuration configuration;
+    std::vector<std::unique_ptr<Endpoint>> endpoints;
+    std::atomic<std::uint64_t> next{0};
+    // Sum of the outstanding requests over all endpoints.
+    std::atomic<std::uint32_t> outstanding{0};
+    // Maps hashed keys to endpoint indices, empty unless the policy is consistent_hash.
+    std::vector<std::uint32_t> lookup_table;
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_ENDPOINT_GROUP_H_
@@ -0,0 +1,518 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "file_sink.h"
+
+#include "byte_ranges.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <set>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+namespace
+{
+std::string field(const http::Header& header, const std::string& key)
+{
+    std::string result;
+    auto canonical_key = http::Header::canonicalize_key(key);
+
+    header.enumerate([&result, &canonical_key](const std::string& k, const std::set<std::string>& values)
+    {
+        if (k == canonical_key && not values.empty())
+            result = *values.begin();
+    });
+
+    return result;
+}
+
+std::string directory_of(const std::string& path)
+{
+    auto slash = path.find_last_of('/');
+
+    if (slash == std::string::npos)
+        return ".";
+
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+// Opens a new file next to path, for writing the body before renaming it into place.
+int open_temporary(const std::string& path, std::string& temporary)
+{
+    static constexpr const unsigned int attempts{16};
+    std::random_device random;
+
+    for (unsigned int i = 0; i < attempts; i++)
+    {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), ".part-%08x", static_cast<unsigned int>(random()));
+
+        temporary = path + suffix;
+        int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+
+        if (fd != -1 || errno != EEXIST)
+            return fd;
+    }
+
+    errno = EEXIST;
+    return -1;
+}
+}
+
+impl::FileSink::FileSink(const Configuration& configuration, const std::string& uri)
+    : configuration(configuration)
+{
+    if (configuration.fd < 0 && configuration.resumable)
+    {
+        open_resumable(uri);
+        return;
+    }
+
+    if (configuration.fd >= 0)
+    {
+        fd = configuration.fd;
+        // The body is written at the current offset of the descriptor.
+        offset = ::lseek(fd, 0, SEEK_CUR);
+        if (offset < 0)
+            offset = 0;
+        return;
+    }
+
+    fd = open_temporary(configuration.path, temporary);
+    if (fd == -1)
+        throw std::system_error{errno, std::system_category(), "Could not create file for " + configuration.path};
+}
+
+impl::FileSink::FileSink(const Configuration& configuration, std::int64_t offset, std::uint64_t size)
+    : configuration(configuration),
+      fd(configuration.fd),
+      offset(offset),
+      requested(size),
+      limit(size)
+{
+}
+
+impl::FileSink::~FileSink()
+{
+    if (not done)
+        abort();
+}
+
+bool impl::FileSink::begin(http::Status status, const http::Header& header, std::int64_t expected_size)
+{
+    // A server ignoring the range sends the complete body instead.
+    if (requested >= 0 && (status != http::Status::partial_content || (expected_size >= 0 && expected_size != requested)))
+    {
+        last_error = "Expected " + std::to_string(requested) + " bytes for range, got " + std::to_string(expected_size);
+        return false;
+    }
+
+    if (verified)
+    {
+        std::uint64_t first{0}, last{0};
+        std::int64_t length{-1};
+
+        // Ranges of different representations must not end up in the same file.
+        if (not parse_content_range(field(header, "Content-Range"), first, last, length) ||
+            first != expected_first || length != static_cast<std::int64_t>(expected_length))
+        {
+            last_error = "Expected bytes from " + std::to_string(expected_first) + " of " + std::to_string(expected_length) +
+                    ", got " + field(header, "Content-Range");
+            return false;
+        }
+
+        auto validator = TransferState::validator_of(header);
+        if (not expected_validator.empty() && not validator.empty() && validator != expected_validator)
+        {
+            last_error = "Expected validator " + expected_validator + ", got " + validator;
+            return false;
+        }
+    }
+
+    if (resume_from > 0)
+    {
+        if (status != http::Status::partial_content)
+        {
+            // The representation changed, or the server does not serve ranges after all.
+            resume_from = 0;
+            ::ftruncate(fd, 0);
+        } else if (not continues(header))
+        {
+            // Never stitch different representations together, start over next time.
+            resume_from = 0;
+            ::ftruncate(fd, 0);
+            ::unlink(state_path.c_str());
+
+            last_error = "Partial response for " + state.uri + " does not continue the partial body";
+            return false;
+        }
+
+        bytes_written = resume_from;
+    }
+
+    if (resumable)
+    {
+        if (bytes_written == 0)
+        {
+            state.validator = TransferState::validator_of(header);
+            state.size = expected_size;
+        }
+
+        state.committed = bytes_written;
+        save_state();
+    }
+
+    has_begun = true;
+    buffer.resize(std::max<std::size_t>(configuration.buffer_size, 1));
+
+    // Reserving the space upfront keeps the file from being fragmented. Not
+    // changing the file size, a shorter body does not leave a gap behind.
+    if (configuration.preallocate && expected_size > 0)
+        ::fallocate(fd, FALLOC_FL_KEEP_SIZE, offset + bytes_written, expected_size);
+
+    return true;
+}
+
+bool impl::FileSink::begun() const
+{
+    return has_begun;
+}
+
+bool impl::FileSink::write(const char* data, std::size_t size)
+{
+    bool truncated{false};
+
+    if (limit >= 0 && written() + size >= static_cast<std::uint64_t>(limit))
+    {
+        truncated = written() + size > static_cast<std::uint64_t>(limit);
+        size = limit - written();
+
+        // The last bytes of a range are written right away, for complete() to tell.
+        if (not write_buffered(data, size) || not flush())
+            return false;
+
+        return not truncated;
+    }
+
+    return write_buffered(data, size);
+}
+
+bool impl::FileSink::write_buffered(const char* data, std::size_t size)
+{
+    // Large chunks bypass the buffer if there is nothing to coalesce them with.
+    if (buffered == 0 && size >= buffer.size())
+        return write_through(data, size);
+
+    while (size > 0)
+    {
+        auto count = std::min(size, buffer.size() - buffered);
+        std::memcpy(buffer.data() + buffered, data, count);
+
+        buffered += count;
+        data += count;
+        size -= count;
+
+        if (buffered == buffer.size() && not flush())
+            return false;
+    }
+
+    return true;
+}
+
+void impl::FileSink::finish()
+{
+    auto fail = [this](const std::string& what)
+    {
+        auto error = errno;
+        abort();
+        throw std::system_error{error, std::system_category(), what};
+    };
+
+    if (not flush())
+        fail(last_error);
+
+    if (configuration.sync != Sync::never && ::fdatasync(fd) == -1)
+        fail("Could not sync " + configuration.path);
+
+    if (temporary.empty())
+    {
+        // Leave the descriptor positioned after the body.
+        if (requested < 0)
+            ::lseek(fd, offset + bytes_written, SEEK_SET);
+
+        done = true;
+        return;
+    }
+
+    if (::close(fd) == -1)
+    {
+        fd = -1;
+        fail("Could not close " + temporary);
+    }
+
+    fd = -1;
+
+    if (::rename(temporary.c_str(), configuration.path.c_str()) == -1)
+        fail("Could not rename " + temporary + " to " + configuration.path);
+
+    done = true;
+
+    if (resumable)
+        ::unlink(state_path.c_str());
+
+    // Make the rename itself durable, too.
+    if (configuration.sync != Sync::never)
+    {
+        int dir = ::open(directory_of(configuration.path).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (dir != -1)
+        {
+            ::fsync(dir);
+            ::close(dir);
+        }
+    }
+}
+
+void impl::FileSink::abort()
+{
+    // Keep what has been received for a later download to resume from.
+    if (resumable && has_begun && not done && flush())
+    {
+        state.committed = bytes_written;
+        save_state();
+    }
+
+    done = true;
+    buffered = 0;
+
+    if (temporary.empty())
+        return;
+
+    if (fd != -1)
+        ::close(fd);
+
+    fd = -1;
+
+    if (not resumable)
+        ::unlink(temporary.c_str());
+}
+
+const std::string& impl::FileSink::error() const
+{
+    return last_error;
+}
+
+std::uint64_t impl::FileSink::written() const
+{
+    return bytes_written + buffered;
+}
+
+std::size_t impl::FileSink::read(std::uint64_t position, char* data, std::size_t size)
+{
+    if (not flush())
+        throw std::system_error{errno, std::system_category(), last_error};
+
+    std::size_t result{0};
+    while (result < size)
+    {
+        auto n = ::pread(fd, data + result, size - result, offset + position + result);
+
+        if (n < 0 && errno == EINTR)
+            continue;
+
+        if (n < 0)
+            throw std::system_error{errno, std::system_category(), "Could not read back " + configuration.path};
+
+        if (n == 0)
+            break;
+
+        result += n;
+    }
+
+    return result;
+}
+
+std::uint64_t impl::FileSink::resume_offset() const
+{
+    return resume_from;
+}
+
+const std::string& impl::FileSink::resume_validator() const
+{
+    return state.validator;
+}
+
+std::shared_ptr<impl::FileSink> impl::FileSink::segment(std::uint64_t offset, std::uint64_t size)
+{
+    Configuration segment{configuration};
+    segment.fd = fd;
+    segment.preallocate = false;
+    segment.sync = Sync::never;
+
+    return std::shared_ptr<FileSink>{new FileSink{segment, this->offset + static_cast<std::int64_t>(offset), size}};
+}
+
+void impl::FileSink::verify(std::uint64_t first, std::uint64_t length, const std::string& validator)
+{
+    verified = true;
+    expected_first = first;
+    expected_length = length;
+    expected_validator = validator;
+}
+
+void impl::FileSink::shrink(std::uint64_t size)
+{
+    // What has been written already stays.
+    size = std::max(size, written());
+
+    if (limit < 0 || size < static_cast<std::uint64_t>(limit))
+        limit = size;
+}
+
+bool impl::FileSink::complete() const
+{
+    return limit >= 0 && bytes_written >= static_cast<std::uint64_t>(limit);
+}
+
+void impl::FileSink::adopt(const FileSink& segment)
+{
+    bytes_written += segment.bytes_written;
+}
+
+void impl::FileSink::open_resumable(const std::string& uri)
+{
+    temporary = configuration.path + ".part";
+    state_path = temporary + ".state";
+    resumable = true;
+
+    fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if (fd == -1)
+        throw std::system_error{errno, std::system_category(), "Could not open " + temporary};
+
+    // Another download to the same path would mess with the partial body.
+    if (::flock(fd, LOCK_EX | LOCK_NB) == -1)
+    {
+        auto error = errno;
+        ::close(fd);
+        fd = -1;
+        throw std::system_error{error, std::system_category(), "Another download to " + configuration.path + " is in progress"};
+    }
+
+    struct stat st;
+    if (TransferState::load(state_path, state) && state.uri == uri && not state.validator.empty() && ::fstat(fd, &st) == 0)
+    {
+        // Only what made it to the file counts.
+        resume_from = std::min<std::uint64_t>(state.committed, st.st_size);
+
+        // Fetching the last byte again spares handling an unsatisfiable range.
+        if (state.size > 0 && resume_from >= static_cast<std::uint64_t>(state.size))
+            resume_from = state.size - 1;
+    }
+
+    if (resume_from == 0)
+    {
+        state = TransferState{};
+        state.uri = uri;
+        ::ftruncate(fd, 0);
+    }
+}
+
+bool impl::FileSink::continues(const http::Header& header) const
+{
+    std::string range;
+    header.enumerate([&range](const std::string& key, const std::set<std::string>& values)
+    {
+        if (key == "Content-Range" && not values.empty())
+            range = *values.begin();
+    });
+
+    std::uint64_t first{0}, last{0};
+    if (not parse_content_range(range, first, last) || first != resume_from)
+        return false;
+
+    // A partial response carries the validator of the complete one, see RFC 7233, section 4.1.
+    // Without one, there is no telling whether the representation is still the same.
+    auto validator = TransferState::validator_of(header);
+    return not validator.empty() && validator == state.validator;
+}
+
+void impl::FileSink::save_state()
+{
+    try
+    {
+        state.save(state_path);
+    } catch(const std::system_error&)
+    {
+        // Not worth failing the download over, it just will not resume.
+    }
+}
+
+bool impl::FileSink::flush()
+{
+    if (buffered == 0)
+        return true;
+
+    auto result = write_through(buffer.data(), buffered);
+    buffered = 0;
+
+    return result;
+}
+
+bool impl::FileSink::write_through(const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        auto result = ::pwrite(fd, data, size, offset + bytes_written);
+
+        if (result == -1 && errno == EINTR)
+            continue;
+
+        if (result == -1)
+        {
+            last_error = "Could not write to " + (temporary.empty() ? configuration.path : temporary) + ": " + std::strerror(errno);
+            return false;
+        }
+
+        data += result;
+        size -= result;
+        bytes_written += result;
+        bytes_since_sync += result;
+    }
+
+    if (configuration.sync == Sync::periodically && bytes_since_sync >= configuration.sync_interval)
+    {
+        ::fdatasync(fd);
+        bytes_since_sync = 0;
+    }
+
+    if (resumable)
+    {
+        state.committed = bytes_written;
+        save_state();
+    }
+
+    return true;
+}
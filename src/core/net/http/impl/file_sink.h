@@ -0,0 +1,156 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_FILE_SINK_H_
+#define CORE_NET_HTTP_IMPL_FILE_SINK_H_
+
+#include <core/net/http/streaming_client.h>
+
+#include <core/net/http/status.h>
+
+#include "transfer_state.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Writes a response body to a file, coalescing the chunks handed in by the
+// transfer into large writes. Targets given by path are written to a temporary
+// file next to the target, which is renamed into place once the body is complete.
+// Resumable downloads keep that file and a state file next to it if interrupted.
+// Not thread-safe, a sink is only ever driven by the transfer it belongs to.
+class FileSink
+{
+public:
+    typedef http::StreamingClient::FileSink::Configuration Configuration;
+    typedef http::StreamingClient::FileSink::Sync Sync;
+
+    // Opens the target, throws std::system_error if that fails. uri identifies
+    // the resource downloaded, for resuming an interrupted download of it.
+    FileSink(const Configuration& configuration, const std::string& uri = std::string{});
+    ~FileSink();
+
+    FileSink(const FileSink&) = delete;
+    FileSink& operator=(const FileSink&) = delete;
+
+    // Prepares for a body of expected_size bytes, negative if unknown, sent with
+    // status and header. Returns false if the body does not fit the range asked for.
+    bool begin(core::net::http::Status status, const core::net::http::Header& header, std::int64_t expected_size);
+
+    // Returns true if begin has been called.
+    bool begun() const;
+
+    // Writes size bytes of the body, returning false if that fails.
+    bool write(const char* data, std::size_t size);
+
+    // Flushes outstanding data and commits the file according to the sync policy.
+    // Throws std::system_error if that fails.
+    void finish();
+
+    // Discards the file written so far if it is a temporary one.
+    void abort();
+
+    // Returns a description of the last error.
+    const std::string& error() const;
+
+    // Returns the number of body bytes written.
+    std::uint64_t written() const;
+
+    // Reads back size bytes of the body written at position, after flushing what is
+    // buffered. Returns the number of bytes read, which is less at the end of the file.
+    std::size_t read(std::uint64_t position, char* data, std::size_t size);
+
+    // Returns the offset an interrupted download resumes at, zero if starting from scratch.
+    std::uint64_t resume_offset() const;
+
+    // Returns the validator of the representation the partial body belongs to.
+    const std::string& resume_validator() const;
+
+    // Creates a sink writing the size bytes at offset of the body to the file of
+    // this sink, for transfers of a byte range. Segments neither preallocate nor
+    // sync, and must not outlive this sink.
+    std::shared_ptr<FileSink> segment(std::uint64_t offset, std::uint64_t size);
+
+    // Makes a segment reject partial responses unless their Content-Range starts at
+    // first of a representation of length bytes. A validator given by a response has
+    // to equal validator, unless that is empty.
+    void verify(std::uint64_t first, std::uint64_t length, const std::string& validator);
+
+    // Shrinks the range of a segment to its first size bytes. Writes stop once
+    // they have been reached, reporting an error without a description.
+    void shrink(std::uint64_t size);
+
+    // Returns true if a segment has written all of its range.
+    bool complete() const;
+
+    // Accounts for the bytes written by segment.
+    void adopt(const FileSink& segment);
+
+private:
+    FileSink(const Configuration& configuration, std::int64_t offset, std::uint64_t size);
+
+    void open_resumable(const std::string& uri);
+    // Returns true if a partial response continues the partial body at hand.
+    bool continues(const core::net::http::Header& header) const;
+    void save_state();
+
+    // Writes out the buffer, returning false if that fails.
+    bool flush();
+    bool write_buffered(const char* data, std::size_t size);
+    bool write_through(const char* data, std::size_t size);
+
+    Configuration configuration;
+    int fd{-1};
+    // The temporary file renamed to configuration.path on completion, empty for fd targets.
+    std::string temporary;
+    // The offset of the body in the file.
+    std::int64_t offset{0};
+    std::uint64_t bytes_written{0};
+    std::uint64_t bytes_since_sync{0};
+    std::vector<char> buffer;
+    std::size_t buffered{0};
+    // The size of the range of a segment, and the part of it still to be written.
+    std::int64_t requested{-1};
+    std::int64_t limit{-1};
+    // What partial responses for a segment are checked against, see verify.
+    bool verified{false};
+    std::uint64_t expected_first{0};
+    std::uint64_t expected_length{0};
+    std::string expected_validator;
+    bool has_begun{false};
+    bool done{false};
+    std::string last_error;
+
+    // Resumable downloads record their progress in the state file.
+    bool resumable{false};
+    std::string state_path;
+    impl::TransferState state;
+    std::uint64_t resume_from{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_FILE_SINK_H_
@@ -0,0 +1,161 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "file_source.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace impl = core::net::http::impl;
+
+namespace
+{
+// Consumed parts of a mapping are handed back to the kernel in steps of this size,
+// keeping uploads of huge files from crowding out the page cache.
+constexpr const std::uint64_t release_step{32 * 1024 * 1024};
+}
+
+impl::FileSource::FileSource(const Configuration& configuration)
+    : configuration(configuration),
+      fd(configuration.fd)
+{
+    if (fd == -1)
+    {
+        fd = ::open(configuration.path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+            throw std::system_error{errno, std::system_category(), "Could not open " + configuration.path};
+
+        owned = true;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) == -1)
+    {
+        auto error = errno;
+        if (owned)
+            ::close(fd);
+        throw std::system_error{error, std::system_category(), "Could not inspect " + configuration.path};
+    }
+
+    auto available = static_cast<std::uint64_t>(st.st_size) > configuration.offset ? st.st_size - configuration.offset : 0;
+    length = configuration.size < 0 ? available : std::min<std::uint64_t>(configuration.size, available);
+
+    if (configuration.map && S_ISREG(st.st_mode))
+        map();
+
+    if (not mapping)
+        ::posix_fadvise(fd, configuration.offset, length, POSIX_FADV_SEQUENTIAL);
+}
+
+impl::FileSource::~FileSource()
+{
+    if (mapping)
+        ::munmap(mapping, mapped);
+
+    if (owned)
+        ::close(fd);
+}
+
+std::uint64_t impl::FileSource::size() const
+{
+    return length;
+}
+
+std::size_t impl::FileSource::read(char* data, std::size_t size)
+{
+    size = std::min<std::uint64_t>(size, length - position);
+
+    if (size == 0)
+        return 0;
+
+    if (mapping)
+    {
+        std::memcpy(data, mapping + skew + position, size);
+        position += size;
+
+        if (position - released >= release_step)
+        {
+            auto end = (skew + position) & ~static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE) - 1);
+            ::madvise(mapping + skew + released, end - skew - released, MADV_DONTNEED);
+            released = end - skew;
+        }
+
+        return size;
+    }
+
+    ssize_t result;
+    do
+    {
+        result = ::pread(fd, data, size, configuration.offset + position);
+    } while (result == -1 && errno == EINTR);
+
+    if (result == -1)
+        throw std::system_error{errno, std::system_category(), "Could not read " + configuration.path};
+
+    // The file shrank meanwhile.
+    if (result == 0)
+        throw std::system_error{EIO, std::system_category(), "Unexpected end of " + configuration.path};
+
+    position += result;
+    return result;
+}
+
+bool impl::FileSource::seek(std::uint64_t offset)
+{
+    if (offset > length)
+        return false;
+
+    position = offset;
+
+    // Pages dropped already are faulted in again on demand.
+    if (released > position)
+        released = 0;
+
+    return true;
+}
+
+void impl::FileSource::map()
+{
+    if (length == 0)
+        return;
+
+    auto page = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+    skew = configuration.offset % page;
+
+    // Bodies exceeding the address space are read instead.
+    if (length + skew > static_cast<std::uint64_t>(std::numeric_limits<std::size_t>::max()))
+        return;
+
+    mapped = length + skew;
+
+    auto result = ::mmap(nullptr, mapped, PROT_READ, MAP_SHARED, fd, configuration.offset - skew);
+    if (result == MAP_FAILED)
+    {
+        mapped = 0;
+        return;
+    }
+
+    mapping = static_cast<char*>(result);
+    ::madvise(mapping, mapped, MADV_SEQUENTIAL);
+}
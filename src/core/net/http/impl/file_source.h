@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_FILE_SOURCE_H_
+#define CORE_NET_HTTP_IMPL_FILE_SOURCE_H_
+
+#include <core/net/http/streaming_client.h>
+
+#include <cstdint>
+#include <string>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Reads a request body from a file, copying it from a read-only mapping of
+// the file or reading it with pread, both without an intermediate buffer.
+// Not thread-safe, a source is only ever drained by the transfer it belongs to.
+class FileSource
+{
+public:
+    typedef http::StreamingClient::FileSource::Configuration Configuration;
+
+    // Opens the file, throws std::system_error if that fails.
+    FileSource(const Configuration& configuration);
+    ~FileSource();
+
+    FileSource(const FileSource&) = delete;
+    FileSource& operator=(const FileSource&) = delete;
+
+    // Size of the body.
+    std::uint64_t size() const;
+
+    // Copies up to size bytes of the body following those read so far to data.
+    // Returns the number of bytes copied, 0 once the body is exhausted.
+    // Throws std::system_error if reading fails.
+    std::size_t read(char* data, std::size_t size);
+
+    // Continues reading the body at offset, returns false if offset lies beyond its end.
+    bool seek(std::uint64_t offset);
+
+private:
+    // Maps the body into memory, leaving mapping empty if that fails.
+    void map();
+
+    Configuration configuration;
+    int fd{-1};
+    bool owned{false};
+    std::uint64_t length{0};
+    std::uint64_t position{0};
+
+    // The mapping starts at the page boundary skew bytes before the body.
+    char* mapping{nullptr};
+    std::size_t mapped{0};
+    std::size_t skew{0};
+    // Bytes of the body up to here have been dropped from the page cache.
+    std::uint64_t released{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_FILE_SOURCE_H_
@@ -0,0 +1,291 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "form_body.h"
+
+#include <algorithm>
+#include <random>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+namespace
+{
+// See RFC 3986, section 2.3.
+bool is_unreserved(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+std::size_t encoded_size(const std::string& s)
+{
+    std::size_t result{0};
+
+    for (auto c : s)
+        result += is_unreserved(c) ? 1 : 3;
+
+    return result;
+}
+
+// Quotes go out percent-encoded in names and file names, as browsers send them.
+std::string quote(const std::string& s)
+{
+    std::string result;
+
+    for (auto c : s)
+    {
+        switch (c)
+        {
+        case '"': result += "%22"; break;
+        case '\r': result += "%0D"; break;
+        case '\n': result += "%0A"; break;
+        default: result += c;
+        }
+    }
+
+    return result;
+}
+
+// Unlikely enough to show up in any part, see RFC 2046, section 5.1.1.
+std::string make_boundary()
+{
+    static constexpr const char* digits{"0123456789abcdef"};
+
+    std::random_device device;
+    std::uniform_int_distribution<int> distribution(0, 15);
+
+    std::string result{"net-cpp-"};
+    for (int i = 0; i < 32; i++)
+        result += digits[distribution(device)];
+
+    return result;
+}
+}
+
+impl::UrlencodedBody::UrlencodedBody(const std::map<std::string, std::string>& values)
+{
+    for (const auto& pair : values)
+    {
+        strings.push_back(pair.first);
+        strings.push_back(pair.second);
+        total += encoded_size(pair.first) + encoded_size(pair.second);
+    }
+
+    // The separators between and within fields.
+    if (not values.empty())
+        total += 2 * values.size() - 1;
+}
+
+std::size_t impl::UrlencodedBody::size() const
+{
+    return total;
+}
+
+std::size_t impl::UrlencodedBody::read(char* dest, std::size_t size)
+{
+    std::size_t result{0};
+
+    while (result < size)
+    {
+        if (not pending.empty())
+        {
+            auto n = std::min(size - result, pending.size());
+            std::copy(pending.begin(), pending.begin() + n, dest + result);
+            pending.erase(0, n);
+            result += n;
+            continue;
+        }
+
+        if (index == strings.size())
+            break;
+
+        // Keys are followed by '=', values by '&' unless they end the body.
+        if (offset == strings[index].size())
+        {
+            index++;
+            offset = 0;
+
+            if (index < strings.size())
+                dest[result++] = index % 2 == 1 ? '=' : '&';
+
+            continue;
+        }
+
+        auto c = strings[index][offset++];
+
+        if (is_unreserved(c))
+            dest[result++] = c;
+        else
+            encode(c);
+    }
+
+    return result;
+}
+
+bool impl::UrlencodedBody::seek(std::size_t offset)
+{
+    if (offset > total)
+        return false;
+
+    index = 0;
+    this->offset = 0;
+    pending.clear();
+
+    // Escaped characters take up a varying number of bytes, the body is encoded
+    // again up to offset. Seeking only happens when a request is sent again.
+    char skipped[4096];
+    while (offset > 0)
+        offset -= read(skipped, std::min(offset, sizeof(skipped)));
+
+    return true;
+}
+
+void impl::UrlencodedBody::encode(char c)
+{
+    static constexpr const char* digits{"0123456789ABCDEF"};
+
+    auto byte = static_cast<unsigned char>(c);
+
+    pending += '%';
+    pending += digits[byte >> 4];
+    pending += digits[byte & 0x0f];
+}
+
+impl::MultipartBody::MultipartBody(const http::StreamingClient::Multipart::Parts& parts)
+    : delimiter(make_boundary())
+{
+    for (const auto& part : parts)
+    {
+        std::string header{"--" + delimiter + "\r\n"};
+        header += "Content-Disposition: form-data; name=\"" + quote(part.name) + "\"";
+
+        if (not part.filename.empty())
+            header += "; filename=\"" + quote(part.filename) + "\"";
+
+        header += "\r\n";
+
+        if (not part.type.empty())
+            header += "Content-Type: " + part.type + "\r\n";
+
+        append(header + "\r\n");
+
+        if (not part.source.path.empty() || part.source.fd >= 0)
+        {
+            flush();
+
+            Segment segment;
+            segment.file = std::make_shared<impl::FileSource>(part.source);
+            total += segment.file->size();
+            segments.push_back(segment);
+        } else
+        {
+            for (const auto& buffer : part.contents)
+            {
+                buffers.push_back(buffer);
+                total += buffer.size;
+            }
+        }
+
+        append("\r\n");
+    }
+
+    append("--" + delimiter + "--\r\n");
+    flush();
+}
+
+const std::string& impl::MultipartBody::boundary() const
+{
+    return delimiter;
+}
+
+std::uint64_t impl::MultipartBody::size() const
+{
+    return total;
+}
+
+std::size_t impl::MultipartBody::read(char* dest, std::size_t size)
+{
+    std::size_t result{0};
+
+    while (result < size && index < segments.size())
+    {
+        auto& segment = segments[index];
+
+        auto n = segment.memory ?
+                    segment.memory->read(dest + result, size - result) :
+                    segment.file->read(dest + result, size - result);
+
+        if (n == 0)
+        {
+            index++;
+            continue;
+        }
+
+        result += n;
+    }
+
+    return result;
+}
+
+bool impl::MultipartBody::seek(std::uint64_t offset)
+{
+    if (offset > total)
+        return false;
+
+    index = segments.size();
+
+    // Segments before offset are read up to their end, the ones following it from their start.
+    for (std::size_t i = 0; i < segments.size(); i++)
+    {
+        auto n = std::min(offset, segments[i].size());
+        segments[i].seek(n);
+        offset -= n;
+
+        if (n < segments[i].size() && index == segments.size())
+            index = i;
+    }
+
+    return true;
+}
+
+std::uint64_t impl::MultipartBody::Segment::size() const
+{
+    return memory ? memory->size() : file->size();
+}
+
+bool impl::MultipartBody::Segment::seek(std::uint64_t offset)
+{
+    return memory ? memory->seek(offset) : file->seek(offset);
+}
+
+void impl::MultipartBody::append(const std::string& text)
+{
+    buffers.emplace_back(std::make_shared<const std::string>(text));
+    total += text.size();
+}
+
+void impl::MultipartBody::flush()
+{
+    if (buffers.empty())
+        return;
+
+    Segment segment;
+    segment.memory = std::make_shared<impl::BufferSequence>(buffers);
+    segments.push_back(segment);
+
+    buffers.clear();
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_FORM_BODY_H_
+#define CORE_NET_HTTP_IMPL_FORM_BODY_H_
+
+#include <core/net/http/streaming_client.h>
+
+#include "buffer_sequence.h"
+#include "file_source.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Encodes form fields as application/x-www-form-urlencoded while the body is
+// read, escaping all but the unreserved characters of RFC 3986 as curl does.
+class UrlencodedBody
+{
+public:
+    UrlencodedBody(const std::map<std::string, std::string>& values);
+
+    // Size of the encoded body, known without encoding it.
+    std::size_t size() const;
+
+    // Copies up to size bytes of the encoded body following those read so far to
+    // dest, returning the number of bytes copied, 0 once the body is exhausted.
+    std::size_t read(char* dest, std::size_t size);
+
+    // Continues reading the encoded body at offset, returns false if offset lies beyond its end.
+    bool seek(std::size_t offset);
+
+private:
+    // Appends the encoding of c to pending.
+    void encode(char c);
+
+    // Key and value of each field, in order.
+    std::vector<std::string> strings;
+    std::size_t total{0};
+    // The string to encode from next, and the bytes of it encoded already.
+    std::size_t index{0};
+    std::size_t offset{0};
+    // Encoded bytes that did not fit into the last read.
+    std::string pending;
+};
+
+// Encodes form parts as multipart/form-data while the body is read. Contents in
+// memory are handed out as they are, contents of files are read part by part.
+class MultipartBody
+{
+public:
+    // Opens the files of parts, throws std::system_error if that fails.
+    MultipartBody(const http::StreamingClient::Multipart::Parts& parts);
+
+    // The boundary delimiting the parts, for the Content-Type header.
+    const std::string& boundary() const;
+
+    // Size of the encoded body.
+    std::uint64_t size() const;
+
+    // Copies up to size bytes of the encoded body following those read so far to dest,
+    // returning the number of bytes copied, 0 once the body is exhausted.
+    // Throws std::system_error if reading a file fails.
+    std::size_t read(char* dest, std::size_t size);
+
+    // Continues reading the encoded body at offset, returns false if offset lies beyond its end.
+    bool seek(std::uint64_t offset);
+
+private:
+    // Consecutive bytes of the body, taken from memory or read from a file.
+    struct Segment
+    {
+        std::shared_ptr<impl::BufferSequence> memory;
+        std::shared_ptr<impl::FileSource> file;
+
+        std::uint64_t size() const;
+        bool seek(std::uint64_t offset);
+    };
+
+    // Adds text to the in-memory bytes following the last segment.
+    void append(const std::string& text);
+    // Ends the in-memory bytes following the last segment, adding a segment for them.
+    void flush();
+
+    std::string delimiter;
+    std::vector<Segment> segments;
+    http::StreamingClient::Upload::Buffers buffers;
+    std::uint64_t total{0};
+    // The segment to read from next.
+    std::size_t index{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_FORM_BODY_H_
@@ -0,0 +1,210 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "host.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+namespace
+{
+// Beyond this many hosts, idle ones are dropped before adding another one.
+constexpr const std::size_t max_hosts{256};
+
+// Returns the offsets of the beginning and the end of the authority part of uri.
+std::pair<std::size_t, std::size_t> authority_of(const std::string& uri)
+{
+    static constexpr const char* scheme_separator{"://"};
+
+    auto authority_begin = uri.find(scheme_separator);
+    authority_begin = authority_begin == std::string::npos ? 0 : authority_begin + std::strlen(scheme_separator);
+
+    auto authority_end = uri.find_first_of("/?#", authority_begin);
+    if (authority_end == std::string::npos)
+        authority_end = uri.size();
+
+    return std::make_pair(authority_begin, authority_end);
+}
+}
+
+std::string impl::host_from_uri(const std::string& uri)
+{
+    auto authority = authority_of(uri);
+    auto authority_begin = authority.first;
+    auto authority_end = authority.second;
+
+    // Strip user information, it does not identify the host.
+    auto user_info_end = uri.rfind('@', authority_end);
+    auto host_begin = (user_info_end != std::string::npos && user_info_end >= authority_begin) ? user_info_end + 1 : authority_begin;
+
+    std::string result = uri.substr(0, authority_begin) + uri.substr(host_begin, authority_end - host_begin);
+    std::transform(result.begin(), result.end(), result.begin(), [](char c) { return std::tolower(c); });
+
+    return result;
+}
+
+std::string impl::path_from_uri(const std::string& uri)
+{
+    return uri.substr(authority_of(uri).second);
+}
+
+impl::Host::Host(const std::string& name, const http::Client::Configuration& configuration)
+    : host(name)
+{
+    if (configuration.circuit_breaker.enabled)
+        circuit_breaker.reset(new CircuitBreaker(name, configuration.circuit_breaker));
+
+    if (configuration.concurrency_limit.enabled)
+        concurrency_limiter.reset(new ConcurrencyLimiter(configuration.concurrency_limit));
+}
+
+const std::string& impl::Host::name() const
+{
+    return host;
+}
+
+impl::Host::Ticket impl::Host::admit()
+{
+    Ticket ticket;
+
+    if (circuit_breaker && not circuit_breaker->try_admit(ticket.generation))
+        throw http::Client::Errors::CircuitOpen{host, CORE_FROM_HERE()};
+
+    ticket.holds_slot = concurrency_limiter != nullptr;
+
+    return ticket;
+}
+
+void impl::Host::acquire(const Ticket& ticket)
+{
+    if (ticket.holds_slot)
+        concurrency_limiter->acquire();
+}
+
+bool impl::Host::acquire_or_enqueue(const Ticket& ticket, const std::function<void()>& start)
+{
+    if (not ticket.holds_slot)
+        return true;
+
+    return concurrency_limiter->acquire_or_enqueue(start);
+}
+
+void impl::Host::report(const Ticket& ticket, const Outcome& outcome)
+{
+    if (circuit_breaker)
+        circuit_breaker->report(ticket.generation, outcome.failed);
+
+    if (ticket.holds_slot)
+        concurrency_limiter->release(outcome.latency, outcome.failed);
+}
+
+void impl::Host::fill(http::Client::Metrics::Host& metrics)
+{
+    if (circuit_breaker)
+        circuit_breaker->fill(metrics);
+
+    if (concurrency_limiter)
+        concurrency_limiter->fill(metrics);
+}
+
+bool impl::Host::idle()
+{
+    http::Client::Metrics::Host metrics;
+    fill(metrics);
+
+    return metrics.circuit_breaker.state == http::Client::CircuitBreaker::State::closed &&
+            metrics.concurrency.in_flight == 0 &&
+            metrics.concurrency.queued == 0;
+}
+
+impl::Hosts::Hosts(const http::Client::Configuration& configuration)
+    : configuration(configuration)
+{
+    if (not configuration.circuit_breaker.enabled && not configuration.concurrency_limit.enabled)
+        unrestricted = std::make_shared<Host>(std::string{}, configuration);
+
+    for (const auto& pair : configuration.endpoint_groups)
+    {
+        auto group = std::make_shared<EndpointGroup>(pair.second);
+        if (not group->empty())
+            groups[host_from_uri(pair.first)] = std::make_pair(pair.first, group);
+    }
+}
+
+std::shared_ptr<impl::Host> impl::Hosts::for_uri(const std::string& uri)
+{
+    if (unrestricted)
+        return unrestricted;
+
+    auto name = host_from_uri(uri);
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = hosts.find(name);
+    if (it != hosts.end())
+        return it->second;
+
+    // Hosts no request refers to anymore are recreated on demand, without losing
+    // anything but the figures of a closed circuit and an adapted limit.
+    if (hosts.size() >= max_hosts)
+    {
+        for (auto jt = hosts.begin(); jt != hosts.end();)
+        {
+            if (jt->second.use_count() == 1 && jt->second->idle())
+                jt = hosts.erase(jt);
+            else
+                ++jt;
+        }
+    }
+
+    return hosts.insert(std::make_pair(name, std::make_shared<Host>(name, configuration))).first->second;
+}
+
+impl::Route impl::Hosts::route(const std::string& uri, const std::string& affinity_key)
+{
+    Route result;
+    result.uri = uri;
+
+    if (not groups.empty())
+    {
+        auto it = groups.find(host_from_uri(uri));
+        if (it != groups.end())
+        {
+            result.group = it->second.second;
+            result.endpoint = result.group->select(affinity_key);
+            result.uri = result.group->endpoint(result.endpoint) + path_from_uri(uri);
+        }
+    }
+
+    result.host = for_uri(result.uri);
+
+    return result;
+}
+
+void impl::Hosts::fill(http::Client::Metrics& metrics)
+{
+    for (const auto& pair : groups)
+        pair.second.second->fill(metrics.endpoint_groups[pair.second.first]);
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    for (const auto& pair : hosts)
+        pair.second->fill(metrics.hosts[pair.first]);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_HOST_H_
+#define CORE_NET_HTTP_IMPL_HOST_H_
+
+#include <core/net/http/client.h>
+
+#include "circuit_breaker.h"
+#include "concurrency_limiter.h"
+#include "endpoint_group.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Returns the scheme, host and port part of uri in lower case,
+// e.g. "http://127.0.0.1:5000" for "HTTP://127.0.0.1:5000/get?a=b".
+std::string host_from_uri(const std::string& uri);
+
+// Returns everything following the scheme, host and port part of uri,
+// e.g. "/get?a=b" for "http://127.0.0.1:5000/get?a=b".
+std::string path_from_uri(const std::string& uri);
+
+// Policy state shared by all requests against a single host.
+class Host
+{
+public:
+    // Bookkeeping for an individual admitted request, handed back on report.
+    struct Ticket
+    {
+        CircuitBreaker::Generation generation{0};
+        // True if the request occupies a slot of the concurrency limit.
+        bool holds_slot{false};
+    };
+
+    // Describes how an executed request went.
+    struct Outcome
+    {
+        bool failed{false};
+        ConcurrencyLimiter::Seconds latency{};
+    };
+
+    Host(const std::string& name, const http::Client::Configuration& configuration);
+
+    // Returns the name of the host, i.e., scheme, host and port.
+    const std::string& name() const;
+
+    // Admits a request against this host.
+    // Throws http::Client::Errors::CircuitOpen if the request must not be executed.
+    Ticket admit();
+
+    // Blocks until the admitted request may start without exceeding the concurrency limit.
+    void acquire(const Ticket& ticket);
+
+    // Returns true if the admitted request may start right away. Otherwise, start
+    // is invoked as soon as the concurrency limit allows for the request to proceed.
+    bool acquire_or_enqueue(const Ticket& ticket, const std::function<void()>& start);
+
+    // Reports the outcome of a request previously admitted with ticket.
+    void report(const Ticket& ticket, const Outcome& outcome);
+
+    // Fills in the figures describing this host.
+    void fill(http::Client::Metrics::Host& metrics);
+
+    // Returns true if the host carries no state worth keeping: its circuit is closed
+    // and no request is in flight or waiting for a slot.
+    bool idle();
+
+private:
+    std::string host;
+    std::unique_ptr<CircuitBreaker> circuit_breaker;
+    std::unique_ptr<ConcurrencyLimiter> concurrency_limiter;
+};
+
+// Describes where an individual request is sent to.
+struct Route
+{
+    // The uri the request is sent to, with endpoint groups resolved.
+    std::string uri;
+    // The host addressed by uri.
+    std::shared_ptr<Host> host;
+    // The group the endpoint was selected from, if the original uri addressed one.
+    std::shared_ptr<EndpointGroup> group;
+    // Index of the endpoint selected from group.
+    std::size_t endpoint{0};
+};
+
+// Thread-safe registry of all hosts and endpoint groups known to a client.
+class Hosts
+{
+public:
+    Hosts(const http::Client::Configuration& configuration);
+
+    // Resolves the host addressed by uri, creating it on first access. Without
+    // per-host policies configured, all uris share a single host without any state.
+    std::shared_ptr<Host> for_uri(const std::string& uri);
+
+    // Resolves uri against the endpoint groups and returns the route for a new
+    // request. If the uri addresses a group, the selected endpoint is accounted
+    // for an outstanding request until the outcome is reported to the group.
+    Route route(const std::string& uri, const std::string& affinity_key = std::string{});
+
+    // Fills in the per-host and per-group figures.
+    void fill(http::Client::Metrics& metrics);
+
+private:
+    http::Client::Configuration configuration;
+    // Populated on construction and immutable afterwards, keyed by normalized host.
+    std::map<std::string, std::pair<std::string, std::shared_ptr<EndpointGroup>>> groups;
+    // Shared by all uris if no per-host policy is enabled.
+    std::shared_ptr<Host> unrestricted;
+    std::mutex guard;
+    std::map<std::string, std::shared_ptr<Host>> hosts;
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_HOST_H_
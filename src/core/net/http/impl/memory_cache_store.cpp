@@ -0,0 +1,101 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memory_cache_store.h"
+
+#include <iterator>
+#include <set>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+impl::MemoryCacheStore::MemoryCacheStore(std::uint64_t max_size)
+    : max_size(max_size)
+{
+}
+
+std::shared_ptr<const impl::CacheEntry> impl::MemoryCacheStore::lookup(const std::string& key)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = index.find(key);
+    if (it == index.end())
+        return std::shared_ptr<const CacheEntry>{};
+
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+void impl::MemoryCacheStore::store(const std::string& key, const std::shared_ptr<const CacheEntry>& entry)
+{
+    auto entry_size = size_of(key, *entry);
+
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = index.find(key);
+    if (it != index.end())
+        erase(it->second);
+
+    if (entry_size > max_size)
+        return;
+
+    while (size + entry_size > max_size && not entries.empty())
+        erase(std::prev(entries.end()));
+
+    entries.push_front(std::make_pair(key, entry));
+    index[key] = entries.begin();
+    size += entry_size;
+}
+
+void impl::MemoryCacheStore::erase(const std::string& key)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto it = index.find(key);
+    if (it != index.end())
+        erase(it->second);
+}
+
+void impl::MemoryCacheStore::fill(http::Client::Metrics& metrics)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    metrics.cache.entries = entries.size();
+    metrics.cache.size = size;
+}
+
+std::uint64_t impl::MemoryCacheStore::size_of(const std::string& key, const CacheEntry& entry)
+{
+    std::uint64_t result = key.size() + entry.response.body.size();
+
+    entry.response.header.enumerate([&result](const std::string& k, const std::set<std::string>& values)
+    {
+        for (const auto& value : values)
+            result += k.size() + value.size();
+    });
+
+    for (const auto& pair : entry.vary)
+        result += pair.first.size() + pair.second.size();
+
+    return result;
+}
+
+void impl::MemoryCacheStore::erase(Entries::iterator it)
+{
+    size -= size_of(it->first, *it->second);
+    index.erase(it->first);
+    entries.erase(it);
+}
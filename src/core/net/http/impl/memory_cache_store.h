@@ -0,0 +1,67 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_MEMORY_CACHE_STORE_H_
+#define CORE_NET_HTTP_IMPL_MEMORY_CACHE_STORE_H_
+
+#include "cache.h"
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Keeps cache entries in memory, evicting the least recently used
+// ones once their accumulated size exceeds the configured maximum.
+class MemoryCacheStore : public CacheStore
+{
+public:
+    MemoryCacheStore(std::uint64_t max_size);
+
+    std::shared_ptr<const CacheEntry> lookup(const std::string& key) override;
+    void store(const std::string& key, const std::shared_ptr<const CacheEntry>& entry) override;
+    void erase(const std::string& key) override;
+    void fill(http::Client::Metrics& metrics) override;
+
+private:
+    typedef std::list<std::pair<std::string, std::shared_ptr<const CacheEntry>>> Entries;
+
+    // Returns an estimate of the memory taken by entry.
+    static std::uint64_t size_of(const std::string& key, const CacheEntry& entry);
+    // Removes the entry at it, guard has to be held.
+    void erase(Entries::iterator it);
+
+    std::uint64_t max_size;
+
+    std::mutex guard;
+    // Most recently used entries first.
+    Entries entries;
+    std::unordered_map<std::string, Entries::iterator> index;
+    std::uint64_t size{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_MEMORY_CACHE_STORE_H_
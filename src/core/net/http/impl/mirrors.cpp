@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mirrors.h"
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+void impl::Mirrors::account(const std::string& uri, std::uint64_t bytes, const std::chrono::duration<double>& busy, bool failed)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    auto& mirror = mirrors[uri];
+    mirror.bytes += bytes;
+    mirror.busy += busy;
+    mirror.transfers++;
+
+    if (failed)
+        mirror.failures++;
+}
+
+void impl::Mirrors::drop(const std::string& uri)
+{
+    std::lock_guard<std::mutex> lg(guard);
+    mirrors[uri].drops++;
+}
+
+void impl::Mirrors::fill(http::Client::Metrics& metrics)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    for (const auto& pair : mirrors)
+    {
+        auto& mirror = metrics.mirrors[pair.first];
+        mirror = pair.second;
+
+        if (mirror.busy.count() > 0)
+            mirror.throughput = mirror.bytes / mirror.busy.count();
+    }
+}
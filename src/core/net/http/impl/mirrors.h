@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_MIRRORS_H_
+#define CORE_NET_HTTP_IMPL_MIRRORS_H_
+
+#include <core/net/http/client.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Accumulates the figures of the mirrors segmented downloads of a client fetch from.
+// All methods are thread-safe.
+class Mirrors
+{
+public:
+    // Accounts for a transfer from uri that received bytes within busy.
+    void account(const std::string& uri, std::uint64_t bytes, const std::chrono::duration<double>& busy, bool failed);
+
+    // Accounts for uri having been dropped from a download.
+    void drop(const std::string& uri);
+
+    // Fills in the per-mirror figures.
+    void fill(http::Client::Metrics& metrics);
+
+private:
+    std::mutex guard;
+    std::map<std::string, http::Client::Metrics::Mirror> mirrors;
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_MIRRORS_H_
@@ -0,0 +1,165 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "receive_buffer.h"
+
+#include <algorithm>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+impl::ReceiveBuffer::ReceiveBuffer(std::size_t capacity, const std::function<void()>& wake_up)
+    : capacity(std::max<std::size_t>(capacity, 1)),
+      wake_up(wake_up),
+      ring(this->capacity)
+{
+}
+
+impl::ReceiveBuffer::Offer impl::ReceiveBuffer::offer(const char* data, std::size_t size)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (closed)
+        return Offer::closed;
+
+    if (used + size > ring.size())
+    {
+        if (used > 0)
+        {
+            refused = size;
+            return Offer::full;
+        }
+
+        // Refusing a chunk that never fits would stall the transfer for good.
+        ring.resize(size);
+        head = 0;
+    }
+
+    push(data, size);
+    changed.notify_all();
+
+    return Offer::accepted;
+}
+
+void impl::ReceiveBuffer::finish(const http::Response& response)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    outcome = response;
+    finished = true;
+    changed.notify_all();
+}
+
+void impl::ReceiveBuffer::fail(const std::exception_ptr& error)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    this->error = error;
+    finished = true;
+    changed.notify_all();
+}
+
+std::size_t impl::ReceiveBuffer::read(char* dest, std::size_t size, Waiting waiting)
+{
+    std::function<void()> wake;
+    std::size_t result{0};
+
+    {
+        std::unique_lock<std::mutex> ul(guard);
+
+        if (used == 0 && not finished && not closed && waiting == Waiting::poll)
+            return http::BodyReader::would_block;
+
+        changed.wait(ul, [this]() { return used > 0 || finished || closed; });
+
+        while (result < size && used > 0)
+        {
+            // The buffered bytes wrap around the end of the ring at most once.
+            auto n = std::min({size - result, used, ring.size() - head});
+
+            std::copy(ring.data() + head, ring.data() + head + n, dest + result);
+            result += n;
+            head = (head + n) % ring.size();
+            used -= n;
+        }
+
+        // Resume once the refused chunk fits, and not before half of the
+        // capacity is free, to not pause and resume for every chunk.
+        if (refused > 0 && (used == 0 || (used + refused <= ring.size() && used <= capacity / 2)))
+        {
+            refused = 0;
+            wake = wake_up;
+        }
+    }
+
+    // Invoked outside of the lock, the transfer offers the refused chunk right away if it can.
+    if (wake)
+        wake();
+
+    return result;
+}
+
+void impl::ReceiveBuffer::close()
+{
+    std::function<void()> wake;
+
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        closed = true;
+        head = 0;
+        used = 0;
+        changed.notify_all();
+
+        // A paused transfer has to learn that the consumer is gone.
+        if (refused > 0)
+        {
+            refused = 0;
+            wake = wake_up;
+        }
+    }
+
+    if (wake)
+        wake();
+}
+
+http::Response impl::ReceiveBuffer::response()
+{
+    std::unique_lock<std::mutex> ul(guard);
+    changed.wait(ul, [this]() { return finished; });
+
+    if (error)
+        std::rethrow_exception(error);
+
+    return outcome;
+}
+
+std::size_t impl::ReceiveBuffer::size()
+{
+    std::lock_guard<std::mutex> lg(guard);
+    return used;
+}
+
+void impl::ReceiveBuffer::push(const char* data, std::size_t size)
+{
+    auto tail = (head + used) % ring.size();
+    auto n = std::min(size, ring.size() - tail);
+
+    std::copy(data, data + n, ring.data() + tail);
+    std::copy(data + n, data + size, ring.data());
+
+    used += size;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_RECEIVE_BUFFER_H_
+#define CORE_NET_HTTP_IMPL_RECEIVE_BUFFER_H_
+
+#include <core/net/http/body_reader.h>
+#include <core/net/http/response.h>
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Bounded ring buffer between the reactor receiving a response body and the
+// consumer draining it on a thread of its own, together with the outcome of the
+// transfer. The reactor never waits: a chunk that does not fit is refused, the
+// transfer pauses, and the wake-up handler resumes it once the consumer has made room.
+class ReceiveBuffer
+{
+public:
+    // Outcome of offering a chunk.
+    enum class Offer
+    {
+        // The chunk has been buffered completely.
+        accepted,
+        // Nothing has been buffered, the chunk has to be offered again after the wake-up.
+        full,
+        // The consumer is gone, the chunk has been dropped.
+        closed
+    };
+
+    // How read waits for data.
+    enum class Waiting
+    {
+        // Blocks the calling thread until data arrives.
+        block,
+        // Returns BodyReader::would_block if no data has arrived yet.
+        poll
+    };
+
+    // Buffers at most capacity bytes, except for a single chunk larger than that.
+    // The wake-up handler is invoked once less than half of the capacity is used
+    // after a chunk has been refused, on the thread draining the buffer.
+    ReceiveBuffer(std::size_t capacity, const std::function<void()>& wake_up = std::function<void()>{});
+
+    ReceiveBuffer(const ReceiveBuffer&) = delete;
+    ReceiveBuffer& operator=(const ReceiveBuffer&) = delete;
+
+    // Buffers the size bytes at data if they fit completely.
+    Offer offer(const char* data, std::size_t size);
+
+    // Marks the end of the body, as the transfer has completed with response.
+    void finish(const http::Response& response);
+
+    // Marks the end of the body, as the transfer has failed with error.
+    void fail(const std::exception_ptr& error);
+
+    // Copies up to size bytes to dest. Returns the number of bytes copied, 0 once the
+    // body has ended and all of it has been read.
+    std::size_t read(char* dest, std::size_t size, Waiting waiting = Waiting::block);
+
+    // Drops buffered data and refuses subsequent chunks, as the consumer is gone.
+    void close();
+
+    // Waits for the end of the body, returning the response or rethrowing the error of the transfer.
+    http::Response response();
+
+    // Number of bytes buffered right now.
+    std::size_t size();
+
+private:
+    // Copies size bytes at data to the ring, which has room for them.
+    void push(const char* data, std::size_t size);
+
+    std::size_t capacity;
+    std::function<void()> wake_up;
+
+    std::mutex guard;
+    std::condition_variable changed;
+    std::vector<char> ring;
+    // Offset of the first buffered byte in ring.
+    std::size_t head{0};
+    std::size_t used{0};
+    // Size of the chunk refused since the last wake-up, 0 if none has been.
+    std::size_t refused{0};
+    bool finished{false};
+    bool closed{false};
+    http::Response outcome;
+    std::exception_ptr error;
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_RECEIVE_BUFFER_H_
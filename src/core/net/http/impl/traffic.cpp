@@ -0,0 +1,46 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "traffic.h"
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+void impl::Traffic::account(std::uint64_t wire_bytes, std::uint64_t decoded_bytes)
+{
+    this->wire_bytes += wire_bytes;
+    this->decoded_bytes += decoded_bytes;
+}
+
+void impl::Traffic::account_expectation(bool rejected, std::uint64_t saved_bytes)
+{
+    announced++;
+
+    if (not rejected)
+        return;
+
+    this->rejected++;
+    this->saved_bytes += saved_bytes;
+}
+
+void impl::Traffic::fill(http::Client::Metrics& metrics)
+{
+    metrics.received.wire_bytes = wire_bytes.load();
+    metrics.received.decoded_bytes = decoded_bytes.load();
+    metrics.expect_continue.announced = announced.load();
+    metrics.expect_continue.rejected = rejected.load();
+    metrics.expect_continue.saved_bytes = saved_bytes.load();
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_TRAFFIC_H_
+#define CORE_NET_HTTP_IMPL_TRAFFIC_H_
+
+#include <core/net/http/client.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Accumulates the response body bytes received by the requests of a client, and
+// the outcome of the request bodies they announced with Expect: 100-continue.
+// All methods are thread-safe.
+class Traffic
+{
+public:
+    // Accounts for a finished transfer that received wire_bytes from the
+    // network, handing out decoded_bytes after decoding.
+    void account(std::uint64_t wire_bytes, std::uint64_t decoded_bytes);
+
+    // Accounts for an announced request body, rejected by the server before
+    // saved_bytes of it had been sent if rejected is true.
+    void account_expectation(bool rejected, std::uint64_t saved_bytes);
+
+    // Fills in the byte counts.
+    void fill(http::Client::Metrics& metrics);
+
+private:
+    std::atomic<std::uint64_t> wire_bytes{0};
+    std::atomic<std::uint64_t> decoded_bytes{0};
+    std::atomic<std::uint64_t> announced{0};
+    std::atomic<std::uint64_t> rejected{0};
+    std::atomic<std::uint64_t> saved_bytes{0};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_TRAFFIC_H_
@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "transfer_state.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <system_error>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+namespace
+{
+// The first line of state files, guarding against reading arbitrary files.
+constexpr const char* magic{"net-cpp transfer state 1"};
+
+std::string field(const http::Header& header, const std::string& key)
+{
+    std::string result;
+    auto canonical_key = http::Header::canonicalize_key(key);
+
+    header.enumerate([&result, &canonical_key](const std::string& k, const std::set<std::string>& values)
+    {
+        if (k == canonical_key && not values.empty())
+            result = *values.begin();
+    });
+
+    return result;
+}
+}
+
+bool impl::TransferState::load(const std::string& path, TransferState& state)
+{
+    std::ifstream in{path};
+
+    std::string line, size, committed, confirmed;
+
+    if (not std::getline(in, line) || line != magic)
+        return false;
+
+    if (not std::getline(in, state.uri) ||
+        not std::getline(in, state.validator) ||
+        not std::getline(in, size) ||
+        not std::getline(in, committed))
+        return false;
+
+    char* end{nullptr};
+
+    state.size = std::strtoll(size.c_str(), &end, 10);
+    if (size.empty() || *end != '\0')
+        return false;
+
+    state.committed = std::strtoull(committed.c_str(), &end, 10);
+    if (committed.empty() || *end != '\0')
+        return false;
+
+    // Missing in files written before the flag existed.
+    state.confirmed = std::getline(in, confirmed) && confirmed == "1";
+
+    return true;
+}
+
+std::string impl::TransferState::validator_of(const http::Header& header)
+{
+    auto etag = field(header, "ETag");
+
+    if (not etag.empty() && etag.compare(0, 2, "W/") != 0)
+        return etag;
+
+    return field(header, "Last-Modified");
+}
+
+void impl::TransferState::save(const std::string& path) const
+{
+    auto temporary = path + ".new";
+
+    {
+        std::ofstream out{temporary, std::ios::trunc};
+        out << magic << '\n'
+            << uri << '\n'
+            << validator << '\n'
+            << size << '\n'
+            << committed << '\n'
+            << (confirmed ? 1 : 0) << '\n';
+
+        out.flush();
+        if (not out)
+            throw std::system_error{errno, std::system_category(), "Could not write " + temporary};
+    }
+
+    if (std::rename(temporary.c_str(), path.c_str()) == -1)
+        throw std::system_error{errno, std::system_category(), "Could not rename " + temporary + " to " + path};
+}
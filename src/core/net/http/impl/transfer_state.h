@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_TRANSFER_STATE_H_
+#define CORE_NET_HTTP_IMPL_TRANSFER_STATE_H_
+
+#include <core/net/http/header.h>
+
+#include <cstdint>
+#include <string>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// The progress of a resumable transfer, persisted in a small sidecar file
+// for a later transfer to pick up where an interrupted one left off.
+struct TransferState
+{
+    // Reads the state stored at path, returning false if there is none.
+    static bool load(const std::string& path, TransferState& state);
+
+    // Returns the validator identifying the representation described by header,
+    // preferring a strong entity tag over the modification date. Weak entity tags
+    // do not guarantee byte-wise equality and are not used, see RFC 7233, section 3.2.
+    static std::string validator_of(const core::net::http::Header& header);
+
+    // Replaces the state stored at path atomically, throwing std::system_error on failure.
+    void save(const std::string& path) const;
+
+    // The URI of the resource transferred.
+    std::string uri;
+    // Identifies the representation transferred, resuming requires it to be unchanged.
+    std::string validator;
+    // The size of the representation, negative if unknown.
+    std::int64_t size{-1};
+    // Number of bytes transferred and committed so far.
+    std::uint64_t committed{0};
+    // Whether the peer has shown that it resumes transfers, e.g., by answering 308.
+    bool confirmed{false};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_TRANSFER_STATE_H_
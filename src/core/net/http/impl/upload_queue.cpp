@@ -0,0 +1,144 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "upload_queue.h"
+
+#include <algorithm>
+
+namespace http = core::net::http;
+namespace impl = core::net::http::impl;
+
+impl::UploadQueue::UploadQueue(const Configuration& configuration)
+    : configuration(configuration)
+{
+    this->configuration.capacity = std::max<std::size_t>(configuration.capacity, 1);
+}
+
+void impl::UploadQueue::write(const char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        std::function<void()> wake;
+
+        {
+            std::unique_lock<std::mutex> ul(guard);
+
+            if (not configuration.blocking && queued + size > configuration.capacity)
+                throw Errors::Full{CORE_FROM_HERE()};
+
+            changed.wait(ul, [this]() { return closed || finished || queued < configuration.capacity; });
+
+            if (closed || finished)
+                throw Errors::Closed{CORE_FROM_HERE()};
+
+            auto piece = std::min(size, configuration.capacity - queued);
+            chunks.emplace_back(data, piece);
+            queued += piece;
+            data += piece;
+            size -= piece;
+
+            changed.notify_all();
+
+            if (waiting_for_data)
+            {
+                waiting_for_data = false;
+                wake = wake_up;
+            }
+        }
+
+        // Invoked outside of the lock, the transfer pulls right away if it can.
+        if (wake)
+            wake();
+    }
+}
+
+void impl::UploadQueue::close()
+{
+    std::function<void()> wake;
+
+    {
+        std::lock_guard<std::mutex> lg(guard);
+
+        closed = true;
+        changed.notify_all();
+
+        if (waiting_for_data)
+        {
+            waiting_for_data = false;
+            wake = wake_up;
+        }
+    }
+
+    if (wake)
+        wake();
+}
+
+void impl::UploadQueue::wait_by(Waiting waiting, const std::function<void()>& wake_up)
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    this->waiting = waiting;
+    this->wake_up = wake_up;
+}
+
+std::size_t impl::UploadQueue::pull(char* dest, std::size_t size)
+{
+    std::unique_lock<std::mutex> ul(guard);
+
+    if (queued == 0 && not closed)
+    {
+        if (waiting == Waiting::pause)
+        {
+            waiting_for_data = true;
+            return http::StreamingClient::Upload::pause;
+        }
+
+        changed.wait(ul, [this]() { return queued > 0 || closed || finished; });
+    }
+
+    std::size_t result{0};
+
+    while (result < size && not chunks.empty())
+    {
+        auto& front = chunks.front();
+        auto n = std::min(size - result, front.size() - consumed);
+
+        std::copy(front.data() + consumed, front.data() + consumed + n, dest + result);
+        result += n;
+        consumed += n;
+
+        if (consumed == front.size())
+        {
+            chunks.pop_front();
+            consumed = 0;
+        }
+    }
+
+    queued -= result;
+    changed.notify_all();
+
+    return result;
+}
+
+void impl::UploadQueue::finish()
+{
+    std::lock_guard<std::mutex> lg(guard);
+
+    finished = true;
+    waiting_for_data = false;
+    wake_up = std::function<void()>{};
+    changed.notify_all();
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_UPLOAD_QUEUE_H_
+#define CORE_NET_HTTP_IMPL_UPLOAD_QUEUE_H_
+
+#include <core/net/http/streaming_client.h>
+#include <core/net/http/upload_writer.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// Bounded queue between the producers of an upload body and the transfer
+// pulling it in. Producers write from any thread, the transfer pulls on the
+// thread executing it.
+class UploadQueue : public http::UploadWriter
+{
+public:
+    // How pull waits for data.
+    enum class Waiting
+    {
+        // Blocks the calling thread, for transfers executed synchronously.
+        block,
+        // Returns StreamingClient::Upload::pause, invoking the wake-up handler once data arrives,
+        // for transfers driven by a reactor that must not be blocked.
+        pause
+    };
+
+    UploadQueue(const Configuration& configuration);
+
+    // From core::net::http::UploadWriter
+    void write(const char* data, std::size_t size) override;
+    void close() override;
+
+    // Sets how pull waits for data and the handler invoked once data arrives after
+    // pull paused. The handler is invoked on the thread that writes the data.
+    void wait_by(Waiting waiting, const std::function<void()>& wake_up = std::function<void()>{});
+
+    // Copies up to size bytes of queued data to dest, returning the number of bytes
+    // copied, 0 once the writer has been closed and all data has been pulled.
+    std::size_t pull(char* dest, std::size_t size);
+
+    // Marks the transfer as done, failing subsequent and blocked writes.
+    void finish();
+
+private:
+    Configuration configuration;
+
+    std::mutex guard;
+    std::condition_variable changed;
+    std::deque<std::string> chunks;
+    // Bytes of the front chunk pulled already.
+    std::size_t consumed{0};
+    std::size_t queued{0};
+    bool closed{false};
+    bool finished{false};
+
+    Waiting waiting{Waiting::block};
+    std::function<void()> wake_up;
+    bool waiting_for_data{false};
+};
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_UPLOAD_QUEUE_H_
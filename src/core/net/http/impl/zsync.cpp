@@ -0,0 +1,356 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "zsync.h"
+
+#include "digest.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+
+#include <unistd.h>
+
+namespace impl = core::net::http::impl;
+
+namespace
+{
+bool is_power_of_two(std::size_t value)
+{
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+unsigned int log2_of(std::size_t value)
+{
+    unsigned int result{0};
+    while (value >>= 1)
+        result++;
+    return result;
+}
+
+std::uint64_t to_number(const std::string& key, const std::string& value)
+{
+    char* end{nullptr};
+    auto result = std::strtoull(value.c_str(), &end, 10);
+
+    if (value.empty() || *end != '\0')
+        throw std::runtime_error("Malformed zsync control file: bad " + key);
+
+    return result;
+}
+}
+
+impl::ZsyncManifest impl::ZsyncManifest::read(std::istream& in)
+{
+    ZsyncManifest result;
+    bool has_length{false};
+
+    std::string line;
+    while (std::getline(in, line) && not line.empty())
+    {
+        auto colon = line.find(": ");
+        if (colon == std::string::npos)
+            throw std::runtime_error("Malformed zsync control file: bad header line");
+
+        auto key = line.substr(0, colon);
+        auto value = line.substr(colon + 2);
+
+        if (key == "Blocksize")
+            result.block_size = to_number(key, value);
+        else if (key == "Length")
+            result.length = to_number(key, value), has_length = true;
+        else if (key == "URL")
+            result.url = value;
+        else if (key == "SHA-1")
+            std::transform(value.begin(), value.end(), std::back_inserter(result.sha1), ::tolower);
+        else if (key == "Hash-Lengths")
+        {
+            // Sequential matches, bytes of the weak and of the strong checksum.
+            char* end{nullptr};
+            result.seq_matches = std::strtoul(value.c_str(), &end, 10);
+            if (*end == ',')
+                result.rsum_bytes = std::strtoul(end + 1, &end, 10);
+            if (*end == ',')
+                result.checksum_bytes = std::strtoul(end + 1, &end, 10);
+
+            if (*end != '\0' || result.seq_matches < 1 || result.seq_matches > 2 ||
+                result.rsum_bytes < 1 || result.rsum_bytes > 4 ||
+                result.checksum_bytes < 3 || result.checksum_bytes > Md4::size)
+                throw std::runtime_error("Malformed zsync control file: bad Hash-Lengths");
+        }
+    }
+
+    if (not has_length)
+        throw std::runtime_error("Malformed zsync control file: missing Length");
+
+    if (not is_power_of_two(result.block_size))
+        throw std::runtime_error("Malformed zsync control file: bad Blocksize");
+
+    auto count = result.blocks();
+    result.weak.reserve(count);
+    result.strong.reserve(count);
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        // Weak checksums are given big-endian, leaving out leading bytes.
+        unsigned char rsum[4] = {0};
+        std::string checksum(result.checksum_bytes, '\0');
+
+        if (not in.read(reinterpret_cast<char*>(rsum) + 4 - result.rsum_bytes, result.rsum_bytes) ||
+            not in.read(&checksum[0], checksum.size()))
+            throw std::runtime_error("Malformed zsync control file: truncated block checksums");
+
+        result.weak.push_back((static_cast<std::uint32_t>(rsum[0]) << 24) | (rsum[1] << 16) | (rsum[2] << 8) | rsum[3]);
+        result.strong.push_back(checksum);
+    }
+
+    return result;
+}
+
+void impl::ZsyncManifest::write(std::istream& in, std::ostream& out, const std::string& url, std::size_t block_size)
+{
+    if (not is_power_of_two(block_size) || block_size < 64)
+        throw std::invalid_argument("Block size must be a power of two of at least 64");
+
+    std::vector<unsigned char> block(block_size);
+    std::string checksums;
+    std::uint64_t length{0};
+    Sha1 sha1;
+    Md4 md4;
+
+    while (in)
+    {
+        in.read(reinterpret_cast<char*>(block.data()), block_size);
+        auto count = static_cast<std::size_t>(in.gcount());
+        if (count == 0)
+            break;
+
+        length += count;
+        sha1.update(block.data(), count);
+
+        // The last block is padded with zeros.
+        std::fill(block.begin() + count, block.end(), 0);
+
+        auto weak = rsum(block.data(), block_size);
+        for (int shift = 24; shift >= 0; shift -= 8)
+            checksums += static_cast<char>(weak >> shift);
+
+        md4.update(block.data(), block_size);
+        checksums += md4.digest();
+    }
+
+    auto slash = url.find_last_of('/');
+
+    out << "zsync: 0.6.2\n"
+        << "Filename: " << (slash == std::string::npos ? url : url.substr(slash + 1)) << "\n"
+        << "Blocksize: " << block_size << "\n"
+        << "Length: " << length << "\n"
+        << "Hash-Lengths: 1,4," << Md4::size << "\n"
+        << "URL: " << url << "\n"
+        << "SHA-1: " << to_hex(sha1.digest()) << "\n"
+        << "\n";
+
+    out.write(checksums.data(), checksums.size());
+}
+
+std::uint32_t impl::ZsyncManifest::rsum(const unsigned char* data, std::size_t size)
+{
+    // Independent sums of wide integers, which compilers turn into vector code.
+    std::uint32_t a{0}, b{0};
+    auto n = static_cast<std::uint32_t>(size);
+
+    for (std::uint32_t i = 0; i < n; i++)
+    {
+        a += data[i];
+        b += (n - i) * data[i];
+    }
+
+    return ((a & 0xffff) << 16) | (b & 0xffff);
+}
+
+std::size_t impl::ZsyncManifest::blocks() const
+{
+    return (length + block_size - 1) / block_size;
+}
+
+std::uint32_t impl::ZsyncManifest::mask() const
+{
+    return rsum_bytes >= 4 ? 0xffffffff : (1u << (8 * rsum_bytes)) - 1;
+}
+
+std::string impl::ZsyncManifest::checksum(const unsigned char* data, std::size_t size) const
+{
+    Md4 md4;
+    md4.update(data, size);
+
+    if (size < block_size)
+    {
+        std::vector<unsigned char> padding(block_size - size);
+        md4.update(padding.data(), padding.size());
+    }
+
+    return md4.digest().substr(0, checksum_bytes);
+}
+
+std::vector<std::int64_t> impl::locate(const ZsyncManifest& manifest, int fd)
+{
+    auto count = manifest.blocks();
+    std::vector<std::int64_t> result(count, -1);
+
+    if (fd < 0 || count == 0)
+        return result;
+
+    auto mask = manifest.mask();
+
+    // Weak checksums are looked up for every byte of the seed. A bitmap of the
+    // checksums present rules out most of them before hitting the index.
+    static constexpr const std::uint32_t filter_bits{20};
+    auto filter_of = [](std::uint32_t weak) { return (weak ^ (weak >> filter_bits)) & ((1u << filter_bits) - 1); };
+
+    std::vector<bool> filter(1u << filter_bits);
+    std::unordered_map<std::uint32_t, std::vector<std::size_t>> index;
+    const std::vector<std::size_t> none;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        filter[filter_of(manifest.weak[i])] = true;
+        index[manifest.weak[i]].push_back(i);
+    }
+
+    const std::size_t block_size{manifest.block_size};
+    const auto shift = log2_of(block_size);
+
+    // A block and the one following it, for checking sequential matches.
+    const std::size_t window{2 * block_size};
+    std::vector<unsigned char> buffer(std::max<std::size_t>(1024 * 1024, 4 * window));
+    std::uint64_t base{0};
+    std::size_t filled{0};
+    bool eof{false};
+
+    // Makes the window at position available, zero-padded past the end of
+    // the file. Returns false if position is past the end of the file.
+    auto ensure = [&](std::uint64_t position)
+    {
+        if (position + window <= base + buffer.size() && (eof || position + window <= base + filled))
+            return position < base + filled;
+
+        auto keep = base + filled - std::min(position, base + filled);
+        std::memmove(buffer.data(), buffer.data() + (position - base), keep);
+        base = position;
+        filled = keep;
+
+        while (not eof && filled < buffer.size())
+        {
+            auto n = ::read(fd, buffer.data() + filled, buffer.size() - filled);
+
+            if (n < 0 && errno == EINTR)
+                continue;
+
+            if (n < 0)
+                throw std::system_error{errno, std::system_category(), "Could not read seed"};
+
+            if (n == 0)
+                eof = true;
+
+            filled += n;
+        }
+
+        std::fill(buffer.begin() + filled, buffer.end(), 0);
+        return position < base + filled;
+    };
+
+    std::uint64_t position{0};
+    std::size_t remaining{count};
+    std::uint16_t a{0}, b{0};
+    bool fresh{true};
+
+    while (remaining > 0 && ensure(position))
+    {
+        auto data = buffer.data() + (position - base);
+
+        if (fresh)
+        {
+            auto weak = ZsyncManifest::rsum(data, block_size);
+            a = weak >> 16;
+            b = weak & 0xffff;
+            fresh = false;
+        }
+
+        auto weak = ((static_cast<std::uint32_t>(a) << 16) | b) & mask;
+        bool matched{false};
+
+        if (filter[filter_of(weak)])
+        {
+            auto it = index.find(weak);
+            const auto& candidates = it == index.end() ? none : it->second;
+            std::string strong, next;
+
+            for (auto i : candidates)
+            {
+                if (result[i] >= 0)
+                    continue;
+
+                if (strong.empty())
+                    strong = manifest.checksum(data, block_size);
+
+                if (strong != manifest.strong[i])
+                    continue;
+
+                // Short checksums only count if the next block matches, too.
+                if (manifest.seq_matches > 1 && i + 1 < count)
+                {
+                    if (next.empty())
+                        next = manifest.checksum(data + block_size, block_size);
+
+                    if (next != manifest.strong[i + 1])
+                        continue;
+
+                    if (result[i + 1] < 0)
+                    {
+                        result[i + 1] = position + block_size;
+                        remaining--;
+                    }
+                }
+
+                result[i] = position;
+                remaining--;
+                matched = true;
+            }
+        }
+
+        if (matched)
+        {
+            position += block_size;
+            fresh = true;
+            continue;
+        }
+
+        // Slide the window by one byte, see the rsync technical report.
+        std::uint16_t old_byte = data[0], new_byte = data[block_size];
+        a += new_byte - old_byte;
+        b += a - (old_byte << shift);
+        position++;
+    }
+
+    return result;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NET_HTTP_IMPL_ZSYNC_H_
+#define CORE_NET_HTTP_IMPL_ZSYNC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace core
+{
+namespace net
+{
+namespace http
+{
+namespace impl
+{
+// The contents of a zsync control file, describing the blocks of a resource by a weak
+// rolling checksum and a strong MD4 checksum each, see http://zsync.moria.org.uk/.
+struct ZsyncManifest
+{
+    // Parses a control file, throwing std::runtime_error if it is malformed.
+    static ZsyncManifest read(std::istream& in);
+
+    // Writes a control file describing the data read from in, for the resource at url.
+    // Throws std::invalid_argument if block_size is not a power of two of at least 64.
+    static void write(std::istream& in, std::ostream& out, const std::string& url, std::size_t block_size);
+
+    // Returns the weak checksum of size bytes at data, a in the upper and b in the lower half.
+    static std::uint32_t rsum(const unsigned char* data, std::size_t size);
+
+    // Returns the number of blocks.
+    std::size_t blocks() const;
+
+    // Returns the bits of weak checksums covered by the control file.
+    std::uint32_t mask() const;
+
+    // Returns the truncated strong checksum of the block at data, zero-padded to block_size.
+    std::string checksum(const unsigned char* data, std::size_t size) const;
+
+    std::size_t block_size{2048};
+    std::uint64_t length{0};
+    std::string url;
+    // Lowercase hexadecimal SHA-1 of the complete resource, empty if not given.
+    std::string sha1;
+
+    // Number of consecutive blocks that need to match, and the bytes of the checksums given.
+    unsigned int seq_matches{1};
+    unsigned int rsum_bytes{4};
+    unsigned int checksum_bytes{16};
+
+    std::vector<std::uint32_t> weak;
+    std::vector<std::string> strong;
+};
+
+// Scans the file open at fd for blocks of manifest, returning the offset each block
+// was found at, or -1 for blocks that are missing. Throws std::system_error if reading fails.
+std::vector<std::int64_t> locate(const ZsyncManifest& manifest, int fd);
+}
+}
+}
+}
+
+#endif // CORE_NET_HTTP_IMPL_ZSYNC_H_
@@ -0,0 +1,56 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <core/net/http/streaming_request.h>
+
+#include <core/net/http/error.h>
+
+#include "impl/curl/buffered_download.h"
+#include "impl/curl/request.h"
+#include "impl/curl/resumable_upload.h"
+#include "impl/curl/writable_upload.h"
+
+namespace http = core::net::http;
+
+std::shared_ptr<http::BodyReader> http::StreamingRequest::open(const http::BodyReader::Configuration& configuration)
+{
+    auto *curl_request = dynamic_cast<http::impl::curl::Request*>(this);
+    if (curl_request)
+    {
+        return curl_request->open(configuration);
+    }
+
+    auto *buffered_download = dynamic_cast<http::impl::curl::BufferedDownload*>(this);
+    if (buffered_download)
+    {
+        return buffered_download->open(configuration);
+    }
+
+    auto *writable_upload = dynamic_cast<http::impl::curl::WritableUpload*>(this);
+    if (writable_upload)
+    {
+        return writable_upload->open(configuration);
+    }
+
+    auto *resumable_upload = dynamic_cast<http::impl::curl::ResumableUpload*>(this);
+    if (resumable_upload)
+    {
+        return resumable_upload->open(configuration);
+    }
+
+    // Segmented, mirrored and delta downloads assemble their body in a file.
+    throw http::Error("The body of the request is written to a file", CORE_FROM_HERE());
+}
@@ -21,18 +21,33 @@
 #include <core/net/http/content_type.h>
 #include <core/net/http/request.h>
 #include <core/net/http/response.h>
+#include <core/net/http/streaming_client.h>
 
 #include "httpbin.h"
 #include "table.h"
+#include "temporary_directory.h"
 
 #include <gtest/gtest.h>
 
 #include <json/json.h>
 
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
 
 #include <future>
 
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 namespace http = core::net::http;
 namespace json = Json;
 namespace net = core::net;
@@ -111,6 +126,86 @@ struct HttpClientLoadTest : public ::testing::Test
     }
 };
 
+// Accepts uploads on a loopback port, discarding their bodies, so that
+// measurements are not dominated by a server processing the data.
+struct LoopbackSink
+{
+    LoopbackSink()
+    {
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        socklen_t length = sizeof(address);
+        ::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::listen(fd, 4);
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+        port = ntohs(address.sin_port);
+
+        worker = std::thread{[this]()
+        {
+            int connection;
+            while ((connection = ::accept(fd, nullptr, nullptr)) != -1)
+            {
+                serve(connection);
+                ::close(connection);
+            }
+        }};
+    }
+
+    ~LoopbackSink()
+    {
+        ::shutdown(fd, SHUT_RDWR);
+        ::close(fd);
+        worker.join();
+    }
+
+    std::string url() const
+    {
+        return "http://127.0.0.1:" + std::to_string(port) + "/upload";
+    }
+
+    // Answers the requests coming in on connection, until the client hangs up.
+    void serve(int connection)
+    {
+        std::vector<char> buffer(1024 * 1024);
+        std::string head;
+        ssize_t n;
+
+        while ((n = ::recv(connection, buffer.data(), buffer.size(), 0)) > 0)
+        {
+            head.append(buffer.data(), n);
+
+            auto end = head.find("\r\n\r\n");
+            if (end == std::string::npos)
+                continue;
+
+            std::uint64_t length{0};
+            auto pos = head.find("Content-Length: ");
+            if (pos != std::string::npos && pos < end)
+                length = std::stoull(head.substr(pos + 16));
+
+            if (head.find("Expect: 100-continue") < end)
+                ::send(connection, "HTTP/1.1 100 Continue\r\n\r\n", 25, MSG_NOSIGNAL);
+
+            std::uint64_t received = head.size() - end - 4;
+            while (received < length && (n = ::recv(connection, buffer.data(), std::min<std::uint64_t>(buffer.size(), length - received), 0)) > 0)
+                received += n;
+
+            static const std::string response{"HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n"};
+            ::send(connection, response.data(), response.size(), MSG_NOSIGNAL);
+            head.clear();
+        }
+    }
+
+    int fd;
+    unsigned short port;
+    std::thread worker;
+};
+
 bool init()
 {
     static httpbin::Instance instance;
@@ -205,3 +300,221 @@ TEST_F(HttpClientLoadTest, async_post_request_for_existing_resource_succeeds)
 
     run(request_factory, response_verifier);
 }
+
+TEST_F(HttpClientLoadTest, cache_hit_latency_for_memory_and_disk_stores)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::cache();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-cache-"};
+
+    static constexpr const unsigned int total{1000};
+
+    auto measure = [url](const http::Client::Configuration& configuration)
+    {
+        auto client = http::make_client(configuration);
+
+        // Populates the cache.
+        client->get(http::Request::Configuration::from_uri_as_string(url))->execute(http::Request::ProgressHandler{});
+
+        std::chrono::duration<double> min{std::chrono::hours{1}}, max{0}, sum{0};
+
+        for (unsigned int i = 0; i < total; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto response = client->get(http::Request::Configuration::from_uri_as_string(url))->execute(http::Request::ProgressHandler{});
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            EXPECT_EQ(core::net::http::Status::ok, response.status);
+
+            min = std::min(min, elapsed);
+            max = std::max(max, elapsed);
+            sum += elapsed;
+        }
+
+        EXPECT_EQ(total, client->metrics().cache.hits);
+
+        return std::make_tuple(min, max, sum / total);
+    };
+
+    http::Client::Configuration memory;
+    memory.cache.enabled = true;
+
+    http::Client::Configuration disk;
+    disk.cache.enabled = true;
+    disk.cache.directory = directory.path;
+
+    testing::Table::Row<15, '|'> row;
+    testing::Table::Row<15, '|'>::HorizontalSeparator<4> sep;
+
+    std::cout << sep;
+    std::cout << (row << "Store" << "Min [s]" << "Max [s]" << "Mean [s]");
+    std::cout << sep;
+
+    auto m = measure(memory);
+    std::cout << (row << "Memory" << std::get<0>(m).count() << std::get<1>(m).count() << std::get<2>(m).count());
+
+    auto d = measure(disk);
+    std::cout << (row << "Disk" << std::get<0>(d).count() << std::get<1>(d).count() << std::get<2>(d).count());
+    std::cout << sep;
+}
+
+TEST_F(HttpClientLoadTest, segmented_download_throughput_against_single_stream)
+{
+    // The server paces every response, as a congested link would.
+    auto url = std::string(httpbin::host) + httpbin::resources::slow_range();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    auto client = http::make_streaming_client();
+
+    auto measure = [](const std::function<http::Response()>& download)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto response = download();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        EXPECT_EQ(core::net::http::Status::ok, response.status);
+
+        return elapsed;
+    };
+
+    std::size_t size{0};
+
+    auto single = measure([client, url, &size]()
+    {
+        auto response = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))
+                ->execute(http::Request::ProgressHandler{}, [](const std::string&) {});
+        size = response.body.size();
+        return response;
+    });
+
+    auto segmented = [client, url, &directory, measure](std::size_t segments, std::size_t max_segments, bool adaptive)
+    {
+        http::StreamingClient::FileSink::Configuration sink;
+        sink.path = directory.path + "/range";
+        sink.sync = http::StreamingClient::FileSink::Sync::never;
+
+        http::StreamingClient::Segmentation::Configuration segmentation;
+        segmentation.segments = segments;
+        segmentation.max_segments = max_segments;
+        segmentation.min_segment_size = 4 * 1024;
+        segmentation.adaptive = adaptive;
+
+        return measure([client, url, sink, segmentation]()
+        {
+            return client->segmented_get_to_file(http::Request::Configuration::from_uri_as_string(url), sink, segmentation)
+                    ->execute(http::Request::ProgressHandler{}, [](const std::string&) {});
+        });
+    };
+
+    testing::Table::Row<15, '|'> row;
+    testing::Table::Row<15, '|'>::HorizontalSeparator<4> sep;
+
+    auto throughput = [size](const std::chrono::duration<double>& elapsed)
+    {
+        return size / 1024. / elapsed.count();
+    };
+
+    std::cout << sep;
+    std::cout << (row << "Mode" << "Segments" << "Time [s]" << "Rate [KiB/s]");
+    std::cout << sep;
+    std::cout << (row << "Single" << 1 << single.count() << throughput(single));
+
+    std::chrono::duration<double> four;
+
+    for (std::size_t segments : {2, 4, 8})
+    {
+        auto elapsed = segmented(segments, segments, false);
+        if (segments == 4)
+            four = elapsed;
+
+        std::cout << (row << "Segmented" << segments << elapsed.count() << throughput(elapsed));
+    }
+
+    auto adaptive = segmented(2, 8, true);
+    std::cout << (row << "Adaptive" << "2-8" << adaptive.count() << throughput(adaptive));
+    std::cout << sep;
+
+    EXPECT_LT(four.count(), single.count());
+}
+
+TEST_F(HttpClientLoadTest, file_upload_throughput_against_istream)
+{
+    // The size of the upload can be raised for benchmarking, the default keeps the test quick.
+    std::uint64_t size{256 * 1024 * 1024};
+    if (auto value = std::getenv("NET_CPP_UPLOAD_BENCHMARK_SIZE"))
+        size = std::stoull(value);
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-upload-"};
+
+    // A sparse file, the measurements should not depend on the disk.
+    auto path = directory.path + "/upload";
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0600);
+    ASSERT_NE(-1, fd);
+    ASSERT_EQ(0, ::ftruncate(fd, size));
+    ::close(fd);
+
+    LoopbackSink sink;
+    auto client = http::make_streaming_client();
+    auto configuration = http::Request::Configuration::from_uri_as_string(sink.url());
+
+    // Uploads are executed on the calling thread, its CPU time is what the client spends.
+    auto cpu = []()
+    {
+        rusage usage;
+        ::getrusage(RUSAGE_THREAD, &usage);
+        return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    };
+
+    auto measure = [cpu](const std::function<std::shared_ptr<http::StreamingRequest>()>& upload)
+    {
+        auto request = upload();
+
+        auto start = std::chrono::steady_clock::now();
+        auto used = cpu();
+        auto response = request->execute(http::Request::ProgressHandler{}, [](const std::string&) {});
+
+        EXPECT_EQ(core::net::http::Status::ok, response.status);
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return std::make_pair(elapsed.count(), cpu() - used);
+    };
+
+    std::ifstream in{path, std::ios::binary};
+    auto stream = measure([client, configuration, &in, size]()
+    {
+        return client->streaming_put(configuration, in, size);
+    });
+
+    http::StreamingClient::FileSource::Configuration source;
+    source.path = path;
+
+    auto mapped = measure([client, configuration, source]()
+    {
+        return client->streaming_put_file(configuration, source);
+    });
+
+    source.map = false;
+    auto read = measure([client, configuration, source]()
+    {
+        return client->streaming_put_file(configuration, source);
+    });
+
+    testing::Table::Row<15, '|'> row;
+    testing::Table::Row<15, '|'>::HorizontalSeparator<4> sep;
+
+    auto throughput = [size](double elapsed)
+    {
+        return size / 1024. / 1024. / elapsed;
+    };
+
+    std::cout << sep;
+    std::cout << (row << "Source" << "Time [s]" << "Rate [MiB/s]" << "CPU [s]");
+    std::cout << sep;
+    std::cout << (row << "istream" << stream.first << throughput(stream.first) << stream.second);
+    std::cout << (row << "mmap" << mapped.first << throughput(mapped.first) << mapped.second);
+    std::cout << (row << "pread" << read.first << throughput(read.first) << read.second);
+    std::cout << sep;
+
+    ::unlink(path.c_str());
+}
@@ -25,13 +25,20 @@
 #include <core/net/http/response.h>
 
 #include "httpbin.h"
+#include "temporary_directory.h"
 
 #include <gtest/gtest.h>
 
 #include <json/json.h>
 
+#include <cstdlib>
 #include <future>
 #include <fstream>
+#include <sstream>
+#include <set>
+#include <system_error>
+
+#include <utime.h>
 
 namespace http = core::net::http;
 namespace json = Json;
@@ -429,6 +436,60 @@ TEST(HttpClient, post_request_for_existing_resource_succeeds)
     EXPECT_EQ(payload, root["data"].asString());
 }
 
+TEST(HttpClient, post_request_takes_over_payload_with_embedded_nul)
+{
+    auto client = http::make_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::post();
+
+    // The payload goes out as is, up to its size rather than its first NUL.
+    std::string payload{"{ 'test': '\0' }", 15};
+    auto expected = payload;
+
+    auto request = client->post(http::Request::Configuration::from_uri_as_string(url),
+                                std::move(payload),
+                                core::net::http::ContentType::json);
+
+    auto response = request->execute(default_progress_reporter);
+
+    json::Value root;
+    json::Reader reader;
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ(expected, root["data"].asString());
+}
+
+TEST(HttpClient, post_requests_share_immutable_payload)
+{
+    auto client = http::make_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::post();
+
+    auto payload = std::make_shared<const std::string>("{ 'test': 'shared' }");
+
+    auto first = client->post(http::Request::Configuration::from_uri_as_string(url), payload, core::net::http::ContentType::json);
+    auto second = client->post(http::Request::Configuration::from_uri_as_string(url), payload, core::net::http::ContentType::json);
+
+    // The requests keep the payload alive, instead of copies of it.
+    EXPECT_EQ(3, payload.use_count());
+
+    for (const auto& request : {first, second})
+    {
+        auto response = request->execute(default_progress_reporter);
+
+        json::Value root;
+        json::Reader reader;
+
+        EXPECT_EQ(core::net::http::Status::ok, response.status);
+        EXPECT_TRUE(reader.parse(response.body, root));
+        EXPECT_EQ(*payload, root["data"].asString());
+    }
+
+    first.reset();
+    second.reset();
+
+    EXPECT_EQ(1, payload.use_count());
+}
+
 TEST(HttpClient, post_form_request_for_existing_resource_succeeds)
 {
     // We obtain a default client instance, dispatching to the default implementation.
@@ -585,6 +646,915 @@ TEST(HttpClient, get_request_for_http_headers_checking)
     EXPECT_TRUE(headers.has("Content-Type", core::net::http::ContentType::json));
 }
 
+TEST(HttpClient, circuit_breaker_opens_after_consecutive_failures_and_fails_fast)
+{
+    // Nobody is listening on this port, connection attempts fail right away.
+    auto url = "http://127.0.0.1:1/get";
+
+    std::vector<std::pair<http::Client::CircuitBreaker::State, http::Client::CircuitBreaker::State>> transitions;
+
+    http::Client::Configuration configuration;
+    configuration.circuit_breaker.enabled = true;
+    configuration.circuit_breaker.consecutive_failures = 2;
+    configuration.circuit_breaker.open_interval = std::chrono::minutes{1};
+    configuration.circuit_breaker.on_state_change = [&transitions](const std::string&,
+                                                                   http::Client::CircuitBreaker::State from,
+                                                                   http::Client::CircuitBreaker::State to)
+    {
+        transitions.push_back(std::make_pair(from, to));
+    };
+
+    auto client = http::make_client(configuration);
+
+    for (unsigned int i = 0; i < configuration.circuit_breaker.consecutive_failures; i++)
+    {
+        auto request = client->get(http::Request::Configuration::from_uri_as_string(url));
+        EXPECT_ANY_THROW(request->execute(default_progress_reporter));
+    }
+
+    // The circuit is open now and we fail without touching the network.
+    auto request = client->get(http::Request::Configuration::from_uri_as_string(url));
+    EXPECT_THROW(request->execute(default_progress_reporter), http::Client::Errors::CircuitOpen);
+    // A rejected request can be executed again later on.
+    EXPECT_EQ(http::Request::State::ready, request->state());
+
+    ASSERT_EQ(1u, transitions.size());
+    EXPECT_EQ(http::Client::CircuitBreaker::State::closed, transitions.front().first);
+    EXPECT_EQ(http::Client::CircuitBreaker::State::open, transitions.front().second);
+
+    auto metrics = client->metrics();
+    auto host = metrics.hosts.at("http://127.0.0.1:1");
+    EXPECT_EQ(http::Client::CircuitBreaker::State::open, host.circuit_breaker.state);
+    EXPECT_EQ(2u, host.circuit_breaker.failures);
+    EXPECT_EQ(1u, host.circuit_breaker.rejected);
+}
+
+TEST(HttpClient, hosts_are_only_tracked_with_per_host_policies_and_bounded)
+{
+    auto client = http::make_client();
+
+    auto url = std::string(httpbin::host) + httpbin::resources::get();
+    EXPECT_EQ(core::net::http::Status::ok,
+              client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter).status);
+
+    // Nothing to keep track of without a circuit breaker or a concurrency limit.
+    EXPECT_TRUE(client->metrics().hosts.empty());
+
+    http::Client::Configuration configuration;
+    configuration.circuit_breaker.enabled = true;
+    configuration.circuit_breaker.consecutive_failures = 1000;
+
+    client = http::make_client(configuration);
+
+    // Idle hosts with a closed circuit are dropped as others come in.
+    for (unsigned int i = 0; i < 300; i++)
+    {
+        auto uri = "http://127.0.0." + std::to_string(1 + i % 250) + ":" + std::to_string(1 + i / 250) + "/get";
+        EXPECT_ANY_THROW(client->get(http::Request::Configuration::from_uri_as_string(uri))->execute(default_progress_reporter));
+    }
+
+    EXPECT_GE(256u, client->metrics().hosts.size());
+}
+
+TEST(HttpClient, circuit_breaker_admits_probe_after_open_interval)
+{
+    auto url = "http://127.0.0.1:1/get";
+
+    http::Client::Configuration configuration;
+    configuration.circuit_breaker.enabled = true;
+    configuration.circuit_breaker.consecutive_failures = 1;
+    configuration.circuit_breaker.open_interval = std::chrono::milliseconds{50};
+
+    auto client = http::make_client(configuration);
+
+    EXPECT_ANY_THROW(client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter));
+    EXPECT_THROW(client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter),
+                 http::Client::Errors::CircuitOpen);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+
+    // The probe is admitted and hits the network, failing and opening the circuit again.
+    try
+    {
+        client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+        FAIL();
+    } catch(const http::Client::Errors::CircuitOpen&)
+    {
+        FAIL();
+    } catch(...)
+    {
+    }
+
+    EXPECT_EQ(http::Client::CircuitBreaker::State::open,
+              client->metrics().hosts.at("http://127.0.0.1:1").circuit_breaker.state);
+}
+
+TEST(HttpClient, async_request_against_open_circuit_reports_error)
+{
+    auto url = "http://127.0.0.1:1/get";
+
+    http::Client::Configuration configuration;
+    configuration.circuit_breaker.enabled = true;
+    configuration.circuit_breaker.consecutive_failures = 1;
+    configuration.circuit_breaker.open_interval = std::chrono::minutes{1};
+
+    auto client = http::make_client(configuration);
+    std::thread worker{[client]() { client->run(); }};
+
+    EXPECT_ANY_THROW(client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter));
+
+    std::promise<bool> promise;
+    auto future = promise.get_future();
+
+    client->get(http::Request::Configuration::from_uri_as_string(url))->async_execute(
+                http::Request::Handler()
+                    .on_response([&](const core::net::http::Response&)
+                    {
+                        promise.set_value(false);
+                    })
+                    .on_error([&](const core::net::Error& e)
+                    {
+                        promise.set_value(dynamic_cast<const http::Client::Errors::CircuitOpen*>(&e) != nullptr);
+                    }));
+
+    EXPECT_TRUE(future.get());
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(HttpClient, concurrency_limit_queues_async_requests_beyond_the_limit)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::delay();
+
+    http::Client::Configuration configuration;
+    configuration.concurrency_limit.enabled = true;
+    configuration.concurrency_limit.initial_limit = 2;
+    configuration.concurrency_limit.max_limit = 2;
+
+    auto client = http::make_client(configuration);
+    std::thread worker{[client]() { client->run(); }};
+
+    static constexpr const unsigned int request_count{4};
+
+    std::vector<std::promise<core::net::http::Status>> promises(request_count);
+    std::vector<std::shared_ptr<http::Request>> requests;
+
+    for (unsigned int i = 0; i < request_count; i++)
+    {
+        auto& promise = promises[i];
+        auto request = client->get(http::Request::Configuration::from_uri_as_string(url));
+        request->async_execute(
+                    http::Request::Handler()
+                        .on_response([&promise](const core::net::http::Response& response)
+                        {
+                            promise.set_value(response.status);
+                        })
+                        .on_error([&promise](const core::net::Error& e)
+                        {
+                            promise.set_exception(std::make_exception_ptr(e));
+                        }));
+        requests.push_back(request);
+    }
+
+    auto host = client->metrics().hosts.at(httpbin::host);
+    EXPECT_EQ(2u, host.concurrency.limit);
+    EXPECT_EQ(2u, host.concurrency.in_flight);
+    EXPECT_EQ(2u, host.concurrency.queued);
+
+    for (auto& promise : promises)
+        EXPECT_EQ(core::net::http::Status::ok, promise.get_future().get());
+
+    host = client->metrics().hosts.at(httpbin::host);
+    EXPECT_EQ(0u, host.concurrency.in_flight);
+    EXPECT_EQ(0u, host.concurrency.queued);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(HttpClient, concurrency_limit_backs_off_on_failures)
+{
+    auto url = "http://127.0.0.1:1/get";
+
+    http::Client::Configuration configuration;
+    configuration.concurrency_limit.enabled = true;
+    configuration.concurrency_limit.initial_limit = 8;
+    configuration.concurrency_limit.min_limit = 2;
+    configuration.concurrency_limit.backoff_ratio = 0.5;
+
+    auto client = http::make_client(configuration);
+
+    EXPECT_ANY_THROW(client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter));
+    EXPECT_EQ(4u, client->metrics().hosts.at("http://127.0.0.1:1").concurrency.limit);
+
+    for (unsigned int i = 0; i < 3; i++)
+        EXPECT_ANY_THROW(client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter));
+
+    // The limit never drops below the configured minimum.
+    auto host = client->metrics().hosts.at("http://127.0.0.1:1");
+    EXPECT_EQ(2u, host.concurrency.limit);
+    EXPECT_EQ(0u, host.concurrency.in_flight);
+}
+
+TEST(HttpClient, endpoint_group_distributes_requests_round_robin)
+{
+    http::Client::Configuration configuration;
+    configuration.endpoint_groups["http://service"].endpoints = {"http://127.0.0.1:5000", "http://localhost:5000/"};
+
+    auto client = http::make_client(configuration);
+
+    std::map<std::string, unsigned int> served_by;
+
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        auto request = client->get(http::Request::Configuration::from_uri_as_string(
+                                       std::string{"http://service"} + httpbin::resources::get()));
+        auto response = request->execute(default_progress_reporter);
+
+        json::Value root;
+        json::Reader reader;
+
+        EXPECT_EQ(core::net::http::Status::ok, response.status);
+        EXPECT_TRUE(reader.parse(response.body, root));
+        served_by[root["url"].asString()]++;
+    }
+
+    EXPECT_EQ(2u, served_by[std::string{"http://127.0.0.1:5000"} + httpbin::resources::get()]);
+    EXPECT_EQ(2u, served_by[std::string{"http://localhost:5000"} + httpbin::resources::get()]);
+
+    auto group = client->metrics().endpoint_groups.at("http://service");
+    ASSERT_EQ(2u, group.endpoints.size());
+    for (const auto& pair : group.endpoints)
+    {
+        EXPECT_EQ(2u, pair.second.requests);
+        EXPECT_EQ(0u, pair.second.outstanding);
+        EXPECT_LT(0., pair.second.ewma_latency.count());
+    }
+}
+
+TEST(HttpClient, endpoint_group_ejects_failing_endpoint)
+{
+    http::Client::Configuration configuration;
+    auto& group = configuration.endpoint_groups["http://service"];
+    group.endpoints = {"http://127.0.0.1:1", "http://127.0.0.1:5000"};
+    group.policy = http::Client::LoadBalancing::Policy::least_outstanding;
+    group.outlier_ejection.enabled = true;
+    group.outlier_ejection.consecutive_failures = 1;
+
+    auto client = http::make_client(configuration);
+    auto url = std::string{"http://service"} + httpbin::resources::get();
+
+    // Requests keep on failing until the unreachable endpoint is ejected.
+    unsigned int failures{0};
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        try
+        {
+            auto response = client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+            EXPECT_EQ(core::net::http::Status::ok, response.status);
+        } catch(...)
+        {
+            ++failures;
+        }
+    }
+
+    EXPECT_GE(1u, failures);
+
+    auto metrics = client->metrics().endpoint_groups.at("http://service");
+    EXPECT_TRUE(metrics.endpoints.at("http://127.0.0.1:1").ejected);
+    EXPECT_FALSE(metrics.endpoints.at("http://127.0.0.1:5000").ejected);
+    EXPECT_EQ(4u - failures, metrics.endpoints.at("http://127.0.0.1:5000").requests);
+}
+
+TEST(HttpClient, endpoint_group_does_not_prefer_endpoint_that_fails_fast)
+{
+    http::Client::Configuration configuration;
+    auto& group = configuration.endpoint_groups["http://service"];
+    group.endpoints = {"http://127.0.0.1:1", "http://127.0.0.1:5000"};
+    group.policy = http::Client::LoadBalancing::Policy::ewma_latency;
+
+    auto client = http::make_client(configuration);
+    auto url = std::string{"http://service"} + httpbin::resources::get();
+
+    // Refused connections fail faster than any request succeeds, yet count as slow.
+    unsigned int failures{0};
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        try
+        {
+            auto response = client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+            EXPECT_EQ(core::net::http::Status::ok, response.status);
+        } catch(...)
+        {
+            ++failures;
+        }
+    }
+
+    // The unreachable endpoint is probed, but does not keep on winning.
+    EXPECT_LE(1u, failures);
+    EXPECT_GE(2u, failures);
+
+    auto metrics = client->metrics().endpoint_groups.at("http://service");
+    EXPECT_EQ(failures, metrics.endpoints.at("http://127.0.0.1:1").failures);
+    EXPECT_EQ(8u - failures, metrics.endpoints.at("http://127.0.0.1:5000").requests);
+    EXPECT_LT(metrics.endpoints.at("http://127.0.0.1:5000").ewma_latency,
+              metrics.endpoints.at("http://127.0.0.1:1").ewma_latency);
+}
+
+TEST(HttpClient, consistent_hash_routes_requests_with_same_affinity_key_to_same_endpoint)
+{
+    http::Client::Configuration configuration;
+    auto& group = configuration.endpoint_groups["http://service"];
+    group.endpoints = {"http://127.0.0.1:5000", "http://localhost:5000"};
+    group.policy = http::Client::LoadBalancing::Policy::consistent_hash;
+
+    auto client = http::make_client(configuration);
+
+    auto served_by = [client](const std::string& key)
+    {
+        auto request_configuration = http::Request::Configuration::from_uri_as_string(
+                    std::string{"http://service"} + httpbin::resources::get());
+        request_configuration.affinity_key = key;
+
+        auto response = client->get(request_configuration)->execute(default_progress_reporter);
+
+        json::Value root;
+        json::Reader reader;
+
+        EXPECT_EQ(core::net::http::Status::ok, response.status);
+        EXPECT_TRUE(reader.parse(response.body, root));
+
+        return root["url"].asString();
+    };
+
+    std::set<std::string> endpoints;
+
+    for (unsigned int i = 0; i < 16; i++)
+    {
+        auto key = "key-" + std::to_string(i);
+        auto endpoint = served_by(key);
+
+        EXPECT_EQ(endpoint, served_by(key));
+        EXPECT_EQ(endpoint, served_by(key));
+
+        endpoints.insert(endpoint);
+    }
+
+    // Different keys spread across the group.
+    EXPECT_EQ(2u, endpoints.size());
+}
+
+TEST(HttpClient, consistent_hash_falls_back_to_next_endpoint_if_preferred_one_is_ejected)
+{
+    http::Client::Configuration configuration;
+    auto& group = configuration.endpoint_groups["http://service"];
+    group.endpoints = {"http://127.0.0.1:1", "http://127.0.0.1:5000"};
+    group.policy = http::Client::LoadBalancing::Policy::consistent_hash;
+    group.outlier_ejection.enabled = true;
+    group.outlier_ejection.consecutive_failures = 1;
+
+    auto client = http::make_client(configuration);
+
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        auto request_configuration = http::Request::Configuration::from_uri_as_string(
+                    std::string{"http://service"} + httpbin::resources::get());
+        request_configuration.affinity_key = "key-" + std::to_string(i);
+
+        // At most the first request hitting the unreachable endpoint fails.
+        try
+        {
+            client->get(request_configuration)->execute(default_progress_reporter);
+        } catch(...)
+        {
+        }
+    }
+
+    auto metrics = client->metrics().endpoint_groups.at("http://service");
+    EXPECT_GE(1u, metrics.endpoints.at("http://127.0.0.1:1").requests);
+    EXPECT_LE(7u, metrics.endpoints.at("http://127.0.0.1:5000").requests);
+}
+
+TEST(HttpClient, concurrent_identical_get_requests_share_a_single_transfer)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::delay();
+
+    http::Client::Configuration configuration;
+    configuration.coalescing.enabled = true;
+
+    auto client = http::make_client(configuration);
+
+    static constexpr const unsigned int request_count{4};
+
+    auto execute = [client, url]()
+    {
+        return client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+    };
+
+    auto leader = std::async(std::launch::async, execute);
+    // Give the leading request a head start, making sure that it is in flight.
+    std::this_thread::sleep_for(std::chrono::milliseconds{200});
+
+    std::vector<std::future<core::net::http::Response>> followers;
+    for (unsigned int i = 1; i < request_count; i++)
+        followers.push_back(std::async(std::launch::async, execute));
+
+    auto expected = leader.get();
+    EXPECT_EQ(core::net::http::Status::ok, expected.status);
+
+    for (auto& follower : followers)
+    {
+        auto response = follower.get();
+        EXPECT_EQ(expected.status, response.status);
+        EXPECT_EQ(expected.body, response.body);
+    }
+
+    EXPECT_EQ(request_count - 1, client->metrics().coalescing.deduplicated);
+
+    // Requests differing in relevant header fields do not share a transfer.
+    // Neither do requests decoding differently or asking for a range.
+    auto leading_configuration = http::Request::Configuration::from_uri_as_string(url);
+    std::vector<http::Request::Configuration> other_configurations(3, leading_configuration);
+    other_configurations[0].header.add("Accept", "text/plain");
+    other_configurations[1].decoding = http::Request::Decoding::enabled;
+    other_configurations[2].header.add("Range", "bytes=0-9");
+
+    for (const auto& other_configuration : other_configurations)
+    {
+        auto first = std::async(std::launch::async, [client, leading_configuration]()
+        {
+            return client->get(leading_configuration)->execute(default_progress_reporter);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds{200});
+        client->get(other_configuration)->execute(default_progress_reporter);
+        first.get();
+    }
+
+    EXPECT_EQ(request_count - 1, client->metrics().coalescing.deduplicated);
+}
+
+TEST(HttpClient, async_get_request_joining_identical_request_in_flight_reports_response)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::delay();
+
+    http::Client::Configuration configuration;
+    configuration.coalescing.enabled = true;
+
+    auto client = http::make_client(configuration);
+    std::thread worker{[client]() { client->run(); }};
+
+    std::promise<core::net::http::Response> leader, follower;
+
+    auto leading_request = client->get(http::Request::Configuration::from_uri_as_string(url));
+    leading_request->async_execute(
+                http::Request::Handler()
+                    .on_response([&leader](const core::net::http::Response& response)
+                    {
+                        leader.set_value(response);
+                    })
+                    .on_error([&leader](const core::net::Error& e)
+                    {
+                        leader.set_exception(std::make_exception_ptr(e));
+                    }));
+
+    auto following_request = client->get(http::Request::Configuration::from_uri_as_string(url));
+    following_request->async_execute(
+                http::Request::Handler()
+                    .on_response([&follower](const core::net::http::Response& response)
+                    {
+                        follower.set_value(response);
+                    })
+                    .on_error([&follower](const core::net::Error& e)
+                    {
+                        follower.set_exception(std::make_exception_ptr(e));
+                    }));
+
+    auto expected = leader.get_future().get();
+    auto response = follower.get_future().get();
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_EQ(expected.body, response.body);
+    EXPECT_EQ(1u, client->metrics().coalescing.deduplicated);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(HttpClient, fresh_cached_response_is_served_without_contacting_the_server)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::cache();
+
+    http::Client::Configuration configuration;
+    configuration.cache.enabled = true;
+
+    auto client = http::make_client(configuration);
+
+    auto first = client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, first.status);
+
+    auto second = client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+
+    EXPECT_EQ(core::net::http::Status::ok, second.status);
+    EXPECT_EQ(first.body, second.body);
+    EXPECT_TRUE(second.header.has("Age"));
+
+    auto metrics = client->metrics();
+    EXPECT_EQ(1u, metrics.cache.hits);
+    EXPECT_EQ(1u, metrics.cache.misses);
+    EXPECT_EQ(1u, metrics.cache.entries);
+    EXPECT_LE(first.body.size(), metrics.cache.size);
+
+    // Decoded responses are cached apart from the ones left as is.
+    auto decoded = http::Request::Configuration::from_uri_as_string(url);
+    decoded.decoding = http::Request::Decoding::enabled;
+
+    auto third = client->get(decoded)->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, third.status);
+
+    metrics = client->metrics();
+    EXPECT_EQ(1u, metrics.cache.hits);
+    EXPECT_EQ(2u, metrics.cache.misses);
+    EXPECT_EQ(2u, metrics.cache.entries);
+
+    // Requests insisting on a cached response fail with 504 if there is none.
+    auto only_if_cached = http::Request::Configuration::from_uri_as_string(std::string(httpbin::host) + httpbin::resources::get());
+    only_if_cached.header.add("Cache-Control", "only-if-cached");
+
+    auto response = client->get(only_if_cached)->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::gateway_timeout, response.status);
+}
+
+TEST(HttpClient, stale_cached_response_is_revalidated_and_served_on_not_modified)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::etag();
+
+    http::Client::Configuration configuration;
+    configuration.cache.enabled = true;
+
+    auto client = http::make_client(configuration);
+    std::thread worker{[client]() { client->run(); }};
+
+    auto execute = [client, url]()
+    {
+        std::promise<core::net::http::Response> promise;
+
+        client->get(http::Request::Configuration::from_uri_as_string(url))->async_execute(
+                    http::Request::Handler()
+                        .on_response([&promise](const core::net::http::Response& response)
+                        {
+                            promise.set_value(response);
+                        })
+                        .on_error([&promise](const core::net::Error& e)
+                        {
+                            promise.set_exception(std::make_exception_ptr(e));
+                        }));
+
+        return promise.get_future().get();
+    };
+
+    auto first = execute();
+    EXPECT_EQ(core::net::http::Status::ok, first.status);
+
+    // Without any freshness information, the response is stale right away
+    // and the server is asked whether it changed.
+    auto second = execute();
+    EXPECT_EQ(core::net::http::Status::ok, second.status);
+    EXPECT_EQ(first.body, second.body);
+
+    auto metrics = client->metrics();
+    EXPECT_EQ(0u, metrics.cache.hits);
+    EXPECT_EQ(1u, metrics.cache.revalidations);
+    EXPECT_EQ(1u, metrics.cache.not_modified);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(HttpClient, disk_cached_response_is_shared_by_clients_using_the_same_directory)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::cache();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-cache-"};
+
+    http::Client::Configuration configuration;
+    configuration.cache.enabled = true;
+    configuration.cache.directory = directory.path;
+
+    core::net::http::Response first;
+
+    {
+        auto client = http::make_client(configuration);
+        first = client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+        EXPECT_EQ(core::net::http::Status::ok, first.status);
+        EXPECT_EQ(1u, client->metrics().cache.entries);
+    }
+
+    // An entry file without a slot in the index, as left behind by a crash.
+    auto orphan = directory.path + "/0123456789abcdef.entry";
+    std::ofstream{orphan} << "orphan";
+
+    // A temporary file of a writer that crashed a while ago.
+    auto stale = directory.path + "/.tmp-stale";
+    std::ofstream{stale} << "stale";
+    struct utimbuf times{::time(nullptr) - 2 * 60 * 60, ::time(nullptr) - 2 * 60 * 60};
+    ASSERT_EQ(0, ::utime(stale.c_str(), &times));
+
+    // A client created later, possibly in another process, is served from the files left behind.
+    auto client = http::make_client(configuration);
+    EXPECT_FALSE(std::ifstream{orphan}.good());
+    EXPECT_FALSE(std::ifstream{stale}.good());
+
+    auto second = client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+
+    EXPECT_EQ(core::net::http::Status::ok, second.status);
+    EXPECT_EQ(first.body, second.body);
+
+    auto metrics = client->metrics();
+    EXPECT_EQ(1u, metrics.cache.hits);
+    EXPECT_EQ(0u, metrics.cache.misses);
+    EXPECT_EQ(1u, metrics.cache.entries);
+    EXPECT_LE(first.body.size(), metrics.cache.size);
+}
+
+TEST(HttpClient, failing_disk_cache_does_not_fail_requests)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::cache();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-cache-"};
+
+    http::Client::Configuration configuration;
+    configuration.cache.enabled = true;
+    configuration.cache.directory = directory.path + "/cache";
+
+    auto client = http::make_client(configuration);
+
+    // Entries cannot be written anymore.
+    ASSERT_EQ(0, ::system(("rm -rf " + configuration.cache.directory).c_str()));
+
+    auto response = client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+
+    std::promise<core::net::http::Response> promise;
+    std::thread worker{[client]() { client->run(); }};
+
+    client->get(http::Request::Configuration::from_uri_as_string(url))->async_execute(
+                http::Request::Handler()
+                    .on_response([&promise](const core::net::http::Response& response)
+                    {
+                        promise.set_value(response);
+                    })
+                    .on_error([&promise](const core::net::Error& e)
+                    {
+                        promise.set_exception(std::make_exception_ptr(e));
+                    }));
+
+    auto future = promise.get_future();
+    ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds{10}));
+    EXPECT_EQ(core::net::http::Status::ok, future.get().status);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+
+    EXPECT_LE(2u, client->metrics().cache.failures);
+}
+
+TEST(HttpClient, hot_cached_response_is_refreshed_in_the_background_once)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::cache();
+
+    http::Client::Configuration configuration;
+    configuration.cache.enabled = true;
+    // Refresh right away, for the sake of testing.
+    configuration.cache.refresh_ahead = 1.;
+    configuration.cache.refresh_ahead_min_hits = 1;
+
+    auto client = http::make_client(configuration);
+
+    auto get = [client, url]()
+    {
+        return client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+    };
+
+    auto first = get();
+    EXPECT_EQ(core::net::http::Status::ok, first.status);
+
+    // The reactor is not running yet, all hits find the refresh in progress.
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        auto response = get();
+        EXPECT_EQ(core::net::http::Status::ok, response.status);
+        EXPECT_EQ(first.body, response.body);
+    }
+
+    auto metrics = client->metrics();
+    EXPECT_EQ(3u, metrics.cache.hits);
+    EXPECT_EQ(1u, metrics.cache.refreshes);
+
+    std::thread worker{[client]() { client->run(); }};
+
+    // Once the refresh finished, the next hit triggers another one.
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (client->metrics().cache.refreshes < 2 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        get();
+    }
+
+    EXPECT_EQ(2u, client->metrics().cache.refreshes);
+    EXPECT_EQ(1u, client->metrics().cache.misses);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(HttpClient, compressed_response_is_decoded_transparently)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::gzip();
+
+    http::Client::Configuration configuration;
+    configuration.decoding.enabled = true;
+
+    auto client = http::make_client(configuration);
+
+    auto response = client->get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(response.header.has("Content-Encoding", "gzip"));
+
+    json::Value root;
+    json::Reader reader;
+
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_NE(std::string::npos, root["headers"]["Accept-Encoding"].asString().find("gzip"));
+
+    auto metrics = client->metrics();
+    EXPECT_EQ(response.body.size(), metrics.received.decoded_bytes);
+    EXPECT_LT(metrics.received.wire_bytes, metrics.received.decoded_bytes);
+
+    // Requests can opt out individually.
+    auto opted_out = http::Request::Configuration::from_uri_as_string(std::string(httpbin::host) + httpbin::resources::headers());
+    opted_out.decoding = http::Request::Decoding::disabled;
+
+    response = client->get(opted_out)->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_FALSE(root["headers"].isMember("Accept-Encoding"));
+}
+
+TEST(HttpClient, post_request_body_is_compressed_above_minimum_size)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::post();
+
+    auto client = http::make_client();
+
+    auto configuration = http::Request::Configuration::from_uri_as_string(url);
+    configuration.compression.algorithm = http::Request::Compression::gzip;
+    configuration.compression.min_size = 1024;
+
+    json::Value root;
+    json::Reader reader;
+
+    // Small bodies are sent as is.
+    auto response = client->post(configuration, "{ 'test': 'test' }", http::ContentType::json)->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_FALSE(root["headers"].isMember("Content-Encoding"));
+
+    std::string payload;
+    for (unsigned int i = 0; i < 1000; i++)
+        payload += "{ 'test': 'test' }";
+
+    response = client->post(configuration, payload, http::ContentType::json)->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ("gzip", root["headers"]["Content-Encoding"].asString());
+
+    // Streamed bodies are compressed as they are read, and sent chunked.
+    configuration.uri = std::string(httpbin::host) + httpbin::resources::put();
+    std::stringstream ss{payload};
+    response = client->put(configuration, ss, payload.size())->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ("gzip", root["headers"]["Content-Encoding"].asString());
+    EXPECT_EQ("chunked", root["headers"]["Transfer-Encoding"].asString());
+}
+
+TEST(HttpClient, post_request_body_is_announced_following_expect_continue_policy)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::post();
+
+    auto client = http::make_client();
+
+    auto configuration = http::Request::Configuration::from_uri_as_string(url);
+    configuration.expect_continue.threshold = 64 * 1024;
+
+    std::string small{"{ 'test': 'test' }"};
+    std::string large(128 * 1024, 'x');
+
+    json::Value root;
+    json::Reader reader;
+
+    // Small bodies are sent right away, large ones wait for the server to accept them.
+    auto response = client->post(configuration, small, http::ContentType::json)->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_FALSE(root["headers"].isMember("Expect"));
+
+    std::stringstream ss{large};
+    configuration.uri = std::string(httpbin::host) + httpbin::resources::put();
+    response = client->put(configuration, ss, large.size())->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ("100-continue", root["headers"]["Expect"].asString());
+    EXPECT_EQ(large.size(), root["data"].asString().size());
+
+    configuration.uri = url;
+    configuration.expect_continue.policy = http::Request::ExpectContinue::always;
+    response = client->post(configuration, small, http::ContentType::json)->execute(default_progress_reporter);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ("100-continue", root["headers"]["Expect"].asString());
+
+    configuration.expect_continue.policy = http::Request::ExpectContinue::never;
+    response = client->post(configuration, large, http::ContentType::json)->execute(default_progress_reporter);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_FALSE(root["headers"].isMember("Expect"));
+
+    auto metrics = client->metrics();
+    EXPECT_EQ(2u, metrics.expect_continue.announced);
+    EXPECT_EQ(0u, metrics.expect_continue.rejected);
+}
+
+TEST(HttpClient, compressed_request_body_is_announced_by_its_uncompressed_size)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::put();
+
+    auto client = http::make_client();
+
+    auto configuration = http::Request::Configuration::from_uri_as_string(url);
+    configuration.compression.algorithm = http::Request::Compression::gzip;
+    configuration.expect_continue.threshold = 64 * 1024;
+
+    std::string small(2 * 1024, 'x');
+    std::string large(128 * 1024, 'x');
+
+    json::Value root;
+    json::Reader reader;
+
+    // Compressed bodies are sent chunked, yet small ones are not held back.
+    std::stringstream small_stream{small};
+    auto response = client->put(configuration, small_stream, small.size())->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ("gzip", root["headers"]["Content-Encoding"].asString());
+    EXPECT_FALSE(root["headers"].isMember("Expect"));
+
+    std::stringstream large_stream{large};
+    response = client->put(configuration, large_stream, large.size())->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ("gzip", root["headers"]["Content-Encoding"].asString());
+    EXPECT_EQ("100-continue", root["headers"]["Expect"].asString());
+
+    auto metrics = client->metrics();
+    EXPECT_EQ(1u, metrics.expect_continue.announced);
+    EXPECT_EQ(0u, metrics.expect_continue.rejected);
+}
+
+TEST(HttpClient, put_request_body_rejected_before_being_sent_is_reported)
+{
+    auto url = std::string(httpbin::host) + httpbin::resources::payload_too_large();
+
+    auto client = http::make_client();
+
+    auto configuration = http::Request::Configuration::from_uri_as_string(url);
+    configuration.expect_continue.policy = http::Request::ExpectContinue::always;
+    // Long enough for the server to answer before the body is sent anyway.
+    configuration.expect_continue.timeout = std::chrono::seconds{10};
+
+    std::string payload(4 * 1024 * 1024, 'x');
+    std::stringstream ss{payload};
+
+    auto response = client->put(configuration, ss, payload.size())->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::request_entity_too_large, response.status);
+
+    auto metrics = client->metrics();
+    EXPECT_EQ(1u, metrics.expect_continue.announced);
+    EXPECT_EQ(1u, metrics.expect_continue.rejected);
+    EXPECT_EQ(payload.size(), metrics.expect_continue.saved_bytes);
+}
+
 namespace com
 {
 namespace mozilla
@@ -613,6 +1583,44 @@ const char* submit() { return "/v1/submit?key=net-cpp-testing"; }
 
 // See https://mozilla-ichnaea.readthedocs.org/en/latest/api/search.html
 // for API and endpoint documentation.
+TEST(HttpClient, put_and_post_requests_for_file_send_its_contents)
+{
+    auto client = http::make_client();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-upload-"};
+
+    std::string payload;
+    for (int i = 0; i < 20000; i++)
+        payload += std::to_string(i) + ",";
+
+    http::Client::FileSource::Configuration source;
+    source.path = directory.path + "/upload";
+    std::ofstream{source.path} << payload;
+
+    json::Value root;
+    json::Reader reader;
+
+    auto response = client->put(http::Request::Configuration::from_uri_as_string(
+                                    std::string(httpbin::host) + httpbin::resources::put()), source)
+            ->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ(payload, root["data"].asString());
+
+    std::string type{http::ContentType::json};
+    response = client->post(http::Request::Configuration::from_uri_as_string(
+                                std::string(httpbin::host) + httpbin::resources::post()), source, type)
+            ->execute(default_progress_reporter);
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ(payload, root["data"].asString());
+    EXPECT_EQ(type, root["headers"]["Content-Type"].asString());
+
+    source.path = directory.path + "/missing";
+    EXPECT_THROW(client->put(http::Request::Configuration::from_uri_as_string(
+                                 std::string(httpbin::host) + httpbin::resources::put()), source), std::system_error);
+}
+
 TEST(HttpClient, DISABLED_search_for_location_on_mozillas_location_service_succeeds)
 {
     json::FastWriter writer;
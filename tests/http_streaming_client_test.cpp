@@ -21,18 +21,26 @@
 #include <core/net/uri.h>
 #include <core/net/http/streaming_client.h>
 #include <core/net/http/content_type.h>
+#include <core/net/http/error.h>
 #include <core/net/http/request.h>
 #include <core/net/http/response.h>
 
 #include "httpbin.h"
+#include "temporary_directory.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <json/json.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
 #include <future>
 #include <memory>
+#include <sstream>
+#include <system_error>
 
 #include <fstream>
 #include <iomanip>
@@ -667,26 +675,1273 @@ TEST(StreamingHttpClient, put_request_for_file_with_large_chunk_with_read_callba
     EXPECT_EQ(url, root["url"].asString());
 }
 
+TEST(StreamingHttpClient, put_request_of_unknown_size_is_sent_chunked)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::put();
+
+    // A body generated on the fly, its length is not known upfront.
+    std::string expected;
+    int line{0};
+
+    auto request = client->streaming_put(http::Request::Configuration::from_uri_as_string(url),
+                                [&expected, &line](void *dest, size_t buf_size) -> size_t {
+                                    if (line == 1000)
+                                        return 0;
+
+                                    auto chunk = "line " + std::to_string(line++) + "\n";
+                                    if (chunk.size() > buf_size)
+                                        return 0;
+
+                                    expected += chunk;
+                                    std::copy(chunk.begin(), chunk.end(), static_cast<char*>(dest));
+                                    return chunk.size();
+                                },
+                                http::StreamingClient::Upload::unknown_size);
+
+    auto response = request->execute(default_progress_reporter, [](const std::string&) {});
+
+    json::Value root;
+    json::Reader reader;
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ(expected, root["data"].asString());
+    EXPECT_EQ("chunked", root["headers"]["Transfer-Encoding"].asString());
+}
+
+TEST(StreamingHttpClient, async_post_request_of_unknown_size_can_pause_for_data)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    std::thread worker{[client]() { client->run(); }};
+
+    auto url = std::string(httpbin::host) + httpbin::resources::post();
+
+    std::promise<void> paused;
+    std::string payload{"produced later"};
+    bool available{false};
+
+    auto request = client->streaming_post(http::Request::Configuration::from_uri_as_string(url),
+                                [&](void *dest, size_t buf_size) -> size_t {
+                                    // Nothing there yet, the producer resumes the request once there is.
+                                    if (not available)
+                                    {
+                                        paused.set_value();
+                                        return http::StreamingClient::Upload::pause;
+                                    }
+
+                                    auto size = std::min(buf_size, payload.size());
+                                    std::copy(payload.begin(), payload.begin() + size, static_cast<char*>(dest));
+                                    payload.erase(0, size);
+                                    return size;
+                                },
+                                http::StreamingClient::Upload::unknown_size);
+
+    std::promise<core::net::http::Response> promise;
+    auto future = promise.get_future();
+
+    request->async_execute(
+                http::Request::Handler()
+                    .on_progress(default_progress_reporter)
+                    .on_response([&](const core::net::http::Response& response)
+                    {
+                        promise.set_value(response);
+                    })
+                    .on_error([&](const core::net::Error& e)
+                    {
+                        promise.set_exception(std::make_exception_ptr(e));
+                    }),
+                [](const std::string&) {});
+
+    paused.get_future().wait();
+    // The callback is not invoked again before the request is resumed.
+    available = true;
+    request->resume();
+
+    auto response = future.get();
+
+    json::Value root;
+    json::Reader reader;
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ("produced later", root["data"].asString());
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(StreamingHttpClient, async_put_request_with_writer_sends_data_pushed_by_producer)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    std::thread worker{[client]() { client->run(); }};
+
+    auto url = std::string(httpbin::host) + httpbin::resources::put();
+
+    // A queue much smaller than the body, the producer has to wait for the transfer.
+    http::UploadWriter::Configuration configuration;
+    configuration.capacity = 16 * 1024;
+
+    auto upload = client->streaming_put_writer(http::Request::Configuration::from_uri_as_string(url), configuration);
+
+    std::promise<core::net::http::Response> promise;
+    auto future = promise.get_future();
+
+    upload.request->async_execute(
+                http::Request::Handler()
+                    .on_progress(default_progress_reporter)
+                    .on_response([&](const core::net::http::Response& response)
+                    {
+                        promise.set_value(response);
+                    })
+                    .on_error([&](const core::net::Error& e)
+                    {
+                        promise.set_exception(std::make_exception_ptr(e));
+                    }),
+                [](const std::string&) {});
+
+    std::string expected;
+    std::thread producer{[&upload, &expected]()
+    {
+        for (int i = 0; i < 64; i++)
+        {
+            std::string chunk(4096, static_cast<char>('a' + i % 26));
+            expected += chunk;
+            upload.writer->write(chunk.data(), chunk.size());
+        }
+
+        upload.writer->close();
+    }};
+
+    auto response = future.get();
+    producer.join();
+
+    json::Value root;
+    json::Reader reader;
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ(expected, root["data"].asString());
+
+    // The request is done, nothing reaches the server anymore.
+    EXPECT_THROW(upload.writer->write("late", 4), http::UploadWriter::Errors::Closed);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(StreamingHttpClient, post_request_with_writer_waits_for_data_on_calling_thread)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::post();
+
+    http::UploadWriter::Configuration configuration;
+    configuration.capacity = 8;
+    configuration.blocking = false;
+
+    auto upload = client->streaming_post_writer(http::Request::Configuration::from_uri_as_string(url), configuration, "text/plain");
+
+    upload.writer->write("queued", 6);
+    EXPECT_THROW(upload.writer->write("overflow", 8), http::UploadWriter::Errors::Full);
+
+    std::thread producer{[&upload]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        upload.writer->write(" later", 6);
+        upload.writer->close();
+    }};
+
+    auto response = upload.request->execute(default_progress_reporter, [](const std::string&) {});
+    producer.join();
+
+    json::Value root;
+    json::Reader reader;
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ("queued later", root["data"].asString());
+    EXPECT_EQ("text/plain", root["headers"]["Content-Type"].asString());
+}
+
+TEST(StreamingHttpClient, post_request_gathers_body_from_buffers)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::post();
+
+    // A header block kept alive by the caller, followed by records shared with the request.
+    std::string header{"{ 'records': ["};
+    http::StreamingClient::Upload::Buffers buffers{http::StreamingClient::Upload::Buffer{header.data(), header.size()}};
+
+    std::string expected{header};
+    for (int i = 0; i < 16; i++)
+    {
+        auto record = std::make_shared<const std::string>("{ 'id': " + std::to_string(i) + " },");
+        buffers.emplace_back(record);
+        expected += *record;
+    }
+
+    // Empty buffers contribute nothing.
+    buffers.emplace_back(nullptr, 0);
+    buffers.emplace_back(std::make_shared<const std::string>("] }"));
+    expected += "] }";
+
+    auto request = client->streaming_post_buffers(http::Request::Configuration::from_uri_as_string(url), buffers, "text/plain");
+    buffers.clear();
+
+    auto response = request->execute(default_progress_reporter, [](const std::string&) {});
+
+    json::Value root;
+    json::Reader reader;
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ(expected, root["data"].asString());
+    EXPECT_EQ(std::to_string(expected.size()), root["headers"]["Content-Length"].asString());
+    EXPECT_EQ("text/plain", root["headers"]["Content-Type"].asString());
+}
+
+TEST(StreamingHttpClient, async_put_request_gathers_body_from_buffers)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    std::thread worker{[client]() { client->run(); }};
+
+    auto url = std::string(httpbin::host) + httpbin::resources::put();
+
+    // Larger than the chunks curl asks for, buffers are split across reads.
+    auto first = std::make_shared<const std::string>(100 * 1024, 'a');
+    auto second = std::make_shared<const std::string>(30 * 1024, 'b');
+
+    auto request = client->streaming_put_buffers(http::Request::Configuration::from_uri_as_string(url), {first, second});
+
+    std::promise<core::net::http::Response> promise;
+    auto future = promise.get_future();
+
+    request->async_execute(
+                http::Request::Handler()
+                    .on_response([&](const core::net::http::Response& response)
+                    {
+                        promise.set_value(response);
+                    })
+                    .on_error([&](const core::net::Error& e)
+                    {
+                        promise.set_exception(std::make_exception_ptr(e));
+                    }),
+                [](const std::string&) {});
+
+    auto response = future.get();
+
+    json::Value root;
+    json::Reader reader;
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ(*first + *second, root["data"].asString());
+    EXPECT_EQ(std::to_string(first->size() + second->size()), root["headers"]["Content-Length"].asString());
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(StreamingHttpClient, async_get_request_with_buffer_pauses_for_slow_consumer)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    std::thread worker{[client]() { client->run(); }};
+
+    auto url = std::string(httpbin::host) + httpbin::resources::range();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    // A buffer much smaller than the body, the transfer has to wait for the consumer.
+    http::StreamingClient::Buffering::Configuration buffering;
+    buffering.capacity = 16 * 1024;
+    buffering.chunk_size = 4 * 1024;
+
+    auto request = client->streaming_get_buffered(http::Request::Configuration::from_uri_as_string(url), buffering);
+
+    std::atomic<double> downloaded{0};
+    std::promise<void> unblocked;
+    auto other_done = unblocked.get_future();
+
+    std::promise<core::net::http::Response> promise;
+    auto future = promise.get_future();
+
+    std::string body;
+    std::size_t largest_chunk{0};
+    double downloaded_while_blocked{0};
+    auto consumer = std::this_thread::get_id();
+
+    request->async_execute(
+                http::Request::Handler()
+                    .on_progress([&](const http::Request::Progress& progress)
+                    {
+                        downloaded = std::max(downloaded.load(), progress.download.current);
+                        return http::Request::Progress::Next::continue_operation;
+                    })
+                    .on_response([&](const core::net::http::Response& response)
+                    {
+                        promise.set_value(response);
+                    })
+                    .on_error([&](const core::net::Error& e)
+                    {
+                        promise.set_exception(std::make_exception_ptr(e));
+                    }),
+                [&](const std::string& chunk)
+                {
+                    // The consumer stalls on the first chunk, the reactor serves other requests meanwhile.
+                    if (body.empty())
+                    {
+                        consumer = std::this_thread::get_id();
+                        other_done.wait();
+                        std::this_thread::sleep_for(std::chrono::milliseconds{200});
+                        downloaded_while_blocked = downloaded.load();
+                    }
+
+                    largest_chunk = std::max(largest_chunk, chunk.size());
+                    body += chunk;
+                });
+
+    auto other = client->streaming_get(http::Request::Configuration::from_uri_as_string(std::string(httpbin::host) + httpbin::resources::get()));
+    other->async_execute(
+                http::Request::Handler()
+                    .on_response([&](const core::net::http::Response&) { unblocked.set_value(); })
+                    .on_error([&](const core::net::Error&) { unblocked.set_value(); }),
+                [](const std::string&) {});
+
+    auto response = future.get();
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(response.body.empty());
+    EXPECT_EQ(expected.body, body);
+    EXPECT_GE(buffering.chunk_size, largest_chunk);
+    EXPECT_NE(worker.get_id(), consumer);
+    // The transfer paused instead of reading the complete body off the network.
+    EXPECT_GT(static_cast<double>(expected.body.size()), downloaded_while_blocked);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(StreamingHttpClient, async_get_request_with_buffer_reports_failing_consumer)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    std::thread worker{[client]() { client->run(); }};
+
+    auto url = std::string(httpbin::host) + httpbin::resources::range();
+
+    http::StreamingClient::Buffering::Configuration buffering;
+    buffering.capacity = 8 * 1024;
+
+    auto request = client->streaming_get_buffered(http::Request::Configuration::from_uri_as_string(url), buffering);
+
+    std::promise<core::net::http::Response> promise;
+    auto future = promise.get_future();
+
+    request->async_execute(
+                http::Request::Handler()
+                    .on_response([&](const core::net::http::Response& response)
+                    {
+                        promise.set_value(response);
+                    })
+                    .on_error([&](const core::net::Error& e)
+                    {
+                        promise.set_exception(std::make_exception_ptr(e));
+                    }),
+                [](const std::string&)
+                {
+                    throw std::runtime_error{"consumer failed"};
+                });
+
+    EXPECT_THROW(future.get(), core::net::Error);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(StreamingHttpClient, opened_request_hands_out_body_to_reader_and_stream)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    std::thread worker{[client]() { client->run(); }};
+
+    auto url = std::string(httpbin::host) + httpbin::resources::range();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    // A buffer much smaller than the body, the transfer has to wait for the reader.
+    http::BodyReader::Configuration configuration;
+    configuration.capacity = 8 * 1024;
+
+    auto request = client->streaming_get(http::Request::Configuration::from_uri_as_string(url));
+    auto reader = request->open(configuration);
+
+    EXPECT_THROW(request->open(configuration), http::Request::Errors::AlreadyActive);
+
+    std::string head(1000, '\0');
+    std::size_t n{0};
+    while (n < head.size())
+        n += reader->read(&head[n], head.size() - n);
+
+    std::stringstream rest; rest << reader->stream().rdbuf();
+
+    EXPECT_EQ(expected.body, head + rest.str());
+    EXPECT_EQ(0u, reader->read(&head[0], head.size()));
+
+    auto response = reader->response();
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(response.body.empty());
+
+    reader->close();
+    EXPECT_THROW(reader->read(&head[0], head.size()), http::BodyReader::Errors::Closed);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(StreamingHttpClient, non_blocking_reader_returns_would_block_until_data_arrives)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    std::thread worker{[client]() { client->run(); }};
+
+    auto url = std::string(httpbin::host) + httpbin::resources::delay();
+
+    http::BodyReader::Configuration configuration;
+    configuration.blocking = false;
+
+    auto reader = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->open(configuration);
+
+    // The server answers only after a while.
+    const std::size_t would_block{http::BodyReader::would_block};
+    char chunk[4096];
+    EXPECT_EQ(would_block, reader->read(chunk, sizeof(chunk)));
+
+    std::string body;
+    std::size_t n{0};
+    while ((n = reader->read(chunk, sizeof(chunk))) != 0)
+    {
+        if (n == would_block)
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+        else
+            body.append(chunk, n);
+    }
+
+    json::Value root;
+    json::Reader json_reader;
+
+    EXPECT_TRUE(json_reader.parse(body, root));
+    EXPECT_EQ(url, root["url"].asString());
+    EXPECT_EQ(core::net::http::Status::ok, reader->response().status);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(StreamingHttpClient, closing_reader_aborts_transfer)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    std::thread worker{[client]() { client->run(); }};
+
+    auto url = std::string(httpbin::host) + httpbin::resources::slow_range();
+
+    http::BodyReader::Configuration configuration;
+    configuration.capacity = 4 * 1024;
+
+    auto reader = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->open(configuration);
+
+    char chunk[1024];
+    EXPECT_LT(0u, reader->read(chunk, sizeof(chunk)));
+
+    reader->close();
+
+    EXPECT_THROW(reader->response(), core::net::Error);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
+TEST(StreamingHttpClient, reader_takes_response_body_of_resumable_upload)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    std::thread worker{[client]() { client->run(); }};
+
+    auto url = std::string(httpbin::host) + httpbin::resources::put();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-upload-"};
+
+    auto path = directory.path + "/upload";
+    std::string payload(16 * 1024, 'x');
+    std::ofstream{path} << payload;
+
+    auto reader = client->resumable_put(http::Request::Configuration::from_uri_as_string(url), path, path + ".state")
+            ->open(http::BodyReader::Configuration{});
+
+    std::string body;
+    char chunk[4096];
+    std::size_t n{0};
+    while ((n = reader->read(chunk, sizeof(chunk))) != 0)
+        body.append(chunk, n);
+
+    json::Value root;
+    json::Reader json_reader;
+
+    EXPECT_TRUE(json_reader.parse(body, root));
+    EXPECT_EQ(payload, root["data"].asString());
+    EXPECT_EQ(core::net::http::Status::ok, reader->response().status);
+
+    // Requests assembling their body in a file cannot hand it out.
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/download";
+
+    auto download = client->segmented_get_to_file(http::Request::Configuration::from_uri_as_string(url), sink,
+                                                  http::StreamingClient::Segmentation::Configuration{});
+    EXPECT_THROW(download->open(), core::net::http::Error);
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+}
+
 TEST(StreamingHttpClient, del_request_for_existing_resource_succeeds)
 {
     using namespace ::testing;
 
     auto client = http::make_streaming_client();
-    auto url = std::string(httpbin::host) + httpbin::resources::del();
-  
-    auto request = client->streaming_del(http::Request::Configuration::from_uri_as_string(url));
-  
-    // Our mocked data handler.
-    auto dh = MockDataHandler::create(); EXPECT_CALL(*dh, on_new_data(_)).Times(AtLeast(1));
+    auto url = std::string(httpbin::host) + httpbin::resources::del();
+  
+    auto request = client->streaming_del(http::Request::Configuration::from_uri_as_string(url));
+  
+    // Our mocked data handler.
+    auto dh = MockDataHandler::create(); EXPECT_CALL(*dh, on_new_data(_)).Times(AtLeast(1));
+
+    auto response = request->execute(default_progress_reporter, dh->to_data_handler());
+
+    json::Value root;
+    json::Reader reader;
+  
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ(url, root["url"].asString());
+}
+
+TEST(StreamingHttpClient, get_request_to_file_writes_body_to_file)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+
+    auto url = std::string(httpbin::host) + httpbin::resources::range();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/range";
+    // Coalesce into a few writes, for the sake of testing.
+    sink.buffer_size = 16 * 1024;
+
+    auto request = client->streaming_get_to_file(http::Request::Configuration::from_uri_as_string(url), sink);
+
+    // The body goes to the file only.
+    auto dh = MockDataHandler::create(); EXPECT_CALL(*dh, on_new_data(_)).Times(0);
+
+    auto response = request->execute(default_progress_reporter, dh->to_data_handler());
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(response.body.empty());
+
+    std::ifstream in{sink.path};
+    std::stringstream ss; ss << in.rdbuf();
+
+    EXPECT_EQ(expected.body.size(), ss.str().size());
+    EXPECT_EQ(expected.body, ss.str());
+}
+
+TEST(StreamingHttpClient, get_request_to_file_leaves_file_untouched_for_unsuccessful_response)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/not_found";
+
+    auto url = std::string(httpbin::host) + httpbin::resources::not_found();
+    auto request = client->streaming_get_to_file(http::Request::Configuration::from_uri_as_string(url), sink);
+
+    auto response = request->execute(default_progress_reporter, [](const std::string&) {});
+
+    EXPECT_EQ(core::net::http::Status::not_found, response.status);
+    EXPECT_FALSE(std::ifstream{sink.path}.good());
+}
+
+TEST(StreamingHttpClient, segmented_get_request_to_file_writes_ranges_to_file)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+
+    auto url = std::string(httpbin::host) + httpbin::resources::range();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/range";
+
+    // Small segments, for the sake of testing.
+    http::StreamingClient::Segmentation::Configuration segmentation;
+    segmentation.segments = 4;
+    segmentation.min_segment_size = 8 * 1024;
+
+    auto request = client->segmented_get_to_file(http::Request::Configuration::from_uri_as_string(url), sink, segmentation);
+
+    double total{0.};
+    auto response = request->execute([&total](const http::Request::Progress& progress)
+    {
+        total = progress.download.total;
+        return http::Request::Progress::Next::continue_operation;
+    }, [](const std::string&) {});
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(response.body.empty());
+    EXPECT_EQ(expected.body.size(), total);
+
+    std::ifstream in{sink.path};
+    std::stringstream ss; ss << in.rdbuf();
+
+    EXPECT_EQ(expected.body.size(), ss.str().size());
+    EXPECT_EQ(expected.body, ss.str());
+}
+
+TEST(StreamingHttpClient, async_segmented_get_request_to_file_falls_back_to_single_transfer)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+
+    auto url = std::string(httpbin::host) + httpbin::resources::bytes();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    std::thread worker{[client]() { client->run(); }};
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/bytes";
+
+    http::StreamingClient::Segmentation::Configuration segmentation;
+    segmentation.min_segment_size = 8 * 1024;
+
+    // The server does not accept ranges, the body is downloaded in one go.
+    auto request = client->segmented_get_to_file(http::Request::Configuration::from_uri_as_string(url), sink, segmentation);
+
+    std::promise<core::net::http::Response> promise;
+    auto future = promise.get_future();
+
+    request->async_execute(http::Request::Handler()
+        .on_response([&](const core::net::http::Response& response)
+        {
+            promise.set_value(response);
+        })
+        .on_error([&](const core::net::Error& e)
+        {
+            promise.set_exception(std::make_exception_ptr(e));
+        }),
+        [](const std::string&) {});
+
+    try
+    {
+        EXPECT_EQ(core::net::http::Status::ok, future.get().status);
+    } catch (const std::exception& e) { FAIL() << e.what(); }
+
+    client->stop();
+
+    if (worker.joinable())
+        worker.join();
+
+    std::ifstream in{sink.path};
+    std::stringstream ss; ss << in.rdbuf();
+
+    EXPECT_EQ(expected.body, ss.str());
+}
+
+TEST(StreamingHttpClient, mirrored_get_request_to_file_drops_failing_mirror)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
 
-    auto response = request->execute(default_progress_reporter, dh->to_data_handler());
+    auto url = std::string(httpbin::host) + httpbin::resources::range();
+    // Nothing listens on port 1.
+    auto unreachable = std::string("http://127.0.0.1:1") + httpbin::resources::range();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/range";
+
+    http::StreamingClient::Segmentation::Configuration segmentation;
+    segmentation.segments = 4;
+    segmentation.min_segment_size = 8 * 1024;
+    segmentation.adaptive = false;
+
+    // The first mirror answers the probe, segments handed to the second one fail.
+    auto request = client->mirrored_get_to_file(http::Request::Configuration{}, {url, unreachable}, sink, segmentation);
+    auto response = request->execute(default_progress_reporter, [](const std::string&) {});
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+
+    std::ifstream in{sink.path};
+    std::stringstream ss; ss << in.rdbuf();
+
+    EXPECT_EQ(expected.body, ss.str());
+
+    auto metrics = client->metrics();
+    EXPECT_EQ(expected.body.size(), metrics.mirrors[url].bytes);
+    EXPECT_GT(metrics.mirrors[url].throughput, 0.);
+    EXPECT_EQ(0u, metrics.mirrors[url].drops);
+    EXPECT_EQ(0u, metrics.mirrors[unreachable].bytes);
+    EXPECT_LE(1u, metrics.mirrors[unreachable].failures);
+    EXPECT_EQ(1u, metrics.mirrors[unreachable].drops);
+}
+
+TEST(StreamingHttpClient, mirrored_get_request_to_file_drops_mirror_serving_another_representation)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+
+    auto url = std::string(httpbin::host) + httpbin::resources::range();
+    // Serves ranges just as well, of a longer resource with another entity tag.
+    auto other = std::string(httpbin::host) + "/range/204800";
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/range";
+
+    http::StreamingClient::Segmentation::Configuration segmentation;
+    segmentation.segments = 4;
+    segmentation.min_segment_size = 8 * 1024;
+    segmentation.adaptive = false;
+
+    auto request = client->mirrored_get_to_file(http::Request::Configuration{}, {url, other}, sink, segmentation);
+    auto response = request->execute(default_progress_reporter, [](const std::string&) {});
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+
+    std::ifstream in{sink.path};
+    std::stringstream ss; ss << in.rdbuf();
+
+    EXPECT_EQ(expected.body, ss.str());
+
+    auto metrics = client->metrics();
+    EXPECT_EQ(0u, metrics.mirrors[other].bytes);
+    EXPECT_EQ(1u, metrics.mirrors[other].drops);
+}
+
+TEST(StreamingHttpClient, mirrored_get_request_to_file_probes_next_mirror_if_first_is_unreachable)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+
+    auto url = std::string(httpbin::host) + httpbin::resources::range();
+    auto unreachable = std::string("http://127.0.0.1:1") + httpbin::resources::range();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/range";
+
+    http::StreamingClient::Segmentation::Configuration segmentation;
+    segmentation.min_segment_size = 8 * 1024;
+
+    auto request = client->mirrored_get_to_file(http::Request::Configuration{}, {unreachable, url}, sink, segmentation);
+    auto response = request->execute(default_progress_reporter, [](const std::string&) {});
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+
+    std::ifstream in{sink.path};
+    std::stringstream ss; ss << in.rdbuf();
+
+    EXPECT_EQ(expected.body, ss.str());
+    EXPECT_EQ(1u, client->metrics().mirrors[unreachable].drops);
+}
+
+TEST(StreamingHttpClient, resumable_get_request_to_file_resumes_interrupted_download)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+
+    auto url = std::string(httpbin::host) + httpbin::resources::slow_range();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/range";
+    sink.buffer_size = 4 * 1024;
+    sink.resumable = true;
+
+    // Interrupt the download midway.
+    auto interrupted = client->streaming_get_to_file(http::Request::Configuration::from_uri_as_string(url), sink);
+    EXPECT_ANY_THROW(interrupted->execute([](const http::Request::Progress& progress)
+    {
+        return progress.download.current >= 32 * 1024 ?
+                    http::Request::Progress::Next::abort_operation :
+                    http::Request::Progress::Next::continue_operation;
+    }, [](const std::string&) {}));
+
+    EXPECT_FALSE(std::ifstream{sink.path}.good());
+    EXPECT_TRUE(std::ifstream{sink.path + ".part"}.good());
+    EXPECT_TRUE(std::ifstream{sink.path + ".part.state"}.good());
+
+    // Only the remainder is transferred.
+    double total{0.};
+    auto resumed = client->streaming_get_to_file(http::Request::Configuration::from_uri_as_string(url), sink);
+    auto response = resumed->execute([&total](const http::Request::Progress& progress)
+    {
+        total = std::max(total, progress.download.total);
+        return http::Request::Progress::Next::continue_operation;
+    }, [](const std::string&) {});
+
+    EXPECT_EQ(core::net::http::Status::partial_content, response.status);
+    EXPECT_GT(total, 0.);
+    EXPECT_LT(total, expected.body.size());
+
+    std::ifstream in{sink.path};
+    std::stringstream ss; ss << in.rdbuf();
+
+    EXPECT_EQ(expected.body, ss.str());
+    EXPECT_FALSE(std::ifstream{sink.path + ".part"}.good());
+    EXPECT_FALSE(std::ifstream{sink.path + ".part.state"}.good());
+}
+
+TEST(StreamingHttpClient, resumable_get_request_to_file_starts_over_for_another_resource)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+
+    auto url = std::string(httpbin::host) + httpbin::resources::slow_range();
+    auto other_url = std::string(httpbin::host) + httpbin::resources::bytes();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(other_url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/download";
+    sink.buffer_size = 4 * 1024;
+    sink.resumable = true;
+
+    auto interrupted = client->streaming_get_to_file(http::Request::Configuration::from_uri_as_string(url), sink);
+    EXPECT_ANY_THROW(interrupted->execute([](const http::Request::Progress& progress)
+    {
+        return progress.download.current >= 32 * 1024 ?
+                    http::Request::Progress::Next::abort_operation :
+                    http::Request::Progress::Next::continue_operation;
+    }, [](const std::string&) {}));
+
+    // The partial body belongs to another resource and must not end up in the file.
+    auto request = client->streaming_get_to_file(http::Request::Configuration::from_uri_as_string(other_url), sink);
+    auto response = request->execute(default_progress_reporter, [](const std::string&) {});
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+
+    std::ifstream in{sink.path};
+    std::stringstream ss; ss << in.rdbuf();
+
+    EXPECT_EQ(expected.body, ss.str());
+}
+
+TEST(StreamingHttpClient, resumable_put_request_uploads_file_and_removes_state)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::put();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-upload-"};
+
+    auto path = directory.path + "/upload";
+    auto state = path + ".state";
+
+    std::string payload(64 * 1024, 'x');
+    std::ofstream{path} << payload;
+
+    // Interrupt the upload midway, leaving the state file behind.
+    auto interrupted = client->resumable_put(http::Request::Configuration::from_uri_as_string(url), path, state);
+    EXPECT_ANY_THROW(interrupted->execute([](const http::Request::Progress& progress)
+    {
+        return progress.upload.current > 0 ?
+                    http::Request::Progress::Next::abort_operation :
+                    http::Request::Progress::Next::continue_operation;
+    }, [](const std::string&) {}));
+
+    EXPECT_TRUE(std::ifstream{state}.good());
+
+    // The server never answered 308, its answer to the query does not complete the upload.
+    auto request = client->resumable_put(http::Request::Configuration::from_uri_as_string(url), path, state);
+    auto response = request->execute(default_progress_reporter, [](const std::string&) {});
 
     json::Value root;
     json::Reader reader;
-  
+
     EXPECT_EQ(core::net::http::Status::ok, response.status);
     EXPECT_TRUE(reader.parse(response.body, root));
-    EXPECT_EQ(url, root["url"].asString());
+    EXPECT_EQ(payload, root["data"].asString());
+    EXPECT_FALSE(std::ifstream{state}.good());
+}
+
+TEST(StreamingHttpClient, put_request_for_file_sends_mapped_or_read_contents)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::put();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-upload-"};
+
+    std::string payload;
+    for (int i = 0; i < 20000; i++)
+        payload += std::to_string(i) + ",";
+
+    http::StreamingClient::FileSource::Configuration source;
+    source.path = directory.path + "/upload";
+    std::ofstream{source.path} << payload;
+
+    for (bool map : {true, false})
+    {
+        source.map = map;
+        // A part of the file starting off a page boundary.
+        source.offset = 5000;
+        source.size = 60000;
+
+        auto response = client->streaming_put_file(http::Request::Configuration::from_uri_as_string(url), source)
+                ->execute(default_progress_reporter, [](const std::string&) {});
+
+        json::Value root;
+        json::Reader reader;
+
+        EXPECT_EQ(core::net::http::Status::ok, response.status);
+        EXPECT_TRUE(reader.parse(response.body, root));
+        EXPECT_EQ(payload.substr(5000, 60000), root["data"].asString());
+    }
+
+    source.path = directory.path + "/missing";
+    EXPECT_THROW(client->streaming_put_file(http::Request::Configuration::from_uri_as_string(url), source), std::system_error);
+}
+
+TEST(StreamingHttpClient, post_request_for_file_sends_contents_with_type)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::post();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-upload-"};
+
+    std::string payload{"{\"file\": \"contents\"}"};
+
+    http::StreamingClient::FileSource::Configuration source;
+    source.path = directory.path + "/upload.json";
+    std::ofstream{source.path} << payload;
+
+    std::string type{http::ContentType::json};
+
+    auto response = client->streaming_post_file(http::Request::Configuration::from_uri_as_string(url), source, type)
+            ->execute(default_progress_reporter, [](const std::string&) {});
+
+    json::Value root;
+    json::Reader reader;
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ(payload, root["data"].asString());
+    EXPECT_EQ(type, root["headers"]["Content-Type"].asString());
+}
+
+TEST(StreamingHttpClient, post_form_request_escapes_fields_while_sending)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::post();
+
+    std::map<std::string, std::string> values
+    {
+        {"a b", "x&y=z"},
+        {"empty", ""},
+        {"plain", "~value-1._"}
+    };
+
+    auto response = client->streaming_post_form(http::Request::Configuration::from_uri_as_string(url), values)
+            ->execute(default_progress_reporter, [](const std::string&) {});
+
+    json::Value root;
+    json::Reader reader;
+
+    std::string expected{"a%20b=x%26y%3Dz&empty=&plain=~value-1._"};
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ(expected, root["data"].asString());
+    EXPECT_EQ(std::to_string(expected.size()), root["headers"]["Content-Length"].asString());
+    EXPECT_EQ("x&y=z", root["form"]["a b"].asString());
+    EXPECT_EQ("~value-1._", root["form"]["plain"].asString());
+}
+
+TEST(StreamingHttpClient, post_multipart_request_sends_fields_and_files)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::post();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-upload-"};
+
+    std::string payload;
+    for (int i = 0; i < 20000; i++)
+        payload += std::to_string(i) + ",";
+
+    http::StreamingClient::FileSource::Configuration source;
+    source.path = directory.path + "/upload.txt";
+    std::ofstream{source.path} << payload;
+
+    http::StreamingClient::Multipart::Parts parts
+    {
+        http::StreamingClient::Multipart::Part::field("title", "A \"quoted\" title"),
+        http::StreamingClient::Multipart::Part::file("upload", source, "upload.txt", "text/plain")
+    };
+
+    auto response = client->streaming_post_multipart(http::Request::Configuration::from_uri_as_string(url), parts)
+            ->execute(default_progress_reporter, [](const std::string&) {});
+
+    json::Value root;
+    json::Reader reader;
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(reader.parse(response.body, root));
+    EXPECT_EQ("A \"quoted\" title", root["form"]["title"].asString());
+    EXPECT_EQ(payload, root["files"]["upload"].asString());
+    EXPECT_EQ(0u, root["headers"]["Content-Type"].asString().find("multipart/form-data; boundary="));
+
+    source.path = directory.path + "/missing";
+    parts.back().source = source;
+    EXPECT_THROW(client->streaming_post_multipart(http::Request::Configuration::from_uri_as_string(url), parts), std::system_error);
+}
+
+TEST(StreamingHttpClient, put_request_for_file_is_sent_again_after_redirect)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::redirect_to_put();
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-upload-"};
+
+    std::string payload;
+    for (int i = 0; i < 20000; i++)
+        payload += std::to_string(i) + ",";
+
+    http::StreamingClient::FileSource::Configuration source;
+    source.path = directory.path + "/upload";
+    std::ofstream{source.path} << payload;
+
+    auto configuration = http::Request::Configuration::from_uri_as_string(url);
+    configuration.max_redirects = 1;
+
+    for (bool map : {true, false})
+    {
+        source.map = map;
+
+        auto response = client->streaming_put_file(configuration, source)
+                ->execute(default_progress_reporter, [](const std::string&) {});
+
+        json::Value root;
+        json::Reader reader;
+
+        EXPECT_EQ(core::net::http::Status::ok, response.status);
+        EXPECT_TRUE(reader.parse(response.body, root));
+        EXPECT_EQ(payload, root["data"].asString());
+    }
+}
+
+TEST(StreamingHttpClient, put_request_with_seeker_is_sent_again_after_redirect)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+    auto url = std::string(httpbin::host) + httpbin::resources::redirect_to_put();
+
+    std::string payload(100 * 1024, 'x');
+
+    auto configuration = http::Request::Configuration::from_uri_as_string(url);
+    configuration.max_redirects = 1;
+
+    std::size_t position{0};
+    auto reader = [&payload, &position](void* dest, std::size_t size)
+    {
+        auto n = std::min(size, payload.size() - position);
+        std::memcpy(dest, payload.data() + position, n);
+        position += n;
+        return n;
+    };
+
+    unsigned int rewinds{0};
+    auto seeker = [&position, &rewinds](std::uint64_t offset)
+    {
+        position = offset;
+        rewinds++;
+        return true;
+    };
+
+    auto response = client->streaming_put(configuration, reader, seeker, payload.size())
+            ->execute(default_progress_reporter, [](const std::string&) {});
+
+    json::Value root;
+    json::Reader json_reader;
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_TRUE(json_reader.parse(response.body, root));
+    EXPECT_EQ(payload, root["data"].asString());
+    EXPECT_LE(1u, rewinds);
+
+    // Bodies that cannot be rewound fail the request instead of being sent incomplete.
+    position = 0;
+    EXPECT_ANY_THROW(client->streaming_put(configuration, reader, payload.size())
+                     ->execute(default_progress_reporter, [](const std::string&) {}));
+}
+
+TEST(StreamingHttpClient, delta_get_request_to_file_fetches_only_missing_blocks)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+
+    auto url = std::string(httpbin::host) + httpbin::resources::range();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::Request::Configuration configuration;
+    http::StreamingClient::Delta::Configuration delta;
+    delta.manifest = directory.path + "/range.zsync";
+    delta.seed = directory.path + "/seed";
+
+    {
+        std::stringstream in{expected.body};
+        std::ofstream out{delta.manifest};
+        http::StreamingClient::Delta::write_manifest(in, out, url, 2048);
+    }
+
+    // An older version of the resource: shifted by an inserted prefix, with a changed region.
+    auto seed = std::string(1000, 'p') + expected.body;
+    std::fill(seed.begin() + 40000, seed.begin() + 45000, 'c');
+    std::ofstream{delta.seed} << seed;
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/range";
+
+    std::uint64_t fetched{0};
+    auto request = client->delta_get_to_file(configuration, sink, delta);
+    auto response = request->execute([&fetched](const http::Request::Progress& progress)
+    {
+        fetched = progress.download.total;
+        return http::Request::Progress::Next::continue_operation;
+    }, [](const std::string&) {});
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+    EXPECT_LT(0u, fetched);
+    EXPECT_GT(expected.body.size() / 4, fetched);
+
+    std::ifstream in{sink.path};
+    std::stringstream ss; ss << in.rdbuf();
+
+    EXPECT_EQ(expected.body, ss.str());
+}
+
+TEST(StreamingHttpClient, delta_get_request_to_file_fetches_everything_without_seed)
+{
+    using namespace ::testing;
+
+    auto client = http::make_streaming_client();
+
+    auto url = std::string(httpbin::host) + httpbin::resources::range();
+    auto expected = client->streaming_get(http::Request::Configuration::from_uri_as_string(url))->execute(default_progress_reporter, [](const std::string&) {});
+
+    testing::TemporaryDirectory directory{"/tmp/net-cpp-download-"};
+
+    http::StreamingClient::Delta::Configuration delta;
+    delta.manifest = directory.path + "/range.zsync";
+    delta.seed = directory.path + "/missing";
+    delta.max_request_size = 16 * 1024;
+
+    {
+        std::stringstream in{expected.body};
+        std::ofstream out{delta.manifest};
+        http::StreamingClient::Delta::write_manifest(in, out, url, 4096);
+    }
+
+    http::StreamingClient::FileSink::Configuration sink;
+    sink.path = directory.path + "/range";
+
+    auto request = client->delta_get_to_file(http::Request::Configuration{}, sink, delta);
+    auto response = request->execute(default_progress_reporter, [](const std::string&) {});
+
+    EXPECT_EQ(core::net::http::Status::ok, response.status);
+
+    std::ifstream in{sink.path};
+    std::stringstream ss; ss << in.rdbuf();
+
+    EXPECT_EQ(expected.body, ss.str());
+
+    std::ofstream{delta.manifest} << "zsync: 0.6.2\nBlocksize: 1000\n\n";
+    EXPECT_THROW(client->delta_get_to_file(http::Request::Configuration{}, sink, delta), std::runtime_error);
 }
 
 TEST(StreamingHttpClient, request_can_be_paused_and_resumed)
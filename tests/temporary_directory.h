@@ -0,0 +1,59 @@
+/*
+ * Copyright © 2026 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEMPORARY_DIRECTORY_H
+#define TEMPORARY_DIRECTORY_H
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <system_error>
+
+#include <ftw.h>
+
+namespace testing
+{
+// Creates a directory from the mkdtemp template prefix + "XXXXXX", removing it with all its contents at scope exit.
+struct TemporaryDirectory
+{
+    explicit TemporaryDirectory(const std::string& prefix)
+        : path(prefix + "XXXXXX")
+    {
+        if (::mkdtemp(&path[0]) == nullptr)
+            throw std::system_error{errno, std::system_category(), "Could not create " + path};
+    }
+
+    ~TemporaryDirectory()
+    {
+        ::nftw(path.c_str(), remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    TemporaryDirectory(const TemporaryDirectory&) = delete;
+    TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+    std::string path;
+
+private:
+    // Removes a file or an empty directory, for nftw.
+    static int remove_entry(const char* path, const struct stat*, int, struct FTW*)
+    {
+        return ::remove(path);
+    }
+};
+}
+
+#endif // TEMPORARY_DIRECTORY_H